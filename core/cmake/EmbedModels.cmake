@@ -0,0 +1,57 @@
+# Generates a C++ source that embeds .tflite models as aligned, read-only
+# byte arrays. Run in script mode:
+#   cmake -DMODELS="a.tflite|b.tflite" -DOUTPUT=EmbeddedModelData.cpp -P EmbedModels.cmake
+# Each model is registered under its file name without extension, e.g.
+# models/face_landmark.tflite -> "embedded:face_landmark".
+
+string(REPLACE "|" ";" MODELS "${MODELS}")
+
+# CMake regexes have no {n} quantifier; spell out 32 bytes per line.
+set(LINE_PATTERN "")
+foreach(I RANGE 1 32)
+    string(APPEND LINE_PATTERN "0x[0-9a-f][0-9a-f],")
+endforeach()
+
+set(DATA "")
+set(TABLE "")
+set(COUNT 0)
+
+foreach(MODEL ${MODELS})
+    get_filename_component(STEM ${MODEL} NAME_WE)
+    string(MAKE_C_IDENTIFIER ${STEM} IDENT)
+
+    file(READ ${MODEL} HEX HEX)
+    string(LENGTH "${HEX}" HEX_LENGTH)
+    if(HEX_LENGTH EQUAL 0)
+        message(WARNING "Skipping empty model ${MODEL}")
+        continue()
+    endif()
+
+    # 0x.. per byte, 32 bytes per line
+    string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," BYTES "${HEX}")
+    string(REGEX REPLACE "(${LINE_PATTERN})" "\\1\n    " BYTES "${BYTES}")
+
+    string(APPEND DATA "alignas(64) static const unsigned char kModel_${IDENT}[] = {\n    ${BYTES}\n};\n\n")
+    string(APPEND TABLE "    {\"${STEM}\", kModel_${IDENT}, sizeof(kModel_${IDENT})},\n")
+    math(EXPR COUNT "${COUNT} + 1")
+endforeach()
+
+if(COUNT EQUAL 0)
+    set(TABLE "    {nullptr, nullptr, 0},\n")
+endif()
+
+file(WRITE ${OUTPUT}
+"// Generated by core/cmake/EmbedModels.cmake. Do not edit.
+
+#include \"neptune/EmbeddedModels.h\"
+
+namespace neptune {
+namespace detail {
+
+${DATA}const EmbeddedModel kEmbeddedModels[] = {
+${TABLE}};
+const size_t kEmbeddedModelCount = ${COUNT};
+
+} // namespace detail
+} // namespace neptune
+")
@@ -0,0 +1,99 @@
+//
+// File: NeptuneFacialSDK/core/include/neptune/DetectionDecoder.h
+//
+// Decoder for MediaPipe-style SSD face detector outputs (per-anchor box and
+// keypoint regressions plus a score logit). Anchors are generated once, in a
+// structure-of-arrays layout; scores are thresholded as raw logits (or
+// quantized values) so only the surviving anchors are decoded. The anchor
+// layout and box coding come from a DetectorSpec, one per model variant.
+//
+
+#pragma once
+
+#include "TensorView.h"
+
+#include <opencv2/core.hpp>
+
+#include <vector>
+
+namespace neptune {
+
+// One decoded candidate, in pixel coordinates of the original image.
+struct FaceDetection {
+    static constexpr int kKeypoints = 6;
+
+    float score = 0.0f;                   // sigmoid of the logit
+    int x1 = 0, y1 = 0, x2 = 0, y2 = 0;   // clamped to the image
+    float keypoints[kKeypoints * 2] = {}; // (x, y) pairs, clamped to the image
+
+    int width() const { return x2 - x1; }
+    int height() const { return y2 - y1; }
+};
+
+// Anchor layout and box coding of one detector model, mirroring MediaPipe's
+// SsdAnchorsCalculator and TensorsToDetectionsCalculator options (square
+// aspect ratio only). Regressions are (x, y, w, h, keypoints...) divided by
+// boxScale, relative to the anchor center and size.
+struct DetectorSpec {
+    int inputWidth = 128;
+    int inputHeight = 128;
+    std::vector<int> strides = {8, 16, 16, 16};   // one entry per anchor layer
+    float minScale = 0.1484375f;
+    float maxScale = 0.75f;
+    float anchorOffsetX = 0.5f;
+    float anchorOffsetY = 0.5f;
+    bool interpolatedScale = true;   // second anchor per layer at sqrt(scale * next scale)
+    bool fixedAnchorSize = true;     // anchors are 1x1, the regression carries the size
+    float boxScale = 128.0f;
+
+    // face_detection_short_range.tflite: 128x128, 896 anchors.
+    static DetectorSpec shortRange();
+
+    // face_detection_full_range.tflite: 192x192, 2304 anchors.
+    static DetectorSpec fullRange();
+
+    // Spec matching a model's input size; false if none is known.
+    static bool forInputSize(int width, int height, DetectorSpec& spec);
+
+    // Anchors the spec generates.
+    size_t anchorCount() const;
+};
+
+// Overlapping square tiles covering an imageSize frame, row by row. A
+// positive tileSize fixes the tile side; otherwise the grid of at most
+// maxTiles tiles with the smallest side is used, never below minTileSize.
+// Empty when a single tile would cover the frame.
+std::vector<cv::Rect> detectionTiles(const cv::Size& imageSize, int tileSize, float overlap, int maxTiles,
+                                     int minTileSize);
+
+class DetectionDecoder {
+public:
+    DetectionDecoder() = default;
+
+    // Anchors for `spec`, generated once. Scores below minConfidence are
+    // rejected.
+    DetectionDecoder(const DetectorSpec& spec, float minConfidence);
+
+    const DetectorSpec& spec() const { return spec_; }
+
+    size_t anchorCount() const { return xCenter_.size(); }
+
+    // Appends every candidate scoring at least minConfidence to `out`, for
+    // an imageSize image letterboxed into the model input. `boxes` holds
+    // 16 values per anchor (box regression, then 6 keypoints); `scores`
+    // one logit per anchor. Allocation-free once `out` has grown.
+    void decode(const OutputTensorView& boxes, const OutputTensorView& scores, const cv::Size& imageSize,
+                std::vector<FaceDetection>& out) const;
+
+private:
+    // Anchors, one array per field (normalized coordinates).
+    std::vector<float> xCenter_;
+    std::vector<float> yCenter_;
+    std::vector<float> width_;
+    std::vector<float> height_;
+
+    DetectorSpec spec_;
+    float minLogit_ = 0.0f;   // logit(minConfidence)
+};
+
+} // namespace neptune
@@ -0,0 +1,46 @@
+//
+// File: NeptuneFacialSDK/core/include/neptune/EmbeddedModels.h
+//
+// Models compiled into neptune_core (CMake option NEPTUNE_EMBED_MODELS).
+// Any model path in NeptuneConfig, or passed to a component, may name one
+// as "embedded:<name>", where <name> is the model's file name without
+// extension (e.g. "embedded:face_landmark"). Embedded models are loaded
+// straight from the library's read-only data: no file I/O and no copy.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace neptune {
+
+constexpr const char* kEmbeddedModelPrefix = "embedded:";
+
+struct EmbeddedModel {
+    const char* name;
+    const unsigned char* data;   // 64-byte aligned, valid for the process lifetime
+    size_t size;
+};
+
+// True if `path` uses the "embedded:" scheme.
+bool isEmbeddedModelPath(const std::string& path);
+
+// Looks up an embedded model by bare name or "embedded:<name>" path.
+// Returns nullptr if no such model was compiled in.
+const EmbeddedModel* findEmbeddedModel(const std::string& nameOrPath);
+
+// Names of all embedded models (empty when built without NEPTUNE_EMBED_MODELS).
+std::vector<std::string> embeddedModelNames();
+
+// "embedded:<name>" if that model is compiled in, otherwise `fallbackPath`.
+std::string embeddedOrPath(const std::string& name, const std::string& fallbackPath);
+
+namespace detail {
+// Defined by the generated EmbeddedModelData.cpp, or empty in EmbeddedModels.cpp.
+extern const EmbeddedModel kEmbeddedModels[];
+extern const size_t kEmbeddedModelCount;
+} // namespace detail
+
+} // namespace neptune
@@ -2,7 +2,9 @@
 #pragma once
 
 #include "TfLiteEngine.h"
+#include "InterpreterPool.h"
 #include "Preprocess.h"
+#include "YuvFrame.h"
 #include "Types.h"
 #include "Log.h"
 
@@ -16,6 +18,9 @@ namespace neptune {
 /**
  * @class EmotionRecognizer
  * @brief Handles emotion recognition using a pre-trained TensorFlow Lite model.
+ *
+ * The predict methods may be called from several threads; each call leases
+ * its own interpreter from the recognizer's pool.
  */
 class EmotionRecognizer {
 public:
@@ -29,18 +34,67 @@ public:
      */
     EmotionResult predictEmotion(const cv::Mat& faceImage);
 
+    /**
+     * @brief Performs emotion recognition on several faces of one image in a single invoke.
+     * @param image The full BGR image.
+     * @param faceRects Face rectangles in image coordinates (clamped to the image).
+     * @return One EmotionResult per rectangle, in the same order. Falls back to
+     *         per-face inference if the model cannot be batched.
+     */
+    std::vector<EmotionResult> predictEmotions(const cv::Mat& image,
+                                               const std::vector<cv::Rect>& faceRects);
+
+    /**
+     * @brief Same, on a YUV camera frame. Face crops are color-converted
+     *        while they are resized, never the whole frame.
+     */
+    std::vector<EmotionResult> predictEmotions(const YuvFrame& frame,
+                                               const std::vector<cv::Rect>& faceRects);
+
+    /**
+     * @brief Batched recognition on detected faces. Each crop is scaled by
+     *        NeptuneConfig::emotionRoiScale and, with alignFaceCrops, rotated
+     *        so the face's eye keypoints are level.
+     */
+    std::vector<EmotionResult> predictEmotions(const cv::Mat& image, const std::vector<FaceBox>& faces);
+    std::vector<EmotionResult> predictEmotions(const YuvFrame& frame, const std::vector<FaceBox>& faces);
+
+    // Backend the emotion model ended up running on.
+    InferenceBackend backend() const { return pool_ ? pool_->backend() : InferenceBackend::BUILTIN; }
+
+    // Load/allocate/warm-up timings of the emotion model.
+    ModelStartupTiming startupTiming() const { return pool_ ? pool_->startupTiming() : ModelStartupTiming(); }
+
 private:
     EmotionRecognizer(const NeptuneConfig& config);
     bool init(const std::string& modelPath);
 
-    // Helpers
-    static std::vector<float> softmax(const std::vector<float>& logits);
+    // Crop ROIs; an empty NormalizedRect marks a face that is skipped
+    static std::vector<NormalizedRect> rectRois(const std::vector<cv::Rect>& faceRects, const cv::Size& imageSize);
+    std::vector<NormalizedRect> faceRois(const std::vector<FaceBox>& faces, const cv::Size& imageSize) const;
+
+    // Helpers; Image is cv::Mat (BGR) or YuvFrame
+    template <typename Image>
+    std::vector<EmotionResult> predictBatch(const Image& image, const std::vector<NormalizedRect>& rois);
+    template <typename Image>
+    EmotionResult predictWith(TfLiteEngine& engine, const Image& image, const NormalizedRect& roi) const;
+    template <typename Image>
+    bool preprocessInto(const Image& image, const NormalizedRect& roi, const InputTensorView& input) const;
+    EmotionResult decode(const OutputTensorView& logits) const;
+    // Writes softmax(logits) into out (resized to logits.size). Quantized
+    // logits are dequantized as they are read.
+    static void softmax(const OutputTensorView& logits, std::vector<float>& out);
     static Emotion indexToEmotion(int idx); // dataset label → enum
 
-    std::unique_ptr<neptune::TfLiteEngine> engine_;
+    std::unique_ptr<InterpreterPool> pool_;
+    EngineOptions engineOptions_;
+    int poolSize_;
+    PoolAcquirePolicy poolPolicy_;
     int inputWidth_;
     int inputHeight_;
     float minConfidence_;
+    float roiScale_;
+    bool alignCrops_;
     int numClasses_ = -1; // inferred dynamically
 };
 
@@ -1,8 +1,13 @@
 
 #pragma once
 
+#include "neptune/DetectionDecoder.h"
 #include "neptune/TfLiteEngine.h"
+#include "neptune/InterpreterPool.h"
+#include "neptune/NonMaxSuppression.h"
+#include "neptune/WorkerPool.h"
 #include "Preprocess.h"
+#include "YuvFrame.h"
 #include "Types.h"
 #include "Log.h"
 
@@ -14,7 +19,13 @@
 namespace neptune {
 
 /**
- * FaceDetector - detects faces using a TFLite model (supports MediaPipe 2-output SSD-style models).
+ * FaceDetector - detects faces using a TFLite model (supports MediaPipe 2-output SSD-style models,
+ * short and full range). detectFaces() may be called from several threads; each call leases its own
+ * interpreter. With NeptuneConfig::tiledDetection, large frames are also split into overlapping tiles
+ * that run in parallel, so small faces keep enough pixels at the model's input size. The tiles run on
+ * the calling thread plus detectionThreads - 1 workers owned by the detector; with more than one
+ * detection thread the detector's interpreters are pinned to a single intra-op thread
+ * (NeptuneConfig::numThreads does not apply to them).
  */
 class FaceDetector {
 public:
@@ -24,49 +35,78 @@ public:
     // Perform detection on an OpenCV Mat (BGR). Returns FaceBox in original image coordinates.
     std::vector<FaceBox> detectFaces(const cv::Mat& image);
 
+    // Same, on a YUV camera frame; only the pixels sampled for the model input are converted.
+    std::vector<FaceBox> detectFaces(const YuvFrame& frame);
+
+    // Backend the detection model ended up running on.
+    InferenceBackend backend() const { return pool_ ? pool_->backend() : InferenceBackend::BUILTIN; }
+
+    // Load/allocate/warm-up timings of the detection model.
+    ModelStartupTiming startupTiming() const { return pool_ ? pool_->startupTiming() : ModelStartupTiming(); }
+
 private:
     FaceDetector(const NeptuneConfig& config);
     bool init(const std::string& modelPath);
 
+    // detectFaces() for either image type.
+    template <typename Image>
+    std::vector<FaceBox> detect(const Image& image);
+
+    // Runs the model on `region` of the image and appends its candidates, in image coordinates,
+    // to `out`. With `dropCut`, candidates touching a region edge inside the image are skipped;
+    // a neighbouring tile or the full-frame pass sees those faces whole.
+    template <typename Image>
+    bool detectRegion(TfLiteEngine& engine, const Image& image, const cv::Rect& region, bool dropCut,
+                      std::vector<FaceDetection>& out) const;
+
+    // Full-frame pass plus every tile, spread over the calling thread (on `engine`) and up to
+    // detectionThreads_ - 1 helper tasks on workers_, each leasing its own interpreter when one is free.
+    template <typename Image>
+    void detectTiled(TfLiteEngine& engine, const Image& image, const std::vector<cv::Rect>& tiles,
+                     std::vector<FaceDetection>& out) const;
+
+    // NMS over the candidates of a frame (all tiles together); appends at most maxFaces FaceBoxes.
+    void suppress(const std::vector<FaceDetection>& candidates, std::vector<FaceBox>& out) const;
+
     // Legacy parsers (kept for compatibility)
     void parseMediaPipeFormat(const std::vector<float>& output, const cv::Mat& image, std::vector<FaceBox>& results);
-    void parseSSDFormat(const cv::Mat& image, std::vector<FaceBox>& results);
+    void parseSSDFormat(const cv::Size& imageSize, std::vector<FaceBox>& results);
     void parsePackedFormat(const std::vector<float>& output, const cv::Mat& image, std::vector<FaceBox>& results);
-    void parseUnknownFormat(const std::vector<float>& output, const cv::Mat& image, std::vector<FaceBox>& results);
-
-    // MediaPipe 2-output parser (boxes+keypoints, scores)
-    void parseMediaPipe2OutputFormat(const std::vector<float>& boxes_and_keypoints,
-                                     const std::vector<float>& scores,
-                                     const cv::Mat& image,
-                                     std::vector<FaceBox>& results);
-
-    // Anchor type used for decoding SSD outputs (normalized coordinates)
-    struct Anchor {
-        float x_center; // normalized [0..1]
-        float y_center; // normalized [0..1]
-        float w;        // normalized [0..1]
-        float h;        // normalized [0..1]
-    };
-
-    // Generate anchors used by MediaPipe face detectors
-    std::vector<Anchor> generateAnchors(int input_width,
-                                        int input_height,
-                                        const std::vector<int>& strides,
-                                        float min_scale,
-                                        float max_scale,
-                                        float anchor_offset_x = 0.5f,
-                                        float anchor_offset_y = 0.5f);
-
-    // The TensorFlow Lite engine used for running the face detection model.
-    std::unique_ptr<neptune::TfLiteEngine> engine_;
+    void parseUnknownFormat(const OutputTensorView& output, const cv::Size& imageSize, std::vector<FaceBox>& results);
+
+    // MediaPipe 2-output parser (boxes+keypoints, scores), reading the output tensors in place.
+    // Only anchors above the score threshold are decoded, in coordinates of a regionSize input.
+    void parseMediaPipe2OutputFormat(const OutputTensorView& boxes_and_keypoints,
+                                     const OutputTensorView& scores,
+                                     const cv::Size& regionSize,
+                                     std::vector<FaceDetection>& decoded) const;
+
+    // Interpreters for the face detection model (one shared model, one interpreter per concurrent call).
+    std::unique_ptr<InterpreterPool> pool_;
+    EngineOptions engineOptions_;
+    int poolSize_;
+    PoolAcquirePolicy poolPolicy_;
 
     // Input tensor dims & thresholds
     int inputWidth_;
     int inputHeight_;
+    int numOutputs_;
     float minConfidence_;
 
-    // Cached anchors for the active model (filled at init or on-demand).
-    std::vector<Anchor> anchors_;
+    // Tiled detection
+    bool tiledDetection_;
+    int tileSize_;
+    float tileOverlap_;
+    int detectionThreads_;
+
+    // Persistent helper threads for the tiles; declared after pool_ so they stop first.
+    std::unique_ptr<WorkerPool> workers_;
+
+    // Candidate merging; maxDetections is NeptuneConfig::maxFaces
+    NmsOptions nmsOptions_;
+
+    // Anchors and thresholds for the active model, built once at init (read-only afterwards).
+    DetectionDecoder decoder_;
 };
 
 } // namespace neptune
@@ -0,0 +1,84 @@
+//
+// File: NeptuneFacialSDK/core/include/neptune/FaceTracker.h
+//
+// Multi-object tracking of detected faces, so per-person state can follow a
+// face across frames: each track predicts its box with a constant-velocity
+// Kalman filter, detections are matched to the predictions greedily by a
+// cost mixing IoU and center distance (only pairs within a gate, found
+// through detections sorted by x), and tracks are reported only after a few
+// consecutive matches and dropped after a few misses.
+//
+
+#pragma once
+
+#include "Types.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace neptune {
+
+/**
+ * FaceTracker - assigns FaceBox::trackId. Holds per-stream state: use one
+ * instance per video stream, called from one thread at a time. Storage is
+ * preallocated for maxTracks; update() only allocates on a frame with more
+ * faces or gated pairs than that storage has seen.
+ */
+class FaceTracker {
+public:
+    explicit FaceTracker(const NeptuneConfig& config = NeptuneConfig());
+
+    // Matches the faces of the next frame to the tracks and sets their
+    // trackId. Faces of tentative tracks (not yet trackConfirmFrames
+    // matches), or left over once maxTracks are live, keep trackId -1.
+    void update(std::vector<FaceBox>& faces);
+
+    // Drops every track; ids keep increasing.
+    void reset();
+
+    // Live tracks, tentative ones included.
+    size_t trackCount() const { return tracks_.size(); }
+
+private:
+    // One coordinate and its velocity; the covariance is the 2x2 [p00 p01; p01 p11].
+    struct Axis {
+        float x, v;
+        float p00, p01, p11;
+
+        void init(float z, float r);
+        void predict(float q);
+        void correct(float z, float r);
+    };
+
+    struct Track {
+        int id;            // -1 while tentative
+        int hits;          // consecutive matched frames
+        int misses;        // consecutive unmatched frames
+        Axis cx, cy, w, h; // box center and size
+    };
+
+    // Candidate (track, face) pair that passed the gate.
+    struct Match {
+        float cost;
+        int track;
+        int face;
+    };
+
+    void startTrack(const FaceBox& face);
+
+    int confirmFrames_;
+    int maxMissed_;
+    float minIou_;
+    float maxCenterDistance_;
+    size_t maxTracks_;
+    int nextId_ = 0;
+
+    std::vector<Track> tracks_;
+    std::vector<std::pair<float, int>> facesByX_;   // (center x, face index), sorted
+    std::vector<Match> matches_;
+    std::vector<uint8_t> trackMatched_;
+    std::vector<uint8_t> faceMatched_;
+};
+
+} // namespace neptune
@@ -0,0 +1,119 @@
+//
+// File: NeptuneFacialSDK/core/include/neptune/InterpreterPool.h
+//
+// A bounded pool of TfLiteEngine instances that all run the same model.
+// The FlatBufferModel comes from the ModelRegistry and is shared read-only; every
+// engine owns its own interpreter and tensors, so leases can be used from
+// different threads at the same time.
+//
+
+#pragma once
+
+#include "TfLiteEngine.h"
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace neptune {
+
+// What acquire() does when every interpreter is leased and the pool is full.
+enum class PoolAcquirePolicy {
+    BLOCK = 0,  // wait for a lease to be returned
+    TRY = 1     // return an empty lease immediately
+};
+
+class InterpreterPool {
+public:
+    /**
+     * @class Lease
+     * @brief RAII handle to one pooled engine; returns it to the pool on destruction.
+     */
+    class Lease {
+    public:
+        Lease() = default;
+        Lease(Lease&& other) noexcept;
+        Lease& operator=(Lease&& other) noexcept;
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        ~Lease();
+
+        explicit operator bool() const { return engine_ != nullptr; }
+        TfLiteEngine& operator*() const { return *engine_; }
+        TfLiteEngine* operator->() const { return engine_; }
+
+    private:
+        friend class InterpreterPool;
+        Lease(InterpreterPool* pool, TfLiteEngine* engine) : pool_(pool), engine_(engine) {}
+        void release();
+
+        InterpreterPool* pool_ = nullptr;
+        TfLiteEngine* engine_ = nullptr;
+    };
+
+    /**
+     * @brief Loads the model once and builds the first interpreter.
+     * @param modelPath Path of the .tflite model, or "embedded:<name>".
+     * @param options Backend options applied to every interpreter.
+     * @param maxSize Upper bound on interpreters (clamped to >= 1). Extra
+     *        interpreters are built lazily, only when leases overlap.
+     * @param policy Behaviour of acquire() when the pool is exhausted.
+     * @return The pool, or nullptr if the model cannot be loaded.
+     */
+    static std::unique_ptr<InterpreterPool> create(const std::string& modelPath,
+                                                   const EngineOptions& options,
+                                                   int maxSize = 1,
+                                                   PoolAcquirePolicy policy = PoolAcquirePolicy::BLOCK);
+
+    ~InterpreterPool();
+
+    // Lease an engine according to the pool's policy.
+    Lease acquire();
+    // Lease an engine without ever waiting; empty lease if none is available.
+    Lease tryAcquire();
+
+    int size() const;                  // interpreters built so far
+    int capacity() const { return maxSize_; }
+
+    // Properties of the first engine; identical for every pooled engine.
+    int inputWidth() const { return inputWidth_; }
+    int inputHeight() const { return inputHeight_; }
+    InferenceBackend backend() const { return backend_; }
+    const std::string& modelPath() const { return modelPath_; }
+
+    // Load time of the shared model plus allocate/warm-up time of the first engine.
+    const ModelStartupTiming& startupTiming() const { return startupTiming_; }
+
+private:
+    InterpreterPool(const std::string& modelPath, const EngineOptions& options,
+                    int maxSize, PoolAcquirePolicy policy);
+
+    Lease acquireImpl(bool wait);
+    // Builds a new engine on the shared model; called without mutex_ held.
+    // Only the first engine (built by create()) runs the warm-up invoke.
+    std::unique_ptr<TfLiteEngine> buildEngine(bool first);
+    void giveBack(TfLiteEngine* engine);
+
+    std::string modelPath_;
+    EngineOptions options_;
+    int maxSize_;
+    PoolAcquirePolicy policy_;
+
+    SharedModel model_;
+    std::vector<std::unique_ptr<TfLiteEngine>> engines_; // every engine built
+    std::vector<TfLiteEngine*> idle_;                     // engines not leased
+    int building_ = 0;                                    // engines being built
+    bool growthFailed_ = false;                           // stop growing after a failed build
+
+    int inputWidth_ = 0;
+    int inputHeight_ = 0;
+    InferenceBackend backend_ = InferenceBackend::BUILTIN;
+    ModelStartupTiming startupTiming_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable available_;
+};
+
+} // namespace neptune
@@ -0,0 +1,69 @@
+//
+// File: NeptuneFacialSDK/core/include/neptune/LandmarkTracker.h
+//
+// Detect-once-then-track for video, as in MediaPipe's face mesh graphs: each
+// face's crop for the next frame comes from its current landmarks, and the
+// face detector runs only when a face is lost (the landmark model's face
+// presence drops), when nothing is tracked, or every redetectIntervalFrames
+// to pick up new faces.
+//
+
+#pragma once
+
+#include "FaceDetector.h"
+#include "Types.h"
+#include "YuvFrame.h"
+#include "landmark_extractor.h"
+
+#include <cstdint>
+#include <vector>
+#include <opencv2/core.hpp>
+
+namespace neptune {
+
+struct TrackingStats {
+    uint64_t frames = 0;         // frames passed to track()
+    uint64_t detectorRuns = 0;   // of which ran the face detector
+};
+
+/**
+ * LandmarkTracker - follows faces across the frames of one video stream.
+ * Holds per-stream state: use one instance per stream, called from one thread
+ * at a time. The detector and landmark extractor must outlive it.
+ */
+class LandmarkTracker {
+public:
+    LandmarkTracker(FaceDetector& detector, LandmarkExtractor& landmarks, const NeptuneConfig& config);
+
+    // Faces of the next frame, each with its face mesh landmarks, bounding box
+    // and face-presence score as confidence. At most NeptuneConfig::maxFaces.
+    std::vector<FaceBox> track(const cv::Mat& image);
+    std::vector<FaceBox> track(const YuvFrame& frame);
+
+    // Forget the tracked faces; the next frame runs the detector.
+    void reset();
+
+    const TrackingStats& stats() const { return stats_; }
+
+private:
+    template <typename Image>
+    std::vector<FaceBox> trackImpl(const Image& image);
+
+    // Runs the landmark model on `rois` and appends the faces still present to `faces`.
+    template <typename Image>
+    void followRois(const Image& image, const std::vector<NormalizedRect>& rois, std::vector<FaceBox>& faces);
+
+    FaceDetector& detector_;
+    LandmarkExtractor& landmarks_;
+    int maxFaces_;
+    int redetectInterval_;
+    float minPresence_;
+    float roiScale_;
+    bool alignCrops_;
+
+    std::vector<NormalizedRect> rois_;   // next frame's crop per tracked face
+    int framesSinceDetection_ = 0;
+    TrackingStats stats_;
+};
+
+} // namespace neptune
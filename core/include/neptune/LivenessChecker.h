@@ -1,74 +1,138 @@
-
 #pragma once
 
 #include "neptune/Types.h"
-#include <deque>
 #include <chrono>
+#include <cstdint>
 #include <string>
 #include <vector>
 
 namespace neptune {
 
+// Blink and head-movement liveness, with separate state for every face in
+// the stream. A face continues the state of the face it overlaps most in the
+// previous frames (or that had the same FaceBox::trackId); states live in a
+// slab of livenessMaxFaces slots, found through a spatial hash of their last
+// box, and the least recently seen one is reused for a new face.
+//
+// Time is stream time: probation, debounce and the liveness window are
+// measured between FaceBox::detectionTime of successive frames, never with
+// the wall clock, so recorded video can be checked faster than real time
+// with the same results. Callers must set detectionTime on every face; an
+// unset one falls back to the wall clock, with a warning.
 class LivenessChecker {
 public:
     explicit LivenessChecker(const NeptuneConfig& config);
 
-    // Main entry point: takes a face with landmarks, returns liveness result
+    // Main entry point: takes a face with landmarks, returns liveness result.
+    // Each call is one frame; use checkFrame() for frames with several faces.
     LivenessResult check(const FaceBox& face);
 
+    // All faces of one frame, results in the same order
+    std::vector<LivenessResult> checkFrame(const std::vector<FaceBox>& faces);
+
+    // Same, into caller-owned results: once their reason strings have grown,
+    // these do not allocate.
+    void check(const FaceBox& face, LivenessResult& result);
+    void checkFrame(const std::vector<FaceBox>& faces, std::vector<LivenessResult>& results);
+
     // Video mode control
     void setVideoMode(bool enabled);
 
-    // Resetters
+    // Resetters: drops the state of every face
     void resetForNewFrame();
 
-private:
-    NeptuneConfig config_;
-
-    // State tracking for blink detection
-    std::deque<float> earHistory_;
-    int blinkFrameCount_ = 0;
-
-    // State tracking for head movement detection
-    float lastYaw_ = 0.0f;
-    float lastPitch_ = 0.0f;
-    std::chrono::steady_clock::time_point lastHeadMoveTime_;
+    // Faces with liveness state, and the most it keeps (livenessMaxFaces)
+    size_t faceCount() const { return used_; }
+    size_t capacity() const { return states_.size(); }
 
-    // Smoothed pose values (these were missing)
-    float smoothedYaw_ = 0.0f;
-    float smoothedPitch_ = 0.0f;
-
-    // Helpers
-    float computeEAR(const std::vector<Point>& eyeLandmarks);
-    float estimateHeadYaw(const std::vector<Point>& landmarks);
-    float estimateHeadPitch(const std::vector<Point>& landmarks);
-
-    // New helper methods for detection
-    bool detectBlink(float currentEAR);
-    bool detectHeadMovement(float currentYaw, float currentPitch);
+private:
+    static constexpr size_t kHistoryLength = 15;
+
+    // Fixed-capacity history; pushing onto a full one drops the oldest value
+    template <typename T, size_t N>
+    struct Ring {
+        T values[N];
+        size_t start = 0;
+        size_t count = 0;
+
+        void push(T value) {
+            values[(start + count) % N] = value;
+            if (count < N) ++count;
+            else start = (start + 1) % N;
+        }
+        void clear() { start = count = 0; }
+        size_t size() const { return count; }
+        T operator[](size_t i) const { return values[(start + i) % N]; }   // oldest first
+    };
+
+    // Liveness state of one face, and its slot in the LRU list and hash grid
+    struct FaceState {
+        // Association
+        int trackId = -1;
+        float cx = 0.0f, cy = 0.0f, w = 0.0f, h = 0.0f;   // last box
+        uint64_t lastFrame = 0;
+        int lruPrev = -1, lruNext = -1;
+        int bucket = -1, bucketPrev = -1, bucketNext = -1;
+
+        // State tracking for blink detection
+        Ring<float, kHistoryLength> earHistory;
+        int blinkFrameCount = 0;
+
+        // State tracking for head movement detection
+        float lastYaw = 0.0f;
+        float lastPitch = 0.0f;
+        std::chrono::steady_clock::time_point lastHeadMoveTime;
+
+        // Smoothed pose values
+        float smoothedYaw = 0.0f;
+        float smoothedPitch = 0.0f;
+
+        bool isInitialized = false;
+        int frameCount = 0;
+
+        // Anti-spoofing
+        bool hasProvenLiveness = false;                      // Has the face proven it's alive?
+        std::chrono::steady_clock::time_point firstDetectionTime; // When we first detected this face
+        int totalBlinksDetected = 0;                         // Total blinks detected for this face
+        int totalHeadMovements = 0;                          // Total head movements detected for this face
+
+        // Noise filtering
+        Ring<float, kHistoryLength> yawHistory;     // History of yaw values for trend analysis
+        Ring<float, kHistoryLength> pitchHistory;   // History of pitch values for trend analysis
+
+        float baselineEAR = 0.3f;  // calibrated open-eye EAR
+        int calibrationFrames = 0;
+
+        void reset(std::chrono::steady_clock::time_point now);
+    };
 
-    bool isInitialized_;
-    int frameCount_;
+    NeptuneConfig config_;
     bool isVideoMode_;
 
-    // NEW ANTI-SPOOFING MEMBERS
-    bool hasProvenLiveness_;                                 // Has the face proven it's alive?
-    std::chrono::steady_clock::time_point firstDetectionTime_; // When we first detected this face
-    int totalBlinksDetected_ = 0;                            // Total blinks detected for this face
-    int totalHeadMovements_ = 0;                             // Total head movements detected for this face
-
-    // NOISE FILTERING MEMBERS
-    std::deque<float> yawHistory_;              // History of yaw values for trend analysis
-    std::deque<float> pitchHistory_;            // History of pitch values for trend analysis
-    int stableFrameCount_ = 0;                  // Frames without significant movement
-
-    // Warm-up and debounce parameters (tunable)
-    int poseWarmupFrames_ = 3;                  // frames used to stabilize initial pose
-    int poseWarmupCount_ = 0;                   // current warm-up counter
-    int minMovementIntervalMs_ = 300;           // minimum ms between counted head movements
-
-    float baselineEAR_; // Added for calibration
-    int calibrationFrames_; // Added for calibration
+    // Slab of face states; slots [0, used_) are live, in an LRU list from
+    // lruHead_ (most recent) to lruTail_
+    std::vector<FaceState> states_;
+    size_t used_ = 0;
+    int lruHead_ = -1;
+    int lruTail_ = -1;
+    // Hash grid over box centers: chains of slots per bucket
+    std::vector<int> buckets_;
+    uint32_t bucketShift_ = 0;
+    uint64_t frame_ = 0;   // frames seen, for one match per state per frame
+    bool warnedUnstamped_ = false;
+
+    void checkFace(const FaceBox& face, LivenessResult& result);
+    FaceState& stateFor(const FaceBox& face, std::chrono::steady_clock::time_point now);
+    int bucketOf(int level, int gx, int gy) const;
+    void place(int slot, const FaceBox& face);
+    void unlinkBucket(int slot);
+    void unlinkLru(int slot);
+    void pushLru(int slot);
+
+    // Detection, on the state of one face
+    bool detectBlink(FaceState& state, float currentEAR);
+    bool detectHeadMovement(FaceState& state, float currentYaw, float currentPitch,
+                            std::chrono::steady_clock::time_point now);
 };
 
 } // namespace neptune
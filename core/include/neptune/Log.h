@@ -1,9 +1,34 @@
 #pragma once
+#include <atomic>
+#include <memory>
+#include <sstream>
 #include <string>
 #include <iostream>
 
+#include "LogSink.h"
+
+/**
+ * Lowest level compiled into the binary: 0 debug, 1 info, 2 warn, 3 error,
+ * 4 off. Log statements below it are removed by the compiler, arguments
+ * included. Set through the NEPTUNE_LOG_LEVEL CMake option; release builds
+ * default to info.
+ */
+#ifndef NEPTUNE_LOG_MIN_LEVEL
+#ifdef NDEBUG
+#define NEPTUNE_LOG_MIN_LEVEL 1
+#else
+#define NEPTUNE_LOG_MIN_LEVEL 0
+#endif
+#endif
+
 namespace neptune {
 
+// Log::startAsync() settings.
+struct LogAsyncOptions {
+    size_t queueCapacity = 256;   // records buffered per logging thread (rounded up to a power of two)
+    int flushIntervalMs = 5;      // how often the writer drains the queues when idle
+};
+
 /**
  * @class Log
  * @brief A simple utility class for logging messages with different severities.
@@ -12,9 +37,68 @@ namespace neptune {
  * or to platform-specific loggers. The implementation will be extended
  * in the platform-specific wrappers to route messages to tools like
  * Android's Logcat or iOS's unified logging system.
+ *
+ * SDK code logs through the NEPTUNE_LOG_* macros below, which check the
+ * compile-time and runtime levels before the message is formatted.
+ *
+ * Lines go to a LogSink (ConsoleSink by default). After startAsync(), each
+ * logging thread instead copies its lines into its own lock-free ring and a
+ * background thread writes them out, so a slow terminal or pipe never
+ * stalls inference threads. A full ring drops the line and counts it.
  */
 class Log {
 public:
+    /**
+     * @brief Sets the runtime level; messages below it are dropped before
+     *        they are formatted. Defaults to Info.
+     */
+    static void setLevel(LogLevel level) { level_.store(static_cast<int>(level), std::memory_order_relaxed); }
+
+    static LogLevel level() { return static_cast<LogLevel>(level_.load(std::memory_order_relaxed)); }
+
+    /**
+     * @brief True if a message at `level` would be written.
+     */
+    static bool enabled(LogLevel level) {
+        return static_cast<int>(level) >= NEPTUNE_LOG_MIN_LEVEL &&
+               static_cast<int>(level) >= level_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Writes one already formatted line, without any level check:
+     *        queued when asynchronous logging is on, else straight to the sink.
+     */
+    static void write(LogLevel level, const char* tag, const std::string& message);
+
+    /**
+     * @brief Replaces the sink (nullptr restores ConsoleSink). Queued lines
+     *        written before the call go to the old sink.
+     */
+    static void setSink(std::shared_ptr<LogSink> sink);
+
+    /**
+     * @brief Starts the background writer; no-op if it is already running.
+     */
+    static void startAsync(const LogAsyncOptions& options = LogAsyncOptions());
+
+    /**
+     * @brief Drains the queues and stops the background writer; later lines
+     *        are written synchronously again.
+     */
+    static void stopAsync();
+
+    static bool isAsync();
+
+    /**
+     * @brief Blocks until every line logged so far has reached the sink.
+     */
+    static void flush();
+
+    /**
+     * @brief Lines dropped because a thread's queue was full.
+     */
+    static uint64_t droppedMessages();
+
     /**
      * @brief Logs an informational message.
      * @param tag The tag to identify the source of the message.
@@ -42,6 +126,48 @@ public:
      * @param message The message content.
      */
     static void debug(const std::string& tag, const std::string& message);
+
+    /**
+     * @brief Formats one message for the NEPTUNE_LOG_* macros and writes it
+     *        when destroyed. Only constructed once the level check passed.
+     */
+    class Line {
+    public:
+        Line(LogLevel level, const char* tag) : level_(level), tag_(tag) {}
+        ~Line() { write(level_, tag_, stream_.str()); }
+        Line(const Line&) = delete;
+        Line& operator=(const Line&) = delete;
+
+        std::ostream& stream() { return stream_; }
+
+    private:
+        LogLevel level_;
+        const char* tag_;
+        std::ostringstream stream_;
+    };
+
+private:
+    static std::atomic<int> level_;
 };
 
-} // namespace neptune
\ No newline at end of file
+} // namespace neptune
+
+/**
+ * Usage: NEPTUNE_LOG_INFO("FaceDetector", "Detected " << n << " faces");
+ * The message is a stream expression and is only evaluated when the level
+ * is enabled, so disabled levels cost one relaxed load (or nothing, below
+ * NEPTUNE_LOG_MIN_LEVEL).
+ */
+#define NEPTUNE_LOG(level, tag, message)                                               \
+    do {                                                                               \
+        if (static_cast<int>(level) >= NEPTUNE_LOG_MIN_LEVEL &&                        \
+            ::neptune::Log::enabled(level)) {                                          \
+            ::neptune::Log::Line neptuneLogLine(level, tag);                           \
+            neptuneLogLine.stream() << message;                                        \
+        }                                                                              \
+    } while (0)
+
+#define NEPTUNE_LOG_DEBUG(tag, message) NEPTUNE_LOG(::neptune::LogLevel::Debug, tag, message)
+#define NEPTUNE_LOG_INFO(tag, message) NEPTUNE_LOG(::neptune::LogLevel::Info, tag, message)
+#define NEPTUNE_LOG_WARN(tag, message) NEPTUNE_LOG(::neptune::LogLevel::Warn, tag, message)
+#define NEPTUNE_LOG_ERROR(tag, message) NEPTUNE_LOG(::neptune::LogLevel::Error, tag, message)
@@ -0,0 +1,118 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace neptune {
+
+enum class LogLevel {
+    Debug = 0,
+    Info = 1,
+    Warn = 2,
+    Error = 3,
+    Off = 4
+};
+
+const char* logLevelName(LogLevel level);
+
+/**
+ * @struct LogRecord
+ * @brief One log line as handed to a sink. The views are only valid for
+ *        the duration of LogSink::write().
+ */
+struct LogRecord {
+    LogLevel level = LogLevel::Info;
+    std::string_view tag;
+    std::string_view message;
+};
+
+/**
+ * @class LogSink
+ * @brief Destination of formatted log lines.
+ *
+ * With asynchronous logging the background writer is the only caller;
+ * otherwise Log serializes calls, so sinks need no locking of their own
+ * for write()/flush().
+ */
+class LogSink {
+public:
+    virtual ~LogSink() = default;
+
+    virtual void write(const LogRecord& record) = 0;
+
+    // Called after each batch of records; push buffered output out.
+    virtual void flush() {}
+};
+
+/**
+ * @class ConsoleSink
+ * @brief "[LEVEL][tag] message" lines, errors on stderr and everything else
+ *        on stdout, written one batch at a time.
+ */
+class ConsoleSink : public LogSink {
+public:
+    void write(const LogRecord& record) override;
+    void flush() override;
+
+private:
+    std::string out_;
+    std::string err_;
+};
+
+/**
+ * @class RotatingFileSink
+ * @brief Appends lines to `path`; once it exceeds maxBytes it is renamed to
+ *        path.1 (path.1 to path.2, ...) and a new file is started, keeping
+ *        at most maxFiles old files.
+ */
+class RotatingFileSink : public LogSink {
+public:
+    RotatingFileSink(std::string path, size_t maxBytes = 5 * 1024 * 1024, int maxFiles = 3);
+    ~RotatingFileSink() override;
+
+    RotatingFileSink(const RotatingFileSink&) = delete;
+    RotatingFileSink& operator=(const RotatingFileSink&) = delete;
+
+    bool isOpen() const { return file_ != nullptr; }
+
+    void write(const LogRecord& record) override;
+    void flush() override;
+
+private:
+    void open();
+    void rotate();
+
+    std::string path_;
+    size_t maxBytes_;
+    int maxFiles_;
+    std::FILE* file_ = nullptr;
+    size_t size_ = 0;
+};
+
+/**
+ * @class MemorySink
+ * @brief Keeps every record in memory; for tests. Safe to read from any
+ *        thread while logging continues.
+ */
+class MemorySink : public LogSink {
+public:
+    struct Entry {
+        LogLevel level;
+        std::string tag;
+        std::string message;
+    };
+
+    void write(const LogRecord& record) override;
+
+    std::vector<Entry> entries() const;
+    void clear();
+
+private:
+    mutable std::mutex mutex_;
+    std::vector<Entry> entries_;
+};
+
+} // namespace neptune
@@ -0,0 +1,108 @@
+//
+// File: NeptuneFacialSDK/core/include/neptune/ModelRegistry.h
+//
+// Process-wide cache of loaded .tflite models. Every component that needs a
+// model asks the registry for it, so several SDK instances, sessions or
+// interpreter pools in one process share a single mmap per model file.
+//
+
+#pragma once
+
+#include "tensorflow/lite/model.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace neptune {
+
+// Immutable model handle; the mapping is released with the last reference.
+using SharedModel = std::shared_ptr<const ::tflite::FlatBufferModel>;
+
+// Memory accounting for one loaded model.
+struct ModelStats {
+    std::string path;            // canonical path (or buffer name) the model was first loaded from
+    uint64_t contentHash = 0;    // FNV-1a of the model bytes
+    size_t mappedBytes = 0;      // size of the model mapping
+    size_t residentBytes = 0;    // pages of the mapping currently in RAM
+    long users = 0;              // live references held outside the registry
+};
+
+/**
+ * @class ModelRegistry
+ * @brief Reference-counted, thread-safe registry of shared FlatBufferModels.
+ *
+ * Models are keyed by canonical path and, to catch copies of the same file
+ * under different names, by content hash. The registry only holds weak
+ * references: a model is unmapped as soon as its last user releases it.
+ */
+class ModelRegistry {
+public:
+    static ModelRegistry& instance();
+
+    /**
+     * @brief Returns the shared model for `modelPath`, loading it if needed.
+     * @param modelPath Path of the .tflite file, or "embedded:<name>" for a
+     *        model compiled into the library (see EmbeddedModels.h).
+     * @param error Optional; receives a message on failure.
+     * @return The model, or nullptr if it cannot be loaded.
+     */
+    SharedModel acquire(const std::string& modelPath, std::string* error = nullptr);
+
+    /**
+     * @brief Returns a shared model built directly on a caller-owned buffer.
+     *
+     * The buffer is not copied and must stay valid and unchanged for as long
+     * as any engine uses the model. Models are keyed by buffer address, so
+     * repeated calls for the same buffer share one FlatBufferModel.
+     * @param data Start of the .tflite flatbuffer (at least 4-byte aligned).
+     * @param size Size of the buffer in bytes.
+     * @param name Used for logging and stats only.
+     * @param error Optional; receives a message on failure.
+     */
+    SharedModel acquireFromBuffer(const void* data, size_t size, const std::string& name,
+                                  std::string* error = nullptr);
+
+    /**
+     * @brief FNV-1a hash of the model bytes, e.g. to key caches derived from it.
+     *
+     * Computed at load time for files; for buffer models it is computed on
+     * first request and remembered. Returns 0 for models not from the registry.
+     */
+    uint64_t contentHash(const SharedModel& model);
+
+    // One entry per distinct live model.
+    std::vector<ModelStats> stats() const;
+
+    // Sum of residentBytes over stats().
+    size_t residentBytes() const;
+
+    // Logs stats() at info level.
+    void logStats() const;
+
+private:
+    ModelRegistry() = default;
+    ModelRegistry(const ModelRegistry&) = delete;
+    ModelRegistry& operator=(const ModelRegistry&) = delete;
+
+    struct Entry {
+        std::weak_ptr<const ::tflite::FlatBufferModel> model;
+        uint64_t contentHash = 0;
+        uintmax_t fileSize = 0;
+        std::filesystem::file_time_type modified;
+        std::string name;   // reported in stats
+    };
+
+    void pruneExpired();
+
+    std::unordered_map<std::string, Entry> byPath_;     // canonical path or buffer key -> model
+    std::unordered_map<uint64_t, std::string> byHash_;  // content hash -> owning path
+    mutable std::mutex mutex_;
+};
+
+} // namespace neptune
@@ -10,10 +10,15 @@
 #include "Types.h"
 #include "FaceDetector.h"
 #include "EmotionRecognizer.h"
- #include "LivenessChecker.h"
+#include "LivenessChecker.h"
+#include "FaceTracker.h"
+#include "LandmarkTracker.h"
+#include "landmark_extractor.h"
 #include "Preprocess.h"
+#include "YuvFrame.h"
 #include "Log.h"
 
+#include <chrono>
 #include <memory>
 #include <string>
 #include <vector>
@@ -38,11 +43,42 @@ public:
 
     /**
      * @brief Processes a single image to detect faces, recognize emotions, and check liveness.
+     *
+     * With NeptuneConfig::trackFaces and a face landmark model, consecutive
+     * calls are treated as frames of one video: faces are followed from their
+     * landmarks and the detector only runs when needed (see LandmarkTracker).
      * @param image The input image in OpenCV Mat format.
      * @return A vector of ProcessedFace objects, one for each face found.
      */
     std::vector<NeptuneResult> processImage(const cv::Mat& image);
 
+    /**
+     * @brief Same as processImage(), for a frame taken at @p timestamp.
+     *
+     * The timestamp becomes every face's FaceBox::detectionTime, and the
+     * liveness checks measure time between frames with it rather than with
+     * the wall clock. Pass the frame's position in a recorded video to
+     * process it faster than real time with the same results as a live run.
+     * The overload without a timestamp uses steady_clock::now().
+     */
+    std::vector<NeptuneResult> processImage(const cv::Mat& image, std::chrono::steady_clock::time_point timestamp);
+
+    /**
+     * @brief Same as processImage(), for a YUV 4:2:0 camera frame (NV12, NV21 or I420).
+     *
+     * The frame is never converted to BGR as a whole: each model input is
+     * color-converted while it is cropped and resized, so only the pixels
+     * the models sample are converted.
+     * @param frame Planes and strides of the frame; must stay valid during the call.
+     */
+    std::vector<NeptuneResult> processFrame(const YuvFrame& frame);
+    std::vector<NeptuneResult> processFrame(const YuvFrame& frame, std::chrono::steady_clock::time_point timestamp);
+
+    /**
+     * @brief Per-model load, allocate and first-invoke times measured by create().
+     */
+    const StartupReport& startupReport() const { return startupReport_; }
+
 private:
     // Private constructor to enforce creation via the static `create` method.
     NeptuneSDK(const NeptuneConfig& config);
@@ -50,14 +86,25 @@ private:
     // Private initialization method.
     bool init();
 
+    // Landmark model from faceLandmarkModelPath; nullptr if unset or not loadable.
+    std::unique_ptr<LandmarkExtractor> createLandmarkExtractor() const;
+
+    // processImage()/processFrame() body; Image is cv::Mat or YuvFrame.
+    template <typename Image>
+    std::vector<NeptuneResult> process(const Image& image, std::chrono::steady_clock::time_point timestamp);
+
     // The individual SDK components.
     std::unique_ptr<FaceDetector> faceDetector_;
     std::unique_ptr<EmotionRecognizer> emotionRecognizer_;
     std::unique_ptr<LivenessChecker> livenessChecker_;   // enable this
+    std::unique_ptr<LandmarkExtractor> landmarkExtractor_;   // only with faceLandmarkModelPath
+    std::unique_ptr<LandmarkTracker> tracker_;               // only with trackFaces
+    std::unique_ptr<FaceTracker> faceTracker_;               // only with trackIdentities
 
 
     // SDK configuration.
     NeptuneConfig config_;
+    StartupReport startupReport_;
 };
 
 } // namespace neptune
@@ -0,0 +1,36 @@
+//
+// File: NeptuneFacialSDK/core/include/neptune/NonMaxSuppression.h
+//
+// Non-max suppression of face detector candidates. Candidates are handled by
+// index: one sort by score, then a sweep in score order where each candidate
+// is compared only with the faces already kept near it (a uniform grid once
+// there are many candidates). Weighted mode blends every candidate into the
+// face that absorbs it, as MediaPipe's face detection graphs do.
+//
+
+#pragma once
+
+#include "DetectionDecoder.h"
+
+#include <vector>
+
+namespace neptune {
+
+enum class NmsMode {
+    HARD = 0,      // keep the best candidate of each cluster as is
+    WEIGHTED = 1   // score-weighted average of each cluster's boxes and keypoints
+};
+
+struct NmsOptions {
+    NmsMode mode = NmsMode::WEIGHTED;
+    float iouThreshold = 0.3f;   // candidates overlapping a kept face by more are merged into it
+    int maxDetections = 0;       // faces kept, best first; <= 0 keeps all
+};
+
+// Appends the kept faces to `out`, best score first. `candidates` is not
+// modified. Weighted faces keep the score of their best candidate. Scratch
+// space is per thread, so this is allocation-free once it has grown.
+void nonMaxSuppression(const std::vector<FaceDetection>& candidates, const NmsOptions& options,
+                       std::vector<FaceDetection>& out);
+
+} // namespace neptune
@@ -0,0 +1,44 @@
+//
+// File: NeptuneFacialSDK/core/include/neptune/OpProfile.h
+//
+// Per-operator latency statistics collected by TfLiteEngine's opt-in
+// profiling mode, with CSV/JSON export for offline analysis.
+//
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace neptune {
+
+// Timing of one graph node over all profiled invokes, in microseconds.
+struct OpProfileStat {
+    std::string name;        // first output tensor of the node, or the op type
+    std::string type;        // TFLite op type, e.g. CONV_2D, or the delegate kernel
+    int nodeIndex = -1;
+    int batchSize = 1;       // batch size the interpreter was running at
+    bool delegated = false;  // event came from inside a delegate
+    int count = 0;           // number of samples
+    double meanUs = 0.0;
+    double p95Us = 0.0;
+    double totalUs = 0.0;
+};
+
+// Summary of a profiling session on one engine.
+struct OpProfile {
+    std::string model;
+    int invokes = 0;
+    double invokeMeanUs = 0.0;
+    double invokeP95Us = 0.0;
+    std::vector<OpProfileStat> ops;   // sorted by totalUs, descending
+
+    // One header row plus one row per op.
+    std::string toCsv() const;
+    std::string toJson() const;
+
+    // Mean and 95th percentile of `samples`; both 0 when empty.
+    static void summarize(std::vector<double> samples, double& mean, double& p95);
+};
+
+} // namespace neptune
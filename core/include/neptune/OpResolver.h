@@ -0,0 +1,22 @@
+//
+// File: NeptuneFacialSDK/core/include/neptune/OpResolver.h
+//
+// The op resolver every TfLiteEngine builds its interpreters with. By default
+// it is TFLite's full builtin resolver; with the CMake option
+// NEPTUNE_SELECTIVE_OPS it only registers the ops used by the shipped models
+// (generated by tools/gen_op_resolver.py).
+//
+
+#pragma once
+
+#include "tensorflow/lite/model.h"
+
+namespace neptune {
+
+// Resolver of the calling thread, built on its first use.
+const ::tflite::OpResolver& opResolver();
+
+// True when neptune_core was built with NEPTUNE_SELECTIVE_OPS.
+bool usesSelectiveOpResolver();
+
+} // namespace neptune
@@ -12,6 +12,10 @@
 
 #include <vector>
 
+#include "TensorView.h"
+#include "Types.h"
+#include "YuvFrame.h"
+
 namespace neptune {
     namespace img {
     
@@ -22,6 +26,64 @@ namespace neptune {
     
         // Convert BGR->RGB, normalize to 0-1, and flatten to NHWC vector
         static std::vector<float> normalize(const cv::Mat& img);
+
+        // Same as normalize(), but writes straight into an NHWC tensor whose H/W
+        // match the image. float32 tensors get [0,1] values; uint8/int8 tensors
+        // get those values quantized with the tensor's scale/zero point in the
+        // same pass. swapRB=false keeps the source channel order.
+        // Returns false if the view does not fit the image.
+        static bool normalizeInto(const cv::Mat& img, const InputTensorView& dst, bool swapRB = true);
+
+        // resize() + normalizeInto() in one pass: bilinearly samples the
+        // CV_8UC3 image (or ROI view) straight into the NHWC tensor, with no
+        // intermediate Mats. keepAspect=true letterboxes like resize()
+        // (centered, padded with real 0); false stretches to the tensor size
+        // like cv::resize. Matches the two-step path to within OpenCV's
+        // fixed-point rounding (about 1/255). Allocation-free once a thread
+        // has seen its largest input size.
+        static bool resizeNormalizeInto(const cv::Mat& img, const InputTensorView& dst,
+                                        bool swapRB = true, bool keepAspect = true);
+
+        // Same, for the part of `img` inside `roi` (clipped to the image).
+        static bool resizeNormalizeInto(const cv::Mat& img, const cv::Rect& roi, const InputTensorView& dst,
+                                        bool swapRB = true, bool keepAspect = true);
+
+        // Same, sampling a YUV frame: only the pixels the resampling reads
+        // are converted (to BGR, then optionally swapped), so there is no
+        // full-frame color conversion.
+        static bool resizeNormalizeInto(const YuvFrame& frame, const cv::Rect& roi, const InputTensorView& dst,
+                                        bool swapRB = true, bool keepAspect = true);
+
+        // Crop ROI for a detected face: centered on the box, `scale` times its
+        // size (square uses the longer side for both), and with align=true
+        // rotated so the eyes are level. The eyes are the detector keypoints
+        // 0/1 or, once landmarks replaced them, face mesh points 33/263;
+        // without either the ROI stays axis-aligned.
+        static NormalizedRect faceRoi(const FaceBox& face, const cv::Size& imageSize, float scale = 1.0f,
+                                      bool square = false, bool align = true);
+
+        // Crop ROI following a face from its previous frame's face mesh
+        // (MediaPipe's landmarks-to-ROI step): the landmarks' bounding box in
+        // the frame where the eyes (33/263) are level, scaled by `scale` and
+        // made square, rotated like the face. Empty for fewer than 468 points.
+        static NormalizedRect landmarksRoi(const std::vector<Point>& landmarks, const cv::Size& imageSize,
+                                           float scale = 1.5f, bool align = true);
+
+        // Axis-aligned ROI covering `rect`.
+        static NormalizedRect rectRoi(const cv::Rect& rect, const cv::Size& imageSize);
+
+        // Samples a (possibly rotated) ROI into the NHWC tensor with one
+        // bilinear affine warp, normalizing like resizeNormalizeInto().
+        // keepAspect letterboxes the ROI; samples that fall outside the image
+        // repeat its border. `tensorToImage`, when given, receives the map
+        // from tensor pixel coordinates to image pixel coordinates, for
+        // projecting model outputs (e.g. landmarks) back into the image.
+        static bool warpNormalizeInto(const cv::Mat& img, const NormalizedRect& roi, const InputTensorView& dst,
+                                      bool swapRB = true, bool keepAspect = false,
+                                      cv::Matx23f* tensorToImage = nullptr);
+        static bool warpNormalizeInto(const YuvFrame& frame, const NormalizedRect& roi, const InputTensorView& dst,
+                                      bool swapRB = true, bool keepAspect = false,
+                                      cv::Matx23f* tensorToImage = nullptr);
     };
     
     } // namespace img
@@ -0,0 +1,158 @@
+//
+// File: NeptuneFacialSDK/core/include/neptune/TensorView.h
+//
+// Lightweight, non-owning views over interpreter tensor memory. They let
+// preprocessing write straight into input tensors, and decoders read outputs
+// in place, without pulling the TensorFlow Lite headers into every component.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+
+namespace neptune {
+
+// Element type of a tensor, mirrored from the TFLite types we support.
+enum class TensorType {
+    UNKNOWN = 0,
+    FLOAT32 = 1,
+    UINT8 = 2,
+    INT8 = 3
+};
+
+constexpr int kMaxTensorRank = 6;
+
+inline size_t tensorTypeSize(TensorType type) {
+    switch (type) {
+        case TensorType::FLOAT32: return 4;
+        case TensorType::UINT8:
+        case TensorType::INT8:    return 1;
+        default:                  return 0;
+    }
+}
+
+inline bool isQuantizedType(TensorType type) {
+    return type == TensorType::UINT8 || type == TensorType::INT8;
+}
+
+// Affine quantization: real = scale * (q - zeroPoint).
+inline int32_t quantizeValue(float real, float scale, int32_t zeroPoint, TensorType type) {
+    const int32_t lo = type == TensorType::INT8 ? -128 : 0;
+    const int32_t hi = type == TensorType::INT8 ? 127 : 255;
+    const int32_t q = static_cast<int32_t>(std::lround(real / scale)) + zeroPoint;
+    return std::min(hi, std::max(lo, q));
+}
+
+/**
+ * @struct InputTensorView
+ * @brief Writable view of an input tensor (pointer, shape, strides, dtype).
+ *
+ * The view does not own the memory. It stays valid until the owning engine
+ * resizes or reallocates its tensors.
+ */
+struct InputTensorView {
+    void* data = nullptr;
+    TensorType type = TensorType::UNKNOWN;
+    int rank = 0;
+    int shape[kMaxTensorRank] = {};
+    int64_t strides[kMaxTensorRank] = {}; // in elements, row-major
+    size_t bytes = 0;
+    float scale = 0.0f;      // quantized types only
+    int32_t zeroPoint = 0;   // quantized types only
+
+    bool valid() const { return data != nullptr && rank > 0; }
+    bool isQuantized() const { return isQuantizedType(type); }
+
+    int64_t elementCount() const {
+        int64_t n = rank > 0 ? 1 : 0;
+        for (int i = 0; i < rank; ++i) n *= shape[i];
+        return n;
+    }
+
+    // NHWC accessors; return 0 when the tensor is not rank 4.
+    int height() const { return rank == 4 ? shape[1] : 0; }
+    int width() const { return rank == 4 ? shape[2] : 0; }
+    int channels() const { return rank == 4 ? shape[3] : 0; }
+
+    template <typename T>
+    T* as() const { return static_cast<T*>(data); }
+
+    // View of batch item `index` (outermost dimension), with that dimension set to 1.
+    InputTensorView slice(int index) const {
+        InputTensorView item = *this;
+        if (!valid() || index < 0 || index >= shape[0]) return InputTensorView();
+        const size_t itemBytes = static_cast<size_t>(strides[0]) * tensorTypeSize(type);
+        item.data = static_cast<char*>(data) + itemBytes * index;
+        item.shape[0] = 1;
+        item.bytes = itemBytes;
+        return item;
+    }
+};
+
+/**
+ * @class TensorSpan
+ * @brief Read-only, non-owning span over contiguous tensor elements.
+ *
+ * Spans returned by TfLiteEngine are valid until the next invoke(),
+ * resizeInputTensor() or loadModel() on that engine.
+ */
+template <typename T>
+class TensorSpan {
+public:
+    TensorSpan() = default;
+    TensorSpan(const T* data, size_t size) : data_(data), size_(size) {}
+
+    const T* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    const T& operator[](size_t i) const { return data_[i]; }
+    const T* begin() const { return data_; }
+    const T* end() const { return data_ + size_; }
+
+private:
+    const T* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+/**
+ * @struct OutputTensorView
+ * @brief Read-only, dtype-agnostic view of an output tensor.
+ *
+ * operator[] returns the real (float) value of an element, dequantizing
+ * quantized tensors on access, so decoders only pay for the elements they
+ * actually read. Same lifetime rules as TensorSpan.
+ */
+struct OutputTensorView {
+    const void* data = nullptr;
+    TensorType type = TensorType::UNKNOWN;
+    size_t size = 0;         // element count
+    float scale = 0.0f;      // quantized types only
+    int32_t zeroPoint = 0;   // quantized types only
+
+    bool empty() const { return data == nullptr || size == 0; }
+    bool isQuantized() const { return isQuantizedType(type); }
+
+    float operator[](size_t i) const {
+        switch (type) {
+            case TensorType::FLOAT32: return static_cast<const float*>(data)[i];
+            case TensorType::UINT8:   return scale * (static_cast<int32_t>(static_cast<const uint8_t*>(data)[i]) - zeroPoint);
+            case TensorType::INT8:    return scale * (static_cast<int32_t>(static_cast<const int8_t*>(data)[i]) - zeroPoint);
+            default:                  return 0.0f;
+        }
+    }
+
+    // Sub-view of `count` elements starting at `offset` (e.g. one batch item).
+    OutputTensorView slice(size_t offset, size_t count) const {
+        OutputTensorView sub = *this;
+        if (offset + count > size) return OutputTensorView();
+        sub.data = static_cast<const char*>(data) + offset * tensorTypeSize(type);
+        sub.size = count;
+        return sub;
+    }
+};
+
+} // namespace neptune
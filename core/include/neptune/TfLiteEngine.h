@@ -6,35 +6,110 @@
 #include <vector>
 #include <memory>
 #include <string>
+#include <map>
+#include <set>
+#include <tuple>
 
 #include "tensorflow/lite/interpreter.h"
 #include "tensorflow/lite/model.h"
 #include "tensorflow/lite/kernels/register.h"
 
+#include "Types.h"
+#include "TensorView.h"
+#include "ModelRegistry.h"
+#include "OpProfile.h"
+
+namespace tflite {
+namespace profiling {
+class BufferedProfiler;
+} // namespace profiling
+} // namespace tflite
+
 namespace neptune {
 
+// Execution options applied when the interpreter is built.
+struct EngineOptions {
+    bool useXnnpack = false;
+    int numThreads = -1;      // -1 keeps the TFLite default
+    bool allowFp16 = false;   // XNNPACK only
+    bool warmUp = false;      // invoke once on zeroed inputs after loading
+    // Directory for persistent XNNPACK weights caches (XNNPACK only; empty
+    // disables). One memory-mapped file per model content hash and CPU, so
+    // later processes map the packed weights instead of repacking them.
+    std::string weightsCacheDir;
+    // Interpreters kept for batch sizes other than the active one (each has
+    // its own arena and delegate); the least recently used is dropped.
+    int maxCachedBatchSizes = 4;
+
+    static EngineOptions fromConfig(const NeptuneConfig& config);
+};
+
 class TfLiteEngine {
 public:
     TfLiteEngine();
+    explicit TfLiteEngine(const EngineOptions& options);
     ~TfLiteEngine();
   
 
-    // Load a .tflite model from disk
+    // Load a .tflite model from disk, or "embedded:<name>" for a model compiled
+    // into the library. The model is obtained from the ModelRegistry, so
+    // engines loading the same file share one mapping.
     bool loadModel(const std::string& modelPath);
 
+    // Load a .tflite model from memory without copying it. The buffer must
+    // outlive this engine. `name` is only used for logging.
+    bool loadModelFromBuffer(const void* data, size_t size, const std::string& name = "buffer");
+
+    // Build this engine's interpreter on an already loaded model. The model is
+    // immutable and may be shared by many engines (see InterpreterPool).
+    // `name` is only used for logging.
+    bool attachModel(SharedModel model, const std::string& name);
+
     // Optionally resize input tensor (NHWC). After calling, tensors are (re)allocated.
     bool resizeInputTensor(int width, int height, int channels);
 
-    // Copy input data into the tensor (expects float32 NHWC, size == 1*H*W*C)
+    // Copy input data into the tensor (real values, NHWC, size == N*H*W*C).
+    // Quantized (uint8/int8) inputs are quantized with the tensor's scale/zero point.
     bool setInputTensor(const std::vector<float>& inputData);
 
+    // Writable view of input tensor `index` so callers can preprocess straight
+    // into interpreter memory. Invalid view on failure. Valid until the next
+    // resizeInputTensor() or loadModel().
+    InputTensorView inputTensorView(int index = 0);
+
+    // Set the batch (outermost) dimension of input 0 for the following
+    // inputTensorView()/invoke() calls. One interpreter is built and allocated
+    // per batch size and cached, so alternating face counts does not
+    // reallocate tensors every frame; at most maxCachedBatchSizes are kept
+    // besides the active one, the least recently used is rebuilt on demand.
+    // Interpreters built here keep the spatial size of resizeInputTensor().
+    // Returns false if the model cannot run at that size; the previous batch
+    // size stays active.
+    bool setBatchSize(int batchSize);
+    int batchSize() const { return batchSize_; }
+
     // Run inference
     bool invoke();
 
-    // Get output tensor data (float32). Returns empty vector on failure.
+    // Invoke once on zeroed inputs so one-time costs (kernel preparation,
+    // weight packing, lazy allocations) are paid now instead of on the first
+    // real frame. Returns the invoke time in ms, or a negative value on failure.
+    double warmUp();
+
+    // Get output tensor data as real values (quantized outputs are
+    // dequantized). Returns empty vector on failure.
     std::vector<float> getOutputTensor(int index = 0) const;
 
-    // Query input/output tensor info
+    // Dtype-agnostic, non-owning view of an output tensor. Elements read
+    // through it are dequantized on access. Empty on failure. Valid until the
+    // next invoke(), resize or load.
+    OutputTensorView outputTensorView(int index = 0) const;
+
+    // Non-owning view of a float32 output tensor; no copy is made. Empty on
+    // failure. Valid until the next invoke(), resize or load.
+    TensorSpan<float> outputTensorSpan(int index = 0) const;
+
+    // Query input/output tensor info (sizes are element counts)
     int getInputTensorSize() const;
     int getOutputTensorSize(int index = 0) const;
     int getNumOutputs() const;
@@ -50,16 +125,82 @@ public:
     // The new method to be added
     bool isLoaded() const;
 
+    // Backend that was actually applied by loadModel() (BUILTIN if the
+    // delegate was not requested or could not be applied).
+    InferenceBackend backend() const { return backend_; }
+    static const char* backendName(InferenceBackend backend);
+
+    // Cache file used for this engine's model, empty if caching is off.
+    const std::string& weightsCachePath() const { return weightsCachePath_; }
+
+    // Load/allocate/warm-up timings of the last loadModel()/attachModel().
+    const ModelStartupTiming& startupTiming() const { return timing_; }
+
+    // Opt-in per-op profiling built on TFLite's BufferedProfiler. While
+    // enabled, every invoke() records the time of each node; opProfile()
+    // summarizes all invokes since enableProfiling()/resetProfile().
+    // Adds per-op overhead, so leave it off in production. On an XNNPACK
+    // engine the first call rebuilds the interpreter so the delegate reports
+    // its ops: fill the inputs again afterwards.
+    bool enableProfiling(int maxEventsPerInvoke = 2048);
+    void disableProfiling();
+    bool profilingEnabled() const { return profiler_ != nullptr; }
+    void resetProfile();
+    OpProfile opProfile() const;
+
 private:
+    using DelegatePtr = std::unique_ptr<TfLiteDelegate, void (*)(TfLiteDelegate*)>;
+
+    // An interpreter parked in the batch cache, with the delegate it owns.
+    struct CachedInterpreter {
+        DelegatePtr delegate{nullptr, nullptr};
+        std::unique_ptr<::tflite::Interpreter> interpreter;
+        InferenceBackend backend = InferenceBackend::BUILTIN;
+        uint64_t lastUsed = 0;   // park order, for LRU eviction
+    };
+
+    // A weights cache the delegate rejects is deleted and rebuilt once,
+    // unless retryCache is false.
+    bool buildInterpreter(bool withDelegate, int batchSize = 0, bool retryCache = true);
+    void parkActive(int batchSize);
+    bool restoreParked(int batchSize);
+    void trimBatchCache();
     void updateInputDims();
-
-    std::unique_ptr<::tflite::FlatBufferModel> model_;
+    void collectProfileEvents();
+    bool rebuildForProfiling();
+    std::string resolveWeightsCachePath(const std::string& name);
+
+    // Samples of one node, keyed by (batch size, node index, delegated, op type).
+    using OpKey = std::tuple<int, int, bool, std::string>;
+    struct OpSamples {
+        std::string name;
+        std::vector<double> us;
+    };
+
+    EngineOptions options_;
+    InferenceBackend backend_ = InferenceBackend::BUILTIN;
+    int batchSize_ = 1;
+
+    // Declaration order matters: the interpreter must be destroyed before
+    // the delegate it was modified with and the profiler it reports to, and
+    // all of them before the model.
+    SharedModel model_;
+    std::unique_ptr<::tflite::profiling::BufferedProfiler> profiler_;
+    DelegatePtr delegate_;
     std::unique_ptr<::tflite::Interpreter> interpreter_;
+    std::map<int, CachedInterpreter> batchCache_;
+    uint64_t parkCount_ = 0;
+    std::set<int> unsupportedBatchSizes_;
+    std::vector<int> customInputDims_;   // H, W, C of resizeInputTensor(); empty = the model's own
 
     int inputWidth_ = 0;
     int inputHeight_ = 0;
     int inputChannels_ = 0;
 
+    ModelStartupTiming timing_;
+    std::string weightsCachePath_;
+    std::map<OpKey, OpSamples> opSamples_;
+    std::vector<double> invokeSamples_;
     std::string lastError_;
 };
 
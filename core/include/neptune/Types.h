@@ -32,9 +32,10 @@ struct FaceBox {
     int height;
     float confidence;
     std::vector<Point> landmarks; // 68, 106, or 468 facial landmarks
-    std::chrono::steady_clock::time_point detectionTime;
+    std::chrono::steady_clock::time_point detectionTime; // time of the frame: wall clock from FaceDetector, stream time from NeptuneSDK::processImage
+    int trackId;                  // same person across frames (FaceTracker); -1 if not tracked
     
-    FaceBox() : x(0), y(0), width(0), height(0), confidence(0.0f) {}
+    FaceBox() : x(0), y(0), width(0), height(0), confidence(0.0f), trackId(-1) {}
 };
 
 // Corrected emotion enum matching model output
@@ -102,8 +103,16 @@ enum class FaceDetectorBackend {
     AUTO = 2
 };
 
+// TFLite execution backend actually applied to a model
+enum class InferenceBackend {
+    BUILTIN = 0,   // TFLite builtin kernels, no delegate
+    XNNPACK = 1
+};
+
 
 // Configuration settings for the SDK.
+// Model paths are file paths, or "embedded:<name>" for models compiled in
+// with NEPTUNE_EMBED_MODELS (see EmbeddedModels.h).
 struct NeptuneConfig {
     std::string faceDetectionModelPath;
     std::string emotionModelPath;
@@ -119,17 +128,83 @@ struct NeptuneConfig {
     float headYawChangeMinDeg = 10.0f;
     float headPitchChangeMinDeg = 8.0f;
     double livenessWindowMs = 2000.0;
+    int livenessMaxFaces = 64;          // faces with liveness state at once; the least recently seen is evicted
+    float livenessMinIou = 0.3f;        // overlap with a face's last box to continue its state
+    int livenessMaxMissedFrames = 15;   // frames a face can go unseen and keep its state
 
     // MediaPipe configuration
     FaceDetectorBackend faceDetectorBackend = FaceDetectorBackend::AUTO;
     bool useMediaPipe = true;
-    int maxFaces = 2;
+    int maxFaces = 2;               // faces returned per frame, best first; <= 0 returns all
+    bool weightedNms = false;       // blend overlapping detections (MediaPipe) rather than drop them
+    float nmsIouThreshold = 0.3f;   // overlap above which detections are merged
     int landmarkType = 468; // 68, 106, or 468 landmarks
     
     // Performance settings
     int processingWidth = 320;
     int processingHeight = 240;
     bool enableGPU = false;
+
+    // CPU inference backend (applied to every TFLite model)
+    bool useXnnpack = false;       // opt-in XNNPACK delegate
+    int numThreads = -1;           // intra-op threads, -1 keeps the TFLite default
+    bool allowFp16Inference = false; // let XNNPACK run fp32 ops in fp16
+    std::string xnnpackCacheDir;     // persistent XNNPACK packed-weights cache; empty disables it
+
+    // Concurrency: interpreters per model, shared across calling threads
+    int interpreterPoolSize = 1;
+    bool blockWhenPoolBusy = true;   // false: calls on a busy pool return empty results
+    int maxCachedBatchSizes = 4;     // batched interpreters kept per engine besides the active one; LRU
+
+    // Tiled detection for high-resolution frames (MediaPipe 2-output detectors)
+    bool tiledDetection = false;       // also detect on overlapping tiles, merged by one NMS
+    int detectionTileSize = 0;         // tile side in pixels; 0 = one tile per detection thread
+    float detectionTileOverlap = 0.2f; // fraction of a tile shared with its neighbours
+    int detectionThreads = 0;          // threads running the tiles; 0 = hardware concurrency.
+                                       // Above 1, detector interpreters use one intra-op thread each
+
+    // Logging
+    bool asyncLogging = false;       // write log lines from a background thread (Log::startAsync)
+
+    // Startup
+    bool parallelInit = false;       // load the SDK's models concurrently
+    bool warmUpModels = false;       // run one invoke on each model's first interpreter at load
+
+    // Video tracking (NeptuneSDK with a face landmark model): detect once, then
+    // follow each face from its landmarks (LandmarkTracker)
+    bool trackFaces = false;
+    int redetectIntervalFrames = 30;  // also detect this often, for new faces; <= 0 only when a face is lost
+    float minFacePresence = 0.5f;     // landmark face-presence score below which a face is lost
+
+    // Identity tracking (FaceTracker): a stable FaceBox::trackId per person
+    bool trackIdentities = false;
+    int trackConfirmFrames = 3;        // consecutive matches before a track gets reported
+    int trackMaxMissedFrames = 10;     // frames a confirmed track survives unmatched
+    float trackMinIou = 0.2f;          // association gate: overlap with the predicted box...
+    float trackMaxCenterDistance = 0.5f; // ...or center distance, relative to the box size
+    int maxTracks = 256;               // tracks kept at once; preallocated
+
+    // Face crops for the landmark and emotion models
+    bool alignFaceCrops = true;      // rotate crops so the eye keypoints are level
+    float landmarkRoiScale = 1.5f;   // square landmark crop, relative to the detection box
+    float emotionRoiScale = 1.0f;    // emotion crop (letterboxed), relative to the detection box
+};
+
+// One-time cost of bringing a model up, in milliseconds.
+struct ModelStartupTiming {
+    std::string model;
+    double loadMs = 0.0;          // map and verify the flatbuffer
+    double allocateMs = 0.0;      // build interpreter, apply delegate, allocate tensors
+    double firstInvokeMs = 0.0;   // warm-up invoke; 0 when warm-up is disabled
+    InferenceBackend backend = InferenceBackend::BUILTIN;
+    bool weightsCacheHit = false; // packed weights were mapped from an existing XNNPACK cache file
+};
+
+// Returned by NeptuneSDK::startupReport().
+struct StartupReport {
+    std::vector<ModelStartupTiming> models;
+    double totalMs = 0.0;         // wall time of NeptuneSDK::init
+    bool parallel = false;
 };
 
 struct NormalizedRect {
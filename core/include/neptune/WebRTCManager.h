@@ -6,11 +6,14 @@
 #include "EmotionRecognizer.h"
 #include "LivenessChecker.h"
 #include "landmark_extractor.h"
+#include "LandmarkTracker.h"
 #include "Types.h"
 
 class WebRTCManager {
 public:
-    WebRTCManager();
+    // The stream's settings (models, liveness thresholds, tracking) are
+    // applied over `base`.
+    explicit WebRTCManager(const neptune::NeptuneConfig& base = neptune::NeptuneConfig());
     ~WebRTCManager();
 
     // Start the WebRTC server and wait for a connection
@@ -20,13 +23,21 @@ public:
     void onFrameReceived(cv::Mat &frame);
     void testWithLocalWebcam(); // Add this declaration
 
+    const neptune::NeptuneConfig& configuration() const { return config; }
+    const neptune::LivenessChecker& livenessChecker() const { return liveness; }
+
 private:
+    static neptune::NeptuneConfig streamConfig(neptune::NeptuneConfig config);
+
+    // Declared first: every member below is built from it.
+    neptune::NeptuneConfig config;
+
     // Your AI objects from main.cpp
     std::unique_ptr<neptune::FaceDetector> detector;
     std::unique_ptr<neptune::EmotionRecognizer> emo;
     neptune::LivenessChecker liveness;
     LandmarkExtractor landmarkExtractor;
-    neptune::NeptuneConfig config;
+    std::unique_ptr<neptune::LandmarkTracker> tracker;   // follows faces between frames
 
     // Helper functions from your main.cpp
     std::string emotionToString(neptune::Emotion e);
@@ -0,0 +1,46 @@
+//
+// File: NeptuneFacialSDK/core/include/neptune/WorkerPool.h
+//
+// A fixed set of threads running posted tasks in FIFO order. The threads are
+// started once and live as long as the pool, so per-frame work does not pay
+// for thread creation.
+//
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace neptune {
+
+class WorkerPool {
+public:
+    // Starts `threads` workers (none when threads <= 0).
+    explicit WorkerPool(int threads);
+
+    // Runs the tasks still queued, then joins the workers.
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    // Queues a task for the next free worker. Tasks must not throw.
+    void post(std::function<void()> task);
+
+    int size() const { return static_cast<int>(threads_.size()); }
+
+private:
+    void run();
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::deque<std::function<void()>> tasks_;
+    bool stopping_ = false;
+    std::vector<std::thread> threads_;
+};
+
+} // namespace neptune
@@ -0,0 +1,90 @@
+//
+// File: NeptuneFacialSDK/core/include/neptune/YuvFrame.h
+//
+// Non-owning view of a YUV 4:2:0 camera frame (NV12, NV21 or I420) with
+// per-plane strides, as delivered by mobile camera APIs and capture cards.
+// The SDK samples it directly when filling model inputs, so callers do not
+// have to convert whole frames to BGR first.
+//
+
+#pragma once
+
+#include <opencv2/core.hpp>
+
+#include <cstdint>
+
+namespace neptune {
+
+enum class YuvFormat {
+    NV12 = 0,   // Y plane, then interleaved U,V plane
+    NV21 = 1,   // Y plane, then interleaved V,U plane (Android camera default)
+    I420 = 2    // Y plane, U plane, V plane
+};
+
+/**
+ * @struct YuvFrame
+ * @brief Planes of one 4:2:0 frame. Colors follow BT.601 limited range,
+ *        like cv::COLOR_YUV2BGR_NV12 and friends.
+ *
+ * Width and height must be even. Chroma planes are (width/2) x (height/2)
+ * samples; for NV12/NV21 `u` points at the interleaved chroma plane and `v`
+ * is unused. The memory must stay valid while the SDK call runs.
+ */
+struct YuvFrame {
+    YuvFormat format = YuvFormat::NV12;
+    int width = 0;
+    int height = 0;
+    const uint8_t* y = nullptr;
+    int yStride = 0;             // bytes between luma rows
+    const uint8_t* u = nullptr;
+    int uStride = 0;             // bytes between chroma rows of `u`
+    const uint8_t* v = nullptr;
+    int vStride = 0;             // I420 only
+
+    static YuvFrame nv12(const uint8_t* y, int yStride, const uint8_t* uv, int uvStride, int width, int height) {
+        return semiPlanar(YuvFormat::NV12, y, yStride, uv, uvStride, width, height);
+    }
+
+    static YuvFrame nv21(const uint8_t* y, int yStride, const uint8_t* vu, int vuStride, int width, int height) {
+        return semiPlanar(YuvFormat::NV21, y, yStride, vu, vuStride, width, height);
+    }
+
+    static YuvFrame i420(const uint8_t* y, int yStride, const uint8_t* u, int uStride,
+                         const uint8_t* v, int vStride, int width, int height) {
+        YuvFrame frame = semiPlanar(YuvFormat::I420, y, yStride, u, uStride, width, height);
+        frame.v = v;
+        frame.vStride = vStride;
+        return frame;
+    }
+
+    bool empty() const { return width <= 0 || height <= 0 || y == nullptr; }
+
+    // Planes present for the format, even dimensions and strides that fit.
+    bool valid() const {
+        if (empty() || u == nullptr || width % 2 != 0 || height % 2 != 0 || yStride < width) return false;
+        if (format == YuvFormat::I420) return v != nullptr && uStride >= width / 2 && vStride >= width / 2;
+        return uStride >= width;
+    }
+
+    cv::Size size() const { return cv::Size(width, height); }
+
+    // Full-frame BGR copy, for display or code that still needs a cv::Mat.
+    // The SDK's own inference paths never call it.
+    cv::Mat toBgr() const;
+
+private:
+    static YuvFrame semiPlanar(YuvFormat format, const uint8_t* y, int yStride, const uint8_t* uv, int uvStride,
+                               int width, int height) {
+        YuvFrame frame;
+        frame.format = format;
+        frame.width = width;
+        frame.height = height;
+        frame.y = y;
+        frame.yStride = yStride;
+        frame.u = uv;
+        frame.uStride = uvStride;
+        return frame;
+    }
+};
+
+} // namespace neptune
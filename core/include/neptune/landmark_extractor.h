@@ -2,25 +2,105 @@
 
 #pragma once
 #include <opencv2/opencv.hpp>
-#include <tensorflow/lite/interpreter.h>
-#include <tensorflow/lite/model.h>
 #include <memory>
 #include <vector>
+#include "neptune/TfLiteEngine.h"
+#include "neptune/InterpreterPool.h"
 #include "neptune/Types.h"
+#include "neptune/YuvFrame.h"
 
 class LandmarkExtractor {
 public:
-    LandmarkExtractor(const std::string& modelPath);
+    // modelPath may be a file path or "embedded:<name>" (see EmbeddedModels.h)
+    LandmarkExtractor(const std::string& modelPath,
+                      const neptune::NeptuneConfig& config = neptune::NeptuneConfig());
     ~LandmarkExtractor() = default;
 
     // Extract landmarks for a face ROI (faceRect is relative to full image)
     std::vector<neptune::Point> Process(const cv::Mat& image, const cv::Rect& faceRect);
+    std::vector<neptune::Point> Process(const neptune::YuvFrame& frame, const cv::Rect& faceRect);
+
+    // Extract landmarks for a detected face. The crop is square, scaled by
+    // NeptuneConfig::landmarkRoiScale and, with alignFaceCrops, rotated so the
+    // face's eye keypoints are level; landmarks come back in image coordinates.
+    std::vector<neptune::Point> Process(const cv::Mat& image, const neptune::FaceBox& face);
+    std::vector<neptune::Point> Process(const neptune::YuvFrame& frame, const neptune::FaceBox& face);
+
+    // Extract landmarks for several faces of the same image in one invoke.
+    // Results are in faceRects order; falls back to Process() per face if the
+    // model cannot be batched.
+    std::vector<std::vector<neptune::Point>> processBatch(const cv::Mat& image,
+                                                          const std::vector<cv::Rect>& faceRects);
+
+    // YUV camera frames: only the face crops are color-converted, during resize.
+    std::vector<std::vector<neptune::Point>> processBatch(const neptune::YuvFrame& frame,
+                                                          const std::vector<cv::Rect>& faceRects);
+
+    // Batched Process(image, face).
+    std::vector<std::vector<neptune::Point>> processBatch(const cv::Mat& image,
+                                                          const std::vector<neptune::FaceBox>& faces);
+    std::vector<std::vector<neptune::Point>> processBatch(const neptune::YuvFrame& frame,
+                                                          const std::vector<neptune::FaceBox>& faces);
+
+    // Landmarks for crop ROIs given directly, e.g. tracked from the previous
+    // frame's landmarks (Preprocess::landmarksRoi), in one invoke. presence[i]
+    // receives the model's face-presence probability for ROI i: 1 for models
+    // without a face flag output, 0 for an empty ROI or a failed run.
+    std::vector<std::vector<neptune::Point>> processRois(const cv::Mat& image,
+                                                         const std::vector<neptune::NormalizedRect>& rois,
+                                                         std::vector<float>& presence);
+    std::vector<std::vector<neptune::Point>> processRois(const neptune::YuvFrame& frame,
+                                                         const std::vector<neptune::NormalizedRect>& rois,
+                                                         std::vector<float>& presence);
+
+    // False if the model failed to load; every call then returns no landmarks.
+    bool isLoaded() const { return pool != nullptr; }
+
+    // Backend the landmark model ended up running on.
+    neptune::InferenceBackend backend() const {
+        return pool ? pool->backend() : neptune::InferenceBackend::BUILTIN;
+    }
+
+    // Load/allocate/warm-up timings of the landmark model.
+    neptune::ModelStartupTiming startupTiming() const {
+        return pool ? pool->startupTiming() : neptune::ModelStartupTiming();
+    }
 
 private:
-    std::unique_ptr<tflite::Interpreter> interpreter;
-    std::unique_ptr<tflite::FlatBufferModel> model;
+    // Crop ROIs; an empty NormalizedRect marks a face that is skipped
+    neptune::NormalizedRect rectRoi(const cv::Rect& faceRect, const cv::Size& imageSize) const;
+    neptune::NormalizedRect faceRoi(const neptune::FaceBox& face, const cv::Size& imageSize) const;
+    std::vector<neptune::NormalizedRect> rectRois(const std::vector<cv::Rect>& faceRects,
+                                                  const cv::Size& imageSize) const;
+    std::vector<neptune::NormalizedRect> faceRois(const std::vector<neptune::FaceBox>& faces,
+                                                  const cv::Size& imageSize) const;
+
+    // Image is cv::Mat (BGR) or neptune::YuvFrame
+    template <typename Image>
+    std::vector<neptune::Point> processOne(const Image& image, const neptune::NormalizedRect& roi);
+    // presence, when given, receives one face-presence probability per ROI
+    template <typename Image>
+    std::vector<std::vector<neptune::Point>> processFaces(const Image& image,
+                                                          const std::vector<neptune::NormalizedRect>& rois,
+                                                          std::vector<float>* presence = nullptr);
+    template <typename Image>
+    std::vector<neptune::Point> processWith(neptune::TfLiteEngine& engine, const Image& image,
+                                            const neptune::NormalizedRect& roi, float* presence = nullptr) const;
+    template <typename Image>
+    bool preprocessInto(const Image& image, const neptune::NormalizedRect& roi,
+                        const neptune::InputTensorView& input, cv::Matx23f& tensorToImage) const;
+    // Sigmoid of the face flag output for batch item `index`; 1 if the model has none
+    float decodePresence(const neptune::TfLiteEngine& engine, int index, int batch) const;
+    void decodeLandmarks(const neptune::OutputTensorView& output, int numLandmarks,
+                         const cv::Matx23f& tensorToImage, const cv::Size& imageSize,
+                         std::vector<neptune::Point>& landmarks) const;
+
+    // Interpreters for the landmark model; Process/processBatch lease one per call
+    std::unique_ptr<neptune::InterpreterPool> pool;
     int inputWidth = 0;
     int inputHeight = 0;
+    float roiScale = 1.5f;
+    bool alignCrops = true;
 };
 
 
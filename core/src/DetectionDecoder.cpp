@@ -0,0 +1,365 @@
+//
+// File: NeptuneFacialSDK/core/src/DetectionDecoder.cpp
+//
+// Anchor generation and output decoding for the MediaPipe face detectors.
+// The per-anchor work is a compare against the logit threshold; only the
+// few surviving anchors are decoded, four coordinates per SIMD operation.
+// Anchors and box coding follow MediaPipe's SsdAnchorsCalculator and
+// TensorsToDetectionsCalculator for the same model options.
+//
+
+#include "neptune/DetectionDecoder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define NEPTUNE_DECODE_SSE2 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define NEPTUNE_DECODE_NEON 1
+#endif
+
+namespace neptune {
+
+namespace {
+
+constexpr int kValuesPerAnchor = 16;   // 4 box + 6 * 2 keypoint values
+
+inline float sigmoidf(float x) { return 1.0f / (1.0f + std::exp(-x)); }
+
+// Model input -> image mapping of the letterbox, replicated for (x, y, x, y)
+// lanes.
+struct Letterbox {
+    float dims[4];       // model input width/height
+    float pad[4];        // letterbox offset in model pixels
+    int padInt[4];
+    float maxCoord[4];   // image width - 1 / height - 1
+    float ratio;
+};
+
+// out = clamp((in * dims - pad) / ratio, 0, maxCoord), truncated. With
+// `snap`, in * dims is truncated to whole model pixels first (box corners).
+inline void toImage4(const float in[4], const Letterbox& lb, bool snap, int out[4]) {
+#if defined(NEPTUNE_DECODE_SSE2)
+    const __m128 scaled = _mm_mul_ps(_mm_loadu_ps(in), _mm_loadu_ps(lb.dims));
+    const __m128 shifted = snap
+        ? _mm_cvtepi32_ps(_mm_sub_epi32(_mm_cvttps_epi32(scaled),
+                                        _mm_loadu_si128(reinterpret_cast<const __m128i*>(lb.padInt))))
+        : _mm_sub_ps(scaled, _mm_loadu_ps(lb.pad));
+    __m128 image = _mm_div_ps(shifted, _mm_set1_ps(lb.ratio));
+    image = _mm_min_ps(_mm_max_ps(image, _mm_setzero_ps()), _mm_loadu_ps(lb.maxCoord));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_cvttps_epi32(image));
+#elif defined(NEPTUNE_DECODE_NEON)
+    const float32x4_t scaled = vmulq_f32(vld1q_f32(in), vld1q_f32(lb.dims));
+    const float32x4_t shifted = snap
+        ? vcvtq_f32_s32(vsubq_s32(vcvtq_s32_f32(scaled), vld1q_s32(lb.padInt)))
+        : vsubq_f32(scaled, vld1q_f32(lb.pad));
+    float32x4_t image = vdivq_f32(shifted, vdupq_n_f32(lb.ratio));
+    image = vminq_f32(vmaxq_f32(image, vdupq_n_f32(0.0f)), vld1q_f32(lb.maxCoord));
+    vst1q_s32(out, vcvtq_s32_f32(image));
+#else
+    for (int i = 0; i < 4; ++i) {
+        const float scaled = in[i] * lb.dims[i];
+        const float shifted = snap ? static_cast<float>(static_cast<int>(scaled) - lb.padInt[i]) : scaled - lb.pad[i];
+        out[i] = static_cast<int>(std::min(std::max(shifted / lb.ratio, 0.0f), lb.maxCoord[i]));
+    }
+#endif
+}
+
+// out = (in / scale) * anchorSize + anchorCenter for (x, y, x, y) lanes:
+// keypoint regressions to normalized model coordinates.
+inline void anchorOffset4(const float in[4], const float scale[4], const float size[4], const float center[4],
+                          float out[4]) {
+#if defined(NEPTUNE_DECODE_SSE2)
+    const __m128 v = _mm_mul_ps(_mm_div_ps(_mm_loadu_ps(in), _mm_loadu_ps(scale)), _mm_loadu_ps(size));
+    _mm_storeu_ps(out, _mm_add_ps(v, _mm_loadu_ps(center)));
+#elif defined(NEPTUNE_DECODE_NEON)
+    const float32x4_t v = vmulq_f32(vdivq_f32(vld1q_f32(in), vld1q_f32(scale)), vld1q_f32(size));
+    vst1q_f32(out, vaddq_f32(v, vld1q_f32(center)));
+#else
+    for (int i = 0; i < 4; ++i) out[i] = in[i] / scale[i] * size[i] + center[i];
+#endif
+}
+
+// Indices of the float logits >= threshold.
+void collectSurvivors(const float* logits, int n, float threshold, std::vector<int>& survivors) {
+    int i = 0;
+#if defined(NEPTUNE_DECODE_SSE2)
+    const __m128 t = _mm_set1_ps(threshold);
+    for (; i + 4 <= n; i += 4) {
+        const int mask = _mm_movemask_ps(_mm_cmpge_ps(_mm_loadu_ps(logits + i), t));
+        if (mask == 0) continue;
+        for (int lane = 0; lane < 4; ++lane) {
+            if (mask & (1 << lane)) survivors.push_back(i + lane);
+        }
+    }
+#elif defined(NEPTUNE_DECODE_NEON)
+    const float32x4_t t = vdupq_n_f32(threshold);
+    for (; i + 4 <= n; i += 4) {
+        if (vmaxvq_u32(vcgeq_f32(vld1q_f32(logits + i), t)) == 0) continue;
+        for (int lane = 0; lane < 4; ++lane) {
+            if (logits[i + lane] >= threshold) survivors.push_back(i + lane);
+        }
+    }
+#endif
+    for (; i < n; ++i) {
+        if (logits[i] >= threshold) survivors.push_back(i);
+    }
+}
+
+// Same for quantized logits, compared as integers: real >= threshold
+// exactly when q >= zeroPoint + threshold / scale.
+template <typename Q>
+void collectQuantizedSurvivors(const Q* logits, int n, float threshold, float scale, int32_t zeroPoint,
+                               std::vector<int>& survivors) {
+    const double bound = std::ceil(zeroPoint + static_cast<double>(threshold) / scale);
+    if (bound > std::numeric_limits<Q>::max()) return;
+    const int32_t qMin = static_cast<int32_t>(std::max<double>(bound, std::numeric_limits<Q>::min()));
+    for (int i = 0; i < n; ++i) {
+        if (static_cast<int32_t>(logits[i]) >= qMin) survivors.push_back(i);
+    }
+}
+
+// Anchor scale of layer `index` out of `count` (SsdAnchorsCalculator).
+float layerScale(const DetectorSpec& spec, int index, int count) {
+    if (count == 1) return 0.5f * (spec.minScale + spec.maxScale);
+    return spec.minScale + (spec.maxScale - spec.minScale) * index / (count - 1);
+}
+
+int featureMapSize(int input, int stride) {
+    return static_cast<int>(std::ceil(static_cast<float>(input) / stride));
+}
+
+} // namespace
+
+DetectorSpec DetectorSpec::shortRange() {
+    return DetectorSpec();
+}
+
+DetectorSpec DetectorSpec::fullRange() {
+    DetectorSpec spec;
+    spec.inputWidth = 192;
+    spec.inputHeight = 192;
+    spec.strides = {4};
+    spec.interpolatedScale = false;
+    spec.boxScale = 192.0f;
+    return spec;
+}
+
+bool DetectorSpec::forInputSize(int width, int height, DetectorSpec& spec) {
+    for (const DetectorSpec& known : {shortRange(), fullRange()}) {
+        if (known.inputWidth == width && known.inputHeight == height) {
+            spec = known;
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t DetectorSpec::anchorCount() const {
+    if (inputWidth <= 0 || inputHeight <= 0) return 0;
+    size_t count = 0;
+    for (int stride : strides) {
+        if (stride <= 0) return 0;
+        const size_t perCell = interpolatedScale ? 2 : 1;
+        count += perCell * featureMapSize(inputWidth, stride) * featureMapSize(inputHeight, stride);
+    }
+    return count;
+}
+
+std::vector<cv::Rect> detectionTiles(const cv::Size& imageSize, int tileSize, float overlap, int maxTiles,
+                                     int minTileSize) {
+    std::vector<cv::Rect> tiles;
+    if (imageSize.width <= 0 || imageSize.height <= 0) return tiles;
+    overlap = std::clamp(overlap, 0.0f, 0.9f);
+
+    // Tiles of side `side` needed along `extent`.
+    const auto tilesAlong = [overlap](int extent, int side) {
+        if (side >= extent) return 1;
+        const float step = side * (1.0f - overlap);
+        return 1 + static_cast<int>(std::ceil((extent - side) / step - 1e-3f));
+    };
+
+    int side = tileSize;
+    if (side <= 0) {
+        // n tiles overlapping by `overlap` span extent / (n - (n - 1) * overlap) each.
+        side = std::numeric_limits<int>::max();
+        int best = 0;
+        for (int cols = 1; cols <= maxTiles; ++cols) {
+            for (int rows = 1; cols * rows <= maxTiles; ++rows) {
+                const float w = imageSize.width / (cols - (cols - 1) * overlap);
+                const float h = imageSize.height / (rows - (rows - 1) * overlap);
+                const int s = std::max(static_cast<int>(std::ceil(std::max(w, h))), minTileSize);
+                if (s < side || (s == side && cols * rows < best)) {
+                    side = s;
+                    best = cols * rows;
+                }
+            }
+        }
+        if (best == 0) return tiles;
+    }
+
+    const int cols = tilesAlong(imageSize.width, side);
+    const int rows = tilesAlong(imageSize.height, side);
+    if (cols * rows <= 1) return tiles;
+
+    // Spread evenly, first and last tile flush with the frame edges.
+    const int tileW = std::min(side, imageSize.width);
+    const int tileH = std::min(side, imageSize.height);
+    tiles.reserve(static_cast<size_t>(cols) * rows);
+    for (int r = 0; r < rows; ++r) {
+        const int y = rows == 1 ? 0 : static_cast<int>(std::lround(static_cast<double>(r) * (imageSize.height - tileH) / (rows - 1)));
+        for (int c = 0; c < cols; ++c) {
+            const int x = cols == 1 ? 0 : static_cast<int>(std::lround(static_cast<double>(c) * (imageSize.width - tileW) / (cols - 1)));
+            tiles.emplace_back(x, y, tileW, tileH);
+        }
+    }
+    return tiles;
+}
+
+DetectionDecoder::DetectionDecoder(const DetectorSpec& spec, float minConfidence)
+    : spec_(spec) {
+    // sigmoid(x) >= p  <=>  x >= log(p / (1 - p))
+    if (minConfidence <= 0.0f) minLogit_ = -std::numeric_limits<float>::infinity();
+    else if (minConfidence >= 1.0f) minLogit_ = std::numeric_limits<float>::infinity();
+    else minLogit_ = std::log(minConfidence / (1.0f - minConfidence));
+
+    const size_t count = spec.anchorCount();
+    if (count == 0) return;
+    xCenter_.reserve(count);
+    yCenter_.reserve(count);
+    width_.reserve(count);
+    height_.reserve(count);
+
+    // Consecutive layers with the same stride share one feature map; its
+    // cells hold the anchors of all of them, in layer order.
+    const int numLayers = static_cast<int>(spec.strides.size());
+    std::vector<float> sizes;
+    for (int layer = 0; layer < numLayers;) {
+        const int stride = spec.strides[layer];
+        sizes.clear();
+        int last = layer;
+        for (; last < numLayers && spec.strides[last] == stride; ++last) {
+            const float scale = layerScale(spec, last, numLayers);
+            sizes.push_back(scale);
+            if (spec.interpolatedScale) {
+                const float next = (last == numLayers - 1) ? 1.0f : layerScale(spec, last + 1, numLayers);
+                sizes.push_back(std::sqrt(scale * next));
+            }
+        }
+
+        const int fmWidth = featureMapSize(spec.inputWidth, stride);
+        const int fmHeight = featureMapSize(spec.inputHeight, stride);
+        for (int y = 0; y < fmHeight; ++y) {
+            for (int x = 0; x < fmWidth; ++x) {
+                const float cx = (x + spec.anchorOffsetX) / fmWidth;
+                const float cy = (y + spec.anchorOffsetY) / fmHeight;
+                for (float size : sizes) {
+                    xCenter_.push_back(cx);
+                    yCenter_.push_back(cy);
+                    width_.push_back(spec.fixedAnchorSize ? 1.0f : size);
+                    height_.push_back(spec.fixedAnchorSize ? 1.0f : size);
+                }
+            }
+        }
+        layer = last;
+    }
+}
+
+void DetectionDecoder::decode(const OutputTensorView& boxes, const OutputTensorView& scores,
+                              const cv::Size& imageSize, std::vector<FaceDetection>& out) const {
+    if (scores.empty() || boxes.empty() || imageSize.width <= 0 || imageSize.height <= 0) return;
+    const int n = static_cast<int>(scores.size);
+
+    thread_local std::vector<int> survivors;
+    survivors.clear();
+    switch (scores.type) {
+        case TensorType::FLOAT32:
+            collectSurvivors(static_cast<const float*>(scores.data), n, minLogit_, survivors);
+            break;
+        case TensorType::UINT8:
+            collectQuantizedSurvivors(static_cast<const uint8_t*>(scores.data), n, minLogit_, scores.scale,
+                                      scores.zeroPoint, survivors);
+            break;
+        case TensorType::INT8:
+            collectQuantizedSurvivors(static_cast<const int8_t*>(scores.data), n, minLogit_, scores.scale,
+                                      scores.zeroPoint, survivors);
+            break;
+        default:
+            return;
+    }
+    if (survivors.empty()) return;
+
+    const float inW = static_cast<float>(spec_.inputWidth);
+    const float inH = static_cast<float>(spec_.inputHeight);
+    const float ratio = std::min(inW / imageSize.width, inH / imageSize.height);
+    const int padX = static_cast<int>((inW - imageSize.width * ratio) * 0.5f);
+    const int padY = static_cast<int>((inH - imageSize.height * ratio) * 0.5f);
+    const float boxScale = spec_.boxScale;
+    const float scale4[4] = {boxScale, boxScale, boxScale, boxScale};
+    const float maxX = static_cast<float>(imageSize.width - 1);
+    const float maxY = static_cast<float>(imageSize.height - 1);
+    const Letterbox lb = {{inW, inH, inW, inH},
+                          {static_cast<float>(padX), static_cast<float>(padY),
+                           static_cast<float>(padX), static_cast<float>(padY)},
+                          {padX, padY, padX, padY},
+                          {maxX, maxY, maxX, maxY},
+                          ratio};
+
+    const float* floatBoxes = boxes.type == TensorType::FLOAT32 ? static_cast<const float*>(boxes.data) : nullptr;
+    const int anchors = static_cast<int>(anchorCount());
+    float dequantized[kValuesPerAnchor];
+
+    for (int i : survivors) {
+        const size_t off = static_cast<size_t>(i) * kValuesPerAnchor;
+        if (off + kValuesPerAnchor > boxes.size) break;
+
+        const float* raw = floatBoxes ? floatBoxes + off : dequantized;
+        if (!floatBoxes) {
+            for (int k = 0; k < kValuesPerAnchor; ++k) dequantized[k] = boxes[off + k];
+        }
+
+        // Models with more outputs than anchors decode against the whole input.
+        const bool known = i < anchors;
+        const float ax = known ? xCenter_[i] : 0.5f;
+        const float ay = known ? yCenter_[i] : 0.5f;
+        const float aw = known ? width_[i] : 1.0f;
+        const float ah = known ? height_[i] : 1.0f;
+
+        // Box regression is (x, y, w, h) relative to the anchor.
+        const float xCenter = ax + raw[0] / boxScale * aw;
+        const float yCenter = ay + raw[1] / boxScale * ah;
+        const float wNorm = raw[2] / boxScale * aw;
+        const float hNorm = raw[3] / boxScale * ah;
+        const float corners[4] = {std::clamp(xCenter - 0.5f * wNorm, 0.0f, 1.0f),
+                                  std::clamp(yCenter - 0.5f * hNorm, 0.0f, 1.0f),
+                                  std::clamp(xCenter + 0.5f * wNorm, 0.0f, 1.0f),
+                                  std::clamp(yCenter + 0.5f * hNorm, 0.0f, 1.0f)};
+        int box[4];
+        toImage4(corners, lb, true, box);
+        if (box[2] <= box[0] || box[3] <= box[1]) continue;
+
+        FaceDetection& det = out.emplace_back();
+        det.score = sigmoidf(scores[i]);
+        det.x1 = box[0];
+        det.y1 = box[1];
+        det.x2 = box[2];
+        det.y2 = box[3];
+
+        // Keypoints are (x, y) pairs relative to the anchor, two per lane group.
+        const float size[4] = {aw, ah, aw, ah};
+        const float center[4] = {ax, ay, ax, ay};
+        for (int k = 0; k < FaceDetection::kKeypoints * 2; k += 4) {
+            float normalized[4];
+            int pixels[4];
+            anchorOffset4(raw + 4 + k, scale4, size, center, normalized);
+            toImage4(normalized, lb, false, pixels);
+            for (int j = 0; j < 4; ++j) det.keypoints[k + j] = static_cast<float>(pixels[j]);
+        }
+    }
+}
+
+} // namespace neptune
@@ -2,6 +2,7 @@
 #include "neptune/EmotionRecognizer.h"
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <limits>
 #include <string>
 
@@ -12,55 +13,57 @@ const std::vector<std::string> EMOTION_LABELS = {
     "Anger", "Disgust", "Fear", "Happiness", "Sadness", "Surprise", "Neutral"
 };
 EmotionRecognizer::EmotionRecognizer(const NeptuneConfig& config)
-    : inputWidth_(0), inputHeight_(0), minConfidence_(config.minEmotionConfidence) {}
+    : engineOptions_(EngineOptions::fromConfig(config)),
+      poolSize_(config.interpreterPoolSize),
+      poolPolicy_(config.blockWhenPoolBusy ? PoolAcquirePolicy::BLOCK : PoolAcquirePolicy::TRY),
+      inputWidth_(0), inputHeight_(0), minConfidence_(config.minEmotionConfidence),
+      roiScale_(config.emotionRoiScale), alignCrops_(config.alignFaceCrops) {}
 
 std::unique_ptr<EmotionRecognizer> EmotionRecognizer::create(const std::string& modelPath,
                                                              const NeptuneConfig& config) {
     auto recognizer = std::unique_ptr<EmotionRecognizer>(new EmotionRecognizer(config));
     if (!recognizer->init(modelPath)) {
-        Log::error("EmotionRecognizer", "Failed to initialize with model: " + modelPath);
+        NEPTUNE_LOG_ERROR("EmotionRecognizer", "Failed to initialize with model: " << modelPath);
         return nullptr;
     }
     return recognizer;
 }
 
 bool EmotionRecognizer::init(const std::string& modelPath) {
-    engine_ = std::make_unique<TfLiteEngine>();
+    pool_ = InterpreterPool::create(modelPath, engineOptions_, poolSize_, poolPolicy_);
 
-    if (!engine_->loadModel(modelPath)) {
-        Log::error("EmotionRecognizer", "Failed to load TFLite model: " + modelPath);
+    if (!pool_) {
+        NEPTUNE_LOG_ERROR("EmotionRecognizer", "Failed to load TFLite model: " << modelPath);
         return false;
     }
 
-    inputWidth_  = engine_->inputWidth();
-    inputHeight_ = engine_->inputHeight();
+    inputWidth_  = pool_->inputWidth();
+    inputHeight_ = pool_->inputHeight();
 
-    Log::info("EmotionRecognizer", "Model expects input: " +
-        std::to_string(inputWidth_) + "x" + std::to_string(inputHeight_));
+    NEPTUNE_LOG_INFO("EmotionRecognizer", "Model expects input: " << inputWidth_ << "x" << inputHeight_);
 
     if (inputWidth_ == 0 || inputHeight_ == 0) {
-        Log::error("EmotionRecognizer", "Engine failed to get valid input dimensions from the model.");
+        NEPTUNE_LOG_ERROR("EmotionRecognizer", "Engine failed to get valid input dimensions from the model.");
         return false;
     }
 
-    Log::info("EmotionRecognizer", "Number of output tensors: " +
-        std::to_string(engine_->getNumOutputs()));
+    InterpreterPool::Lease engine = pool_->acquire();
+    NEPTUNE_LOG_INFO("EmotionRecognizer", "Number of output tensors: " << engine->getNumOutputs());
 
-    for (int i = 0; i < engine_->getNumOutputs(); ++i) {
-        const auto shape = engine_->getOutputTensorShape(i);
+    for (int i = 0; i < engine->getNumOutputs(); ++i) {
+        const auto shape = engine->getOutputTensorShape(i);
         std::string s = "[";
         for (size_t j = 0; j < shape.size(); ++j) {
             s += std::to_string(shape[j]);
             if (j + 1 < shape.size()) s += ", ";
         }
         s += "]";
-        Log::info("EmotionRecognizer", "Output " + std::to_string(i) + " shape: " + s);
+        NEPTUNE_LOG_INFO("EmotionRecognizer", "Output " << i << " shape: " << s);
 
         if (shape.size() == 2 && shape[1] > 0) {
             numClasses_ = static_cast<int>(shape[1]);
             if (numClasses_ != EMOTION_LABELS.size()) {
-                Log::error("EmotionRecognizer", "Model output size (" + std::to_string(numClasses_) +
-                            ") does not match expected labels size (" + std::to_string(EMOTION_LABELS.size()) + ").");
+                NEPTUNE_LOG_ERROR("EmotionRecognizer", "Model output size (" << numClasses_ << ") does not match expected labels size (" << EMOTION_LABELS.size() << ").");
             }
         }
     }
@@ -68,25 +71,26 @@ bool EmotionRecognizer::init(const std::string& modelPath) {
     return true;
 }
 
-std::vector<float> EmotionRecognizer::softmax(const std::vector<float>& logits) {
-    std::vector<float> out(logits.size());
-    if (logits.empty()) return out;
+void EmotionRecognizer::softmax(const OutputTensorView& logits, std::vector<float>& out) {
+    out.resize(logits.size);
+    if (logits.empty()) return;
 
-    float maxv = *std::max_element(logits.begin(), logits.end());
+    // Dequantize once into the scratch buffer, then normalize in place.
+    for (size_t i = 0; i < logits.size; ++i) out[i] = logits[i];
+    float maxv = *std::max_element(out.begin(), out.end());
     double sum = 0.0;
-    for (size_t i = 0; i < logits.size(); ++i) {
-        out[i] = std::exp(static_cast<double>(logits[i] - maxv));
+    for (size_t i = 0; i < logits.size; ++i) {
+        out[i] = std::exp(static_cast<double>(out[i] - maxv));
         sum += out[i];
     }
     if (sum <= std::numeric_limits<double>::min()) {
-        float u = 1.0f / static_cast<float>(logits.size());
+        float u = 1.0f / static_cast<float>(logits.size);
         std::fill(out.begin(), out.end(), u);
-        return out;
+        return;
     }
-    for (size_t i = 0; i < logits.size(); ++i) {
+    for (size_t i = 0; i < logits.size; ++i) {
         out[i] = static_cast<float>(out[i] / sum);
     }
-    return out;
 }
 
 // Maps index to enum
@@ -108,42 +112,176 @@ Emotion EmotionRecognizer::indexToEmotion(int idx) {
 
 
 EmotionResult EmotionRecognizer::predictEmotion(const cv::Mat& faceImage) {
+    if (!pool_ || numClasses_ < 0) {
+        NEPTUNE_LOG_ERROR("EmotionRecognizer", "Engine not initialized or number of classes not set.");
+        return EmotionResult{Emotion::UNKNOWN, 0.0f};
+    }
+    InterpreterPool::Lease engine = pool_->acquire();
+    if (!engine) {
+        NEPTUNE_LOG_WARN("EmotionRecognizer", "All interpreters busy, skipping face");
+        return EmotionResult{Emotion::UNKNOWN, 0.0f};
+    }
+    return predictWith(*engine, faceImage,
+                       img::Preprocess::rectRoi(cv::Rect(0, 0, faceImage.cols, faceImage.rows), faceImage.size()));
+}
+
+template <typename Image>
+EmotionResult EmotionRecognizer::predictWith(TfLiteEngine& engine, const Image& image,
+                                             const NormalizedRect& roi) const {
     EmotionResult result{Emotion::UNKNOWN, 0.0f};
 
-    if (!engine_ || numClasses_ < 0) {
-        Log::error("EmotionRecognizer", "Engine not initialized or number of classes not set.");
+    if (image.empty()) {
+        NEPTUNE_LOG_ERROR("EmotionRecognizer", "Empty input image");
         return result;
     }
-    if (faceImage.empty()) {
-        Log::error("EmotionRecognizer", "Empty input image");
+    if (!engine.setBatchSize(1)) {
+        NEPTUNE_LOG_ERROR("EmotionRecognizer", "Failed to select batch size 1: " << engine.getLastError());
         return result;
     }
 
     // --- Preprocess ---
-    cv::Mat resized = neptune::img::Preprocess::resize(faceImage, inputWidth_, inputHeight_);
-    
-    // --- ADD THIS LINE TO CONVERT FROM BGR to RGB ---
-    cv::cvtColor(resized, resized, cv::COLOR_BGR2RGB);
-
-    std::vector<float> inputTensor = neptune::img::Preprocess::normalize(resized);
-
-    if (!engine_->setInputTensor(inputTensor)) {
-        Log::error("EmotionRecognizer", "Failed to set input tensor");
+    InputTensorView input = engine.inputTensorView(0);
+    if (!preprocessInto(image, roi, input)) {
+        NEPTUNE_LOG_ERROR("EmotionRecognizer", "Failed to set input tensor");
         return result;
     }
-    if (!engine_->invoke()) {
-        Log::error("EmotionRecognizer", "Inference failed");
+    if (!engine.invoke()) {
+        NEPTUNE_LOG_ERROR("EmotionRecognizer", "Inference failed");
         return result;
     }
 
-    // --- Post-processing (looks correct) ---
-    auto output = engine_->getOutputTensor(0);
-    if (output.empty() || output.size() != numClasses_) {
-        Log::error("EmotionRecognizer", "Empty or unexpected size of output tensor.");
+    // --- Post-processing (reads the output tensor in place) ---
+    OutputTensorView output = engine.outputTensorView(0);
+    if (output.empty() || output.size != static_cast<size_t>(numClasses_)) {
+        NEPTUNE_LOG_ERROR("EmotionRecognizer", "Empty or unexpected size of output tensor.");
         return result;
     }
 
-    std::vector<float> probs = softmax(output);
+    return decode(output);
+}
+
+std::vector<EmotionResult> EmotionRecognizer::predictEmotions(const cv::Mat& image,
+                                                              const std::vector<cv::Rect>& faceRects) {
+    return predictBatch(image, rectRois(faceRects, image.size()));
+}
+
+std::vector<EmotionResult> EmotionRecognizer::predictEmotions(const YuvFrame& frame,
+                                                              const std::vector<cv::Rect>& faceRects) {
+    return predictBatch(frame, rectRois(faceRects, frame.size()));
+}
+
+std::vector<EmotionResult> EmotionRecognizer::predictEmotions(const cv::Mat& image,
+                                                              const std::vector<FaceBox>& faces) {
+    return predictBatch(image, faceRois(faces, image.size()));
+}
+
+std::vector<EmotionResult> EmotionRecognizer::predictEmotions(const YuvFrame& frame,
+                                                              const std::vector<FaceBox>& faces) {
+    return predictBatch(frame, faceRois(faces, frame.size()));
+}
+
+std::vector<NormalizedRect> EmotionRecognizer::rectRois(const std::vector<cv::Rect>& faceRects,
+                                                        const cv::Size& imageSize) {
+    // Rects are clipped to the image; an empty ROI marks a face to skip.
+    const cv::Rect bounds(cv::Point(), imageSize);
+    std::vector<NormalizedRect> rois;
+    rois.reserve(faceRects.size());
+    for (const auto& rect : faceRects) {
+        const cv::Rect roi = rect & bounds;
+        rois.push_back(roi.area() > 0 ? img::Preprocess::rectRoi(roi, imageSize) : NormalizedRect());
+    }
+    return rois;
+}
+
+std::vector<NormalizedRect> EmotionRecognizer::faceRois(const std::vector<FaceBox>& faces,
+                                                        const cv::Size& imageSize) const {
+    std::vector<NormalizedRect> rois;
+    rois.reserve(faces.size());
+    for (const auto& face : faces) {
+        rois.push_back(face.width > 0 && face.height > 0
+                           ? img::Preprocess::faceRoi(face, imageSize, roiScale_, /*square=*/false, alignCrops_)
+                           : NormalizedRect());
+    }
+    return rois;
+}
+
+template <typename Image>
+std::vector<EmotionResult> EmotionRecognizer::predictBatch(const Image& image,
+                                                           const std::vector<NormalizedRect>& rois) {
+    std::vector<EmotionResult> results(rois.size());
+    if (rois.empty()) return results;
+
+    if (!pool_ || numClasses_ < 0) {
+        NEPTUNE_LOG_ERROR("EmotionRecognizer", "Engine not initialized or number of classes not set.");
+        return results;
+    }
+    if (image.empty()) {
+        NEPTUNE_LOG_ERROR("EmotionRecognizer", "Empty input image");
+        return results;
+    }
+    InterpreterPool::Lease engine = pool_->acquire();
+    if (!engine) {
+        NEPTUNE_LOG_WARN("EmotionRecognizer", "All interpreters busy, skipping faces");
+        return results;
+    }
+
+    const int batch = static_cast<int>(rois.size());
+    auto usable = [&rois](int i) { return rois[i].width > 0.0f && rois[i].height > 0.0f; };
+
+    // A single face, or a model that cannot be batched, takes the per-face path.
+    if (batch == 1 || !engine->setBatchSize(batch)) {
+        for (int i = 0; i < batch; ++i) {
+            if (usable(i)) results[i] = predictWith(*engine, image, rois[i]);
+        }
+        return results;
+    }
+
+    InputTensorView input = engine->inputTensorView(0);
+    for (int i = 0; i < batch; ++i) {
+        InputTensorView item = input.slice(i);
+        if (usable(i)) {
+            if (!preprocessInto(image, rois[i], item)) {
+                NEPTUNE_LOG_ERROR("EmotionRecognizer", "Failed to set input tensor for face " << i);
+                return results;
+            }
+        } else if (item.valid()) {
+            // Keep the slot defined; its result is discarded below.
+            std::memset(item.data, 0, item.bytes);
+        }
+    }
+    if (!engine->invoke()) {
+        NEPTUNE_LOG_ERROR("EmotionRecognizer", "Batched inference failed");
+        return results;
+    }
+
+    OutputTensorView output = engine->outputTensorView(0);
+    if (output.size != static_cast<size_t>(numClasses_) * batch) {
+        NEPTUNE_LOG_ERROR("EmotionRecognizer", "Unexpected size of batched output tensor.");
+        return results;
+    }
+    for (int i = 0; i < batch; ++i) {
+        if (!usable(i)) continue;
+        results[i] = decode(output.slice(static_cast<size_t>(i) * numClasses_, numClasses_));
+    }
+    return results;
+}
+
+template <typename Image>
+bool EmotionRecognizer::preprocessInto(const Image& image, const NormalizedRect& roi,
+                                       const InputTensorView& input) const {
+    // The model was fed BGR->RGB followed by normalize()'s own BGR->RGB, i.e.
+    // the original BGR order. Keep that order without the two swaps.
+    // The (possibly rotated) ROI is letterboxed like the old resize().
+    return neptune::img::Preprocess::warpNormalizeInto(image, roi, input, /*swapRB=*/false, /*keepAspect=*/true);
+}
+
+EmotionResult EmotionRecognizer::decode(const OutputTensorView& logits) const {
+    EmotionResult result{Emotion::UNKNOWN, 0.0f};
+
+    // Per-thread scratch: concurrent callers never share it, and it stops
+    // allocating once it has grown to numClasses_.
+    thread_local std::vector<float> probs;
+    softmax(logits, probs);
 
     int best = static_cast<int>(std::distance(probs.begin(),
                         std::max_element(probs.begin(), probs.end())));
@@ -158,22 +296,15 @@ EmotionResult EmotionRecognizer::predictEmotion(const cv::Mat& faceImage) {
     result.emotion = indexToEmotion(best);
     result.confidence = conf;
 
-    // Debug log
-    std::string dbg = "Probabilities: ";
-    for (size_t i = 0; i < probs.size(); ++i) {
-        dbg += EMOTION_LABELS[i] + "=" + std::to_string(probs[i]) + " ";
+    // Per-face probability dump, only formatted when debug logging is on
+    if (Log::enabled(LogLevel::Debug)) {
+        Log::Line line(LogLevel::Debug, "EmotionRecognizer");
+        line.stream() << "Probabilities:";
+        for (size_t i = 0; i < probs.size(); ++i) {
+            line.stream() << ' ' << EMOTION_LABELS[i] << '=' << probs[i];
+        }
     }
-    Log::info("EmotionRecognizer", dbg);
 
     return result;
 }
-} // namespace neptune
-
-
-
-
-
-
-
-
-
+} // namespace neptune
\ No newline at end of file
@@ -1,227 +1,261 @@
 
 #include "neptune/FaceDetector.h"
 #include "neptune/Log.h"
+#include "neptune/NonMaxSuppression.h"
 #include "neptune/Preprocess.h"
 
 #include <opencv2/imgproc.hpp>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cmath>
+#include <condition_variable>
 #include <iostream>
+#include <mutex>
+#include <thread>
 
 namespace neptune {
 
-// Sigmoid helper
-static inline float sigmoidf(float x) { return 1.0f / (1.0f + std::exp(-x)); }
-
 // ------------------- Constructor / create / init -------------------
 FaceDetector::FaceDetector(const NeptuneConfig& config)
-    : inputWidth_(0), inputHeight_(0), minConfidence_(config.minFaceDetectionConfidence) {}
+    : engineOptions_(EngineOptions::fromConfig(config)),
+      poolSize_(config.interpreterPoolSize),
+      poolPolicy_(config.blockWhenPoolBusy ? PoolAcquirePolicy::BLOCK : PoolAcquirePolicy::TRY),
+      inputWidth_(0), inputHeight_(0), numOutputs_(0), minConfidence_(config.minFaceDetectionConfidence),
+      tiledDetection_(config.tiledDetection), tileSize_(config.detectionTileSize),
+      tileOverlap_(config.detectionTileOverlap),
+      detectionThreads_(config.detectionThreads > 0 ? config.detectionThreads
+                                                    : std::max(1, static_cast<int>(std::thread::hardware_concurrency()))),
+      nmsOptions_{config.weightedNms ? NmsMode::WEIGHTED : NmsMode::HARD, config.nmsIouThreshold, config.maxFaces} {
+    // Tiles already keep detectionThreads cores busy; intra-op threads on
+    // top of that would oversubscribe them.
+    if (tiledDetection_ && detectionThreads_ > 1) engineOptions_.numThreads = 1;
+}
 
 std::unique_ptr<FaceDetector> FaceDetector::create(const std::string& modelPath, const NeptuneConfig& config) {
     auto detector = std::unique_ptr<FaceDetector>(new FaceDetector(config));
     if (!detector->init(modelPath)) {
-        Log::error("FaceDetector", "Failed to initialize with model: " + modelPath);
+        NEPTUNE_LOG_ERROR("FaceDetector", "Failed to initialize with model: " << modelPath);
         return nullptr;
     }
     return detector;
 }
 
 bool FaceDetector::init(const std::string& modelPath) {
-    engine_ = std::make_unique<neptune::TfLiteEngine>();
-    if (!engine_->loadModel(modelPath)) {
-        Log::error("FaceDetector", "Failed to load TFLite model: " + modelPath);
+    // Tiles run concurrently within one call, each on its own interpreter.
+    const int maxInterpreters = tiledDetection_ ? std::max(poolSize_, detectionThreads_) : poolSize_;
+    pool_ = InterpreterPool::create(modelPath, engineOptions_, maxInterpreters, poolPolicy_);
+    if (!pool_) {
+        NEPTUNE_LOG_ERROR("FaceDetector", "Failed to load TFLite model: " << modelPath);
         return false;
     }
 
-    inputWidth_ = engine_->inputWidth();
-    inputHeight_ = engine_->inputHeight();
-
-    Log::info("FaceDetector", "Model expects input: " +
-              std::to_string(inputWidth_) + "x" + std::to_string(inputHeight_));
-
-    anchors_.clear();
-    return true;
-}
-
-// ------------------- Anchor generator -------------------
-std::vector<FaceDetector::Anchor> FaceDetector::generateAnchors(int input_width,
-                                                                int input_height,
-                                                                const std::vector<int>& strides,
-                                                                float min_scale,
-                                                                float max_scale,
-                                                                float anchor_offset_x,
-                                                                float anchor_offset_y) {
-    std::vector<Anchor> anchors;
-    int num_layers = static_cast<int>(strides.size());
-    if (num_layers <= 0) return anchors;
-
-    std::vector<float> scales(num_layers);
-    for (int i = 0; i < num_layers; ++i) {
-        scales[i] = (num_layers == 1) ? 0.5f * (min_scale + max_scale)
-                                      : min_scale + (max_scale - min_scale) * i / (num_layers - 1);
+    inputWidth_ = pool_->inputWidth();
+    inputHeight_ = pool_->inputHeight();
+    {
+        InterpreterPool::Lease engine = pool_->acquire();
+        if (!engine) return false;
+        numOutputs_ = engine->getNumOutputs();
     }
 
-    for (int layer = 0; layer < num_layers; ++layer) {
-        int stride = strides[layer];
-        int fm_w = static_cast<int>(std::ceil(static_cast<float>(input_width) / stride));
-        int fm_h = static_cast<int>(std::ceil(static_cast<float>(input_height) / stride));
-
-        float scale = scales[layer];
-        float scale_next = (layer == num_layers - 1) ? 1.0f : scales[layer + 1];
-        float scale_geom = std::sqrt(scale * scale_next);
+    NEPTUNE_LOG_INFO("FaceDetector", "Model expects input: " << inputWidth_ << "x" << inputHeight_);
 
-        for (int y = 0; y < fm_h; ++y) {
-            for (int x = 0; x < fm_w; ++x) {
-                float x_center = (x + anchor_offset_x) / fm_w;
-                float y_center = (y + anchor_offset_y) / fm_h;
+    // Generated once here so concurrent detectFaces() calls only read them.
+    DetectorSpec spec;
+    if (!DetectorSpec::forInputSize(inputWidth_, inputHeight_, spec)) {
+        NEPTUNE_LOG_WARN("FaceDetector", "No anchor layout known for " << inputWidth_ << "x" << inputHeight_
+                         << " input, using the short-range one");
+        spec.inputWidth = inputWidth_;
+        spec.inputHeight = inputHeight_;
+        spec.boxScale = static_cast<float>(inputWidth_);
+    }
+    decoder_ = DetectionDecoder(spec, minConfidence_);
+    NEPTUNE_LOG_INFO("FaceDetector", "Decoding " << decoder_.anchorCount() << " anchors");
 
-                anchors.push_back(Anchor{x_center, y_center, scale, scale});
-                anchors.push_back(Anchor{x_center, y_center, scale_geom, scale_geom});
-            }
-        }
+    if (tiledDetection_ && numOutputs_ != 2) {
+        NEPTUNE_LOG_WARN("FaceDetector", "Tiled detection needs a 2-output detector, disabled");
+        tiledDetection_ = false;
     }
-    return anchors;
+    if (tiledDetection_ && detectionThreads_ > 1) {
+        workers_ = std::make_unique<WorkerPool>(detectionThreads_ - 1);
+    }
+    return true;
 }
 
 // ------------------- Non-Max Suppression -------------------
-static float iouBox(const FaceBox& a, const FaceBox& b) {
-    int inter_w = std::max(0, std::min(a.x + a.width, b.x + b.width) - std::max(a.x, b.x));
-    int inter_h = std::max(0, std::min(a.y + a.height, b.y + b.height) - std::max(a.y, b.y));
-    float inter = static_cast<float>(inter_w) * inter_h;
-    float areaA = static_cast<float>(a.width) * a.height;
-    float areaB = static_cast<float>(b.width) * b.height;
-    return inter / (areaA + areaB - inter + 1e-6f);
+// Merges overlapping candidates and appends the kept faces to `out` as FaceBoxes.
+void FaceDetector::suppress(const std::vector<FaceDetection>& candidates, std::vector<FaceBox>& out) const {
+    thread_local std::vector<FaceDetection> kept;
+    kept.clear();
+    nonMaxSuppression(candidates, nmsOptions_, kept);
+
+    out.reserve(out.size() + kept.size());
+    for (const FaceDetection& d : kept) {
+        FaceBox& fb = out.emplace_back();
+        fb.x = d.x1; fb.y = d.y1; fb.width = d.width(); fb.height = d.height(); fb.confidence = d.score;
+        fb.landmarks.reserve(FaceDetection::kKeypoints);
+        for (int k = 0; k < FaceDetection::kKeypoints; ++k) {
+            fb.landmarks.push_back(neptune::Point{d.keypoints[2 * k], d.keypoints[2 * k + 1]});
+        }
+    }
 }
 
-static std::vector<FaceBox> nonMaxSuppression(std::vector<FaceBox>& boxes, float iou_threshold, int top_k = 5) {
-    std::sort(boxes.begin(), boxes.end(), [](const FaceBox& a, const FaceBox& b){ return a.confidence > b.confidence; });
-    std::vector<bool> suppressed(boxes.size(), false);
-    std::vector<FaceBox> out;
+// ------------------- MediaPipe 2-output parser -------------------
+void FaceDetector::parseMediaPipe2OutputFormat(const OutputTensorView& boxes_and_keypoints,
+                                               const OutputTensorView& scores,
+                                               const cv::Size& regionSize,
+                                               std::vector<FaceDetection>& decoded) const {
+    decoder_.decode(boxes_and_keypoints, scores, regionSize, decoded);
+}
 
-    for (size_t i = 0; i < boxes.size(); ++i) {
-        if (suppressed[i]) continue;
-        out.push_back(boxes[i]);
-        if (static_cast<int>(out.size()) >= top_k) break;
+// ------------------- detectFaces -------------------
+template <typename Image>
+bool FaceDetector::detectRegion(TfLiteEngine& engine, const Image& image, const cv::Rect& region, bool dropCut,
+                                std::vector<FaceDetection>& out) const {
+    // Letterbox, BGR->RGB and normalize in one pass, straight into the input tensor
+    InputTensorView input = engine.inputTensorView(0);
+    if (!img::Preprocess::resizeNormalizeInto(image, region, input) || !engine.invoke()) {
+        return false;
+    }
 
-        for (size_t j = i + 1; j < boxes.size(); ++j) {
-            if (suppressed[j]) continue;
-            if (iouBox(boxes[i], boxes[j]) > iou_threshold) suppressed[j] = true;
+    const size_t first = out.size();
+    parseMediaPipe2OutputFormat(engine.outputTensorView(0), engine.outputTensorView(1), region.size(), out);
+
+    // Decoded boxes are clamped to the region; one reaching an inner edge is probably cut off.
+    const cv::Size imageSize = image.size();
+    const bool cutLeft = dropCut && region.x > 0;
+    const bool cutTop = dropCut && region.y > 0;
+    const bool cutRight = dropCut && region.br().x < imageSize.width;
+    const bool cutBottom = dropCut && region.br().y < imageSize.height;
+    size_t kept = first;
+    for (size_t i = first; i < out.size(); ++i) {
+        FaceDetection d = out[i];
+        if ((cutLeft && d.x1 <= 1) || (cutTop && d.y1 <= 1) ||
+            (cutRight && d.x2 >= region.width - 2) || (cutBottom && d.y2 >= region.height - 2)) {
+            continue;
+        }
+        d.x1 += region.x; d.x2 += region.x;
+        d.y1 += region.y; d.y2 += region.y;
+        for (int k = 0; k < FaceDetection::kKeypoints; ++k) {
+            d.keypoints[2 * k] += region.x;
+            d.keypoints[2 * k + 1] += region.y;
         }
+        out[kept++] = d;
     }
-    return out;
+    out.resize(kept);
+    return true;
 }
 
-// ------------------- MediaPipe 2-output parser -------------------
-void FaceDetector::parseMediaPipe2OutputFormat(const std::vector<float>& boxes_and_keypoints,
-                                               const std::vector<float>& scores,
-                                               const cv::Mat& image,
-                                               std::vector<FaceBox>& results) {
-    if (scores.empty() || boxes_and_keypoints.empty()) return;
-    int N = static_cast<int>(scores.size());
-
-    if (anchors_.empty() || static_cast<int>(anchors_.size()) != N) {
-        anchors_ = generateAnchors(inputWidth_, inputHeight_, {8,16,16,16}, 0.1484375f, 0.75f, 0.5f, 0.5f);
+template <typename Image>
+void FaceDetector::detectTiled(TfLiteEngine& engine, const Image& image, const std::vector<cv::Rect>& tiles,
+                               std::vector<FaceDetection>& out) const {
+    // Shared with the helper tasks. A task that only starts once the caller
+    // has closed the batch does nothing, so the caller never waits for a
+    // worker busy with another frame.
+    struct Batch {
+        std::atomic<int> next{0};
+        std::mutex mutex;
+        std::condition_variable idle;
+        bool closed = false;
+        int running = 0;
+        std::vector<std::vector<FaceDetection>> found;   // one per helper
+    };
+
+    // Job 0 is the whole frame, for faces larger than a tile; then one job per tile.
+    const int jobs = 1 + static_cast<int>(tiles.size());
+    const int helpers = workers_ ? std::min(std::min(detectionThreads_, jobs) - 1, workers_->size()) : 0;
+    auto batch = std::make_shared<Batch>();
+    batch->found.resize(std::max(helpers, 0));
+    const auto work = [&](TfLiteEngine& worker, std::vector<FaceDetection>& found) {
+        for (int job = batch->next.fetch_add(1); job < jobs; job = batch->next.fetch_add(1)) {
+            const cv::Rect region = job == 0 ? cv::Rect(cv::Point(), image.size()) : tiles[job - 1];
+            detectRegion(worker, image, region, job != 0, found);
+        }
+    };
+
+    // Helpers never wait for an interpreter: if none is free, the others take their share.
+    for (int i = 0; i < helpers; ++i) {
+        workers_->post([this, batch, i, &work] {
+            {
+                std::lock_guard<std::mutex> lock(batch->mutex);
+                if (batch->closed) return;
+                ++batch->running;
+            }
+            InterpreterPool::Lease lease = pool_->tryAcquire();
+            if (lease) work(*lease, batch->found[i]);
+            std::lock_guard<std::mutex> lock(batch->mutex);
+            if (--batch->running == 0) batch->idle.notify_all();
+        });
     }
-
-    float ratio = std::min(static_cast<float>(inputWidth_) / image.cols,
-                           static_cast<float>(inputHeight_) / image.rows);
-    int pad_x = static_cast<int>((inputWidth_ - image.cols * ratio) * 0.5f);
-    int pad_y = static_cast<int>((inputHeight_ - image.rows * ratio) * 0.5f);
-
-    float x_scale = static_cast<float>(inputWidth_);
-    float y_scale = static_cast<float>(inputHeight_);
-
-    std::vector<FaceBox> decoded;
-    decoded.reserve(N);
-
-    for (int i = 0; i < N; ++i) {
-        float score = sigmoidf(scores[i]);
-        if (score < minConfidence_) continue;
-
-        int off = i * 16;
-        if (off + 15 >= static_cast<int>(boxes_and_keypoints.size())) break;
-
-        const Anchor an = (i < static_cast<int>(anchors_.size())) ? anchors_[i] : Anchor{0.5f,0.5f,1.0f,1.0f};
-
-        float t_y = boxes_and_keypoints[off+0];
-        float t_x = boxes_and_keypoints[off+1];
-        float t_h = boxes_and_keypoints[off+2];
-        float t_w = boxes_and_keypoints[off+3];
-
-        float x_center = an.x_center + (t_x / x_scale) * an.w;
-        float y_center = an.y_center + (t_y / y_scale) * an.h;
-        float w_norm = an.w * std::exp(t_w / x_scale);
-        float h_norm = an.h * std::exp(t_h / y_scale);
-
-        float x1n = std::clamp(x_center - 0.5f*w_norm, 0.0f, 1.0f);
-        float y1n = std::clamp(y_center - 0.5f*h_norm, 0.0f, 1.0f);
-        float x2n = std::clamp(x_center + 0.5f*w_norm, 0.0f, 1.0f);
-        float y2n = std::clamp(y_center + 0.5f*h_norm, 0.0f, 1.0f);
-
-        int x1_t = static_cast<int>(x1n * inputWidth_);
-        int y1_t = static_cast<int>(y1n * inputHeight_);
-        int x2_t = static_cast<int>(x2n * inputWidth_);
-        int y2_t = static_cast<int>(y2n * inputHeight_);
-
-        int x1 = std::clamp(static_cast<int>((x1_t - pad_x) / ratio), 0, image.cols-1);
-        int y1 = std::clamp(static_cast<int>((y1_t - pad_y) / ratio), 0, image.rows-1);
-        int x2 = std::clamp(static_cast<int>((x2_t - pad_x) / ratio), 0, image.cols-1);
-        int y2 = std::clamp(static_cast<int>((y2_t - pad_y) / ratio), 0, image.rows-1);
-
-        int w = x2 - x1;
-        int h = y2 - y1;
-        if (w <=0 || h <=0) continue;
-
-        FaceBox fb;
-        fb.x = x1; fb.y = y1; fb.width = w; fb.height = h; fb.confidence = score;
-
-        // extract 6 landmarks
-        for (int k=4; k<16; k+=2) {
-            float lx = boxes_and_keypoints[off+k]/x_scale*an.w + an.x_center;
-            float ly = boxes_and_keypoints[off+k+1]/y_scale*an.h + an.y_center;
-            int lx_img = std::clamp(static_cast<int>((lx*inputWidth_-pad_x)/ratio),0,image.cols-1);
-            int ly_img = std::clamp(static_cast<int>((ly*inputHeight_-pad_y)/ratio),0,image.rows-1);
-            fb.landmarks.push_back(neptune::Point{ static_cast<float>(lx_img),
-                static_cast<float>(ly_img) });
-}
-        decoded.push_back(fb);
+    work(engine, out);
+    {
+        std::unique_lock<std::mutex> lock(batch->mutex);
+        batch->closed = true;
+        batch->idle.wait(lock, [&] { return batch->running == 0; });
     }
-
-    if (!decoded.empty()) {
-        auto kept = nonMaxSuppression(decoded,0.3f,2);
-        results.insert(results.end(), kept.begin(), kept.end());
+    for (const auto& found : batch->found) {
+        out.insert(out.end(), found.begin(), found.end());
     }
 }
 
-// ------------------- detectFaces -------------------
-std::vector<FaceBox> FaceDetector::detectFaces(const cv::Mat& image) {
+template <typename Image>
+std::vector<FaceBox> FaceDetector::detect(const Image& image) {
     std::vector<FaceBox> results;
-    if (!engine_ || image.empty()) return results;
-
-    cv::Mat resized = img::Preprocess::resize(image,inputWidth_,inputHeight_);
-    std::vector<float> inputTensor = img::Preprocess::normalize(resized);
+    if (!pool_ || image.empty()) return results;
+    const auto frameTime = std::chrono::steady_clock::now();
 
-    if (!engine_->setInputTensor(inputTensor) || !engine_->invoke()) return results;
+    InterpreterPool::Lease engine = pool_->acquire();
+    if (!engine) {
+        NEPTUNE_LOG_WARN("FaceDetector", "All interpreters busy, skipping frame");
+        return results;
+    }
 
-    int numOutputs = engine_->getNumOutputs();
-    if (numOutputs==2) {
-        parseMediaPipe2OutputFormat(engine_->getOutputTensor(0),
-                                    engine_->getOutputTensor(1),
-                                    image, results);
-    } else if (numOutputs>=4) {
-        parseSSDFormat(image, results);
+    const cv::Size imageSize = image.size();
+    if (numOutputs_ == 2) {
+        thread_local std::vector<FaceDetection> decoded;
+        decoded.clear();
+        const std::vector<cv::Rect> tiles = tiledDetection_
+            ? detectionTiles(imageSize, tileSize_, tileOverlap_, detectionThreads_,
+                             std::max(inputWidth_, inputHeight_))
+            : std::vector<cv::Rect>();
+        if (!tiles.empty()) {
+            detectTiled(*engine, image, tiles, decoded);
+        } else if (!detectRegion(*engine, image, cv::Rect(cv::Point(), imageSize), false, decoded)) {
+            return results;
+        }
+        suppress(decoded, results);
     } else {
-        parseUnknownFormat(engine_->getOutputTensor(0), image, results);
+        InputTensorView input = engine->inputTensorView(0);
+        if (!img::Preprocess::resizeNormalizeInto(image, cv::Rect(cv::Point(), imageSize), input) ||
+            !engine->invoke()) {
+            return results;
+        }
+        if (numOutputs_ >= 4) {
+            parseSSDFormat(imageSize, results);
+        } else {
+            parseUnknownFormat(engine->outputTensorView(0), imageSize, results);
+        }
     }
 
-    Log::info("FaceDetector","Detected "+std::to_string(results.size())+" faces");
+    // Callers with a stream time (NeptuneSDK, WebRTCManager) overwrite this.
+    for (FaceBox& face : results) face.detectionTime = frameTime;
+    NEPTUNE_LOG_DEBUG("FaceDetector", "Detected " << results.size() << " faces");
     return results;
 }
-void FaceDetector::parseSSDFormat(const cv::Mat& image, std::vector<FaceBox>& results) {
+
+std::vector<FaceBox> FaceDetector::detectFaces(const cv::Mat& image) {
+    return detect(image);
+}
+
+std::vector<FaceBox> FaceDetector::detectFaces(const YuvFrame& frame) {
+    return detect(frame);
+}
+
+void FaceDetector::parseSSDFormat(const cv::Size& imageSize, std::vector<FaceBox>& results) {
     // empty for now
 }
 
-void FaceDetector::parseUnknownFormat(const std::vector<float>& output, const cv::Mat& image, std::vector<FaceBox>& results) {
+void FaceDetector::parseUnknownFormat(const OutputTensorView& output, const cv::Size& imageSize, std::vector<FaceBox>& results) {
     // empty for now
 }
 
@@ -0,0 +1,182 @@
+//
+// File: NeptuneFacialSDK/core/src/FaceTracker.cpp
+//
+// Each box coordinate (center x/y, width, height) has its own position and
+// velocity filter: with a constant-velocity model and independent noise per
+// coordinate, the 8-state Kalman filter splits exactly into four 2-state
+// ones. Noise scales with the face size, so the filter behaves the same for
+// near and far faces.
+//
+
+#include "neptune/FaceTracker.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace neptune {
+
+namespace {
+
+constexpr float kMeasureStd = 0.05f;   // detection jitter, relative to the box size
+constexpr float kProcessStd = 0.03f;   // change of velocity per frame, relative to the box size
+constexpr float kCenterWeight = 0.5f;  // cost of one box size of center distance, against 1 - IoU
+constexpr size_t kPairsPerTrack = 8;   // preallocated candidate pairs per track
+
+float iou(float ax, float ay, float aw, float ah, const FaceBox& b) {
+    const float interW = std::min(ax + 0.5f * aw, static_cast<float>(b.x + b.width)) -
+                         std::max(ax - 0.5f * aw, static_cast<float>(b.x));
+    const float interH = std::min(ay + 0.5f * ah, static_cast<float>(b.y + b.height)) -
+                         std::max(ay - 0.5f * ah, static_cast<float>(b.y));
+    if (interW <= 0.0f || interH <= 0.0f) return 0.0f;
+    const float inter = interW * interH;
+    return inter / (aw * ah + static_cast<float>(b.width) * b.height - inter + 1e-6f);
+}
+
+} // namespace
+
+void FaceTracker::Axis::init(float z, float r) {
+    x = z;
+    v = 0.0f;
+    p00 = r;
+    p01 = 0.0f;
+    p11 = 10.0f * r;   // unknown velocity
+}
+
+void FaceTracker::Axis::predict(float q) {
+    // x' = x + v; P' = F P F^T + q * [1/4 1/2; 1/2 1] (white acceleration noise)
+    x += v;
+    p00 += 2.0f * p01 + p11 + 0.25f * q;
+    p01 += p11 + 0.5f * q;
+    p11 += q;
+}
+
+void FaceTracker::Axis::correct(float z, float r) {
+    const float s = p00 + r;
+    const float k0 = p00 / s;
+    const float k1 = p01 / s;
+    const float y = z - x;
+    x += k0 * y;
+    v += k1 * y;
+    p11 -= k1 * p01;
+    p00 *= 1.0f - k0;
+    p01 *= 1.0f - k0;
+}
+
+FaceTracker::FaceTracker(const NeptuneConfig& config)
+    : confirmFrames_(std::max(1, config.trackConfirmFrames)),
+      maxMissed_(std::max(0, config.trackMaxMissedFrames)),
+      minIou_(config.trackMinIou),
+      maxCenterDistance_(config.trackMaxCenterDistance),
+      maxTracks_(static_cast<size_t>(std::max(1, config.maxTracks))) {
+    tracks_.reserve(maxTracks_);
+    matches_.reserve(maxTracks_ * kPairsPerTrack);
+    trackMatched_.reserve(maxTracks_);
+    faceMatched_.reserve(maxTracks_);
+    facesByX_.reserve(maxTracks_);
+}
+
+void FaceTracker::reset() {
+    tracks_.clear();
+}
+
+void FaceTracker::startTrack(const FaceBox& face) {
+    const float size = static_cast<float>(std::max(face.width, face.height));
+    const float r = (kMeasureStd * size) * (kMeasureStd * size);
+    Track& track = tracks_.emplace_back();
+    track.id = -1;
+    track.hits = 1;
+    track.misses = 0;
+    track.cx.init(face.x + 0.5f * face.width, r);
+    track.cy.init(face.y + 0.5f * face.height, r);
+    track.w.init(static_cast<float>(face.width), r);
+    track.h.init(static_cast<float>(face.height), r);
+    if (track.hits >= confirmFrames_) track.id = nextId_++;
+}
+
+void FaceTracker::update(std::vector<FaceBox>& faces) {
+    for (FaceBox& face : faces) face.trackId = -1;
+
+    // Predict every track to this frame.
+    for (Track& track : tracks_) {
+        const float size = std::max(track.w.x, track.h.x);
+        const float q = (kProcessStd * size) * (kProcessStd * size);
+        track.cx.predict(q);
+        track.cy.predict(q);
+        track.w.predict(q);
+        track.h.predict(q);
+    }
+
+    // Faces sorted by center x, so each track only looks at the faces
+    // within its gate horizontally.
+    facesByX_.clear();
+    int widest = 0;
+    for (size_t f = 0; f < faces.size(); ++f) {
+        facesByX_.emplace_back(faces[f].x + 0.5f * faces[f].width, static_cast<int>(f));
+        widest = std::max(widest, faces[f].width);
+    }
+    std::sort(facesByX_.begin(), facesByX_.end());
+
+    // Pairs passing the gate, cheapest first.
+    matches_.clear();
+    for (size_t t = 0; t < tracks_.size(); ++t) {
+        const Track& track = tracks_[t];
+        const float size = std::max(1.0f, std::max(track.w.x, track.h.x));
+        // Beyond this horizontal distance a face neither overlaps the track nor is close enough.
+        const float reach = std::max(maxCenterDistance_ * size, 0.5f * (track.w.x + widest));
+        auto it = std::lower_bound(facesByX_.begin(), facesByX_.end(), std::make_pair(track.cx.x - reach, -1));
+        for (; it != facesByX_.end() && it->first <= track.cx.x + reach; ++it) {
+            const size_t f = static_cast<size_t>(it->second);
+            const FaceBox& face = faces[f];
+            const float dx = face.x + 0.5f * face.width - track.cx.x;
+            const float dy = face.y + 0.5f * face.height - track.cy.x;
+            const float distance = std::sqrt(dx * dx + dy * dy) / size;
+            const float overlap = iou(track.cx.x, track.cy.x, track.w.x, track.h.x, face);
+            if (overlap < minIou_ && distance > maxCenterDistance_) continue;
+            matches_.push_back(Match{1.0f - overlap + kCenterWeight * distance, static_cast<int>(t),
+                                     static_cast<int>(f)});
+        }
+    }
+    std::sort(matches_.begin(), matches_.end(), [](const Match& a, const Match& b) { return a.cost < b.cost; });
+
+    trackMatched_.assign(tracks_.size(), 0);
+    faceMatched_.assign(faces.size(), 0);
+    for (const Match& m : matches_) {
+        if (trackMatched_[m.track] || faceMatched_[m.face]) continue;
+        trackMatched_[m.track] = 1;
+        faceMatched_[m.face] = 1;
+
+        Track& track = tracks_[m.track];
+        const FaceBox& face = faces[m.face];
+        const float size = static_cast<float>(std::max(face.width, face.height));
+        const float r = (kMeasureStd * size) * (kMeasureStd * size);
+        track.cx.correct(face.x + 0.5f * face.width, r);
+        track.cy.correct(face.y + 0.5f * face.height, r);
+        track.w.correct(static_cast<float>(face.width), r);
+        track.h.correct(static_cast<float>(face.height), r);
+        ++track.hits;
+        track.misses = 0;
+        if (track.id < 0 && track.hits >= confirmFrames_) track.id = nextId_++;
+        faces[m.face].trackId = track.id;
+    }
+
+    // Unmatched tracks: tentative ones die at once, confirmed ones after maxMissed_ frames.
+    size_t kept = 0;
+    for (size_t t = 0; t < tracks_.size(); ++t) {
+        Track& track = tracks_[t];
+        if (!trackMatched_[t]) {
+            track.hits = 0;
+            if (track.id < 0 || ++track.misses > maxMissed_) continue;
+        }
+        tracks_[kept++] = track;
+    }
+    tracks_.resize(kept);
+
+    // Unmatched faces start tentative tracks while there is room.
+    for (size_t f = 0; f < faces.size() && tracks_.size() < maxTracks_; ++f) {
+        if (faceMatched_[f]) continue;
+        startTrack(faces[f]);
+        faces[f].trackId = tracks_.back().id;
+    }
+}
+
+} // namespace neptune
@@ -0,0 +1,120 @@
+//
+// File: NeptuneFacialSDK/core/src/LandmarkTracker.cpp
+//
+
+#include "neptune/LandmarkTracker.h"
+#include "neptune/Log.h"
+#include "neptune/Preprocess.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace neptune {
+
+namespace {
+
+// Box around a face mesh; the landmarks move into the FaceBox.
+FaceBox faceFromLandmarks(std::vector<Point>&& landmarks, float presence) {
+    float minX = std::numeric_limits<float>::max(), maxX = -minX;
+    float minY = minX, maxY = -minX;
+    for (const Point& p : landmarks) {
+        minX = std::min(minX, p.x); maxX = std::max(maxX, p.x);
+        minY = std::min(minY, p.y); maxY = std::max(maxY, p.y);
+    }
+    FaceBox face;
+    face.x = static_cast<int>(minX);
+    face.y = static_cast<int>(minY);
+    face.width = static_cast<int>(maxX) - face.x;
+    face.height = static_cast<int>(maxY) - face.y;
+    face.confidence = presence;
+    face.landmarks = std::move(landmarks);
+    return face;
+}
+
+bool containsCenterOf(const FaceBox& tracked, const FaceBox& detection) {
+    const int cx = detection.x + detection.width / 2;
+    const int cy = detection.y + detection.height / 2;
+    return cx >= tracked.x && cx < tracked.x + tracked.width && cy >= tracked.y && cy < tracked.y + tracked.height;
+}
+
+} // namespace
+
+LandmarkTracker::LandmarkTracker(FaceDetector& detector, LandmarkExtractor& landmarks, const NeptuneConfig& config)
+    : detector_(detector),
+      landmarks_(landmarks),
+      maxFaces_(config.maxFaces),
+      redetectInterval_(config.redetectIntervalFrames),
+      minPresence_(config.minFacePresence),
+      roiScale_(config.landmarkRoiScale),
+      alignCrops_(config.alignFaceCrops) {}
+
+std::vector<FaceBox> LandmarkTracker::track(const cv::Mat& image) {
+    return trackImpl(image);
+}
+
+std::vector<FaceBox> LandmarkTracker::track(const YuvFrame& frame) {
+    return trackImpl(frame);
+}
+
+void LandmarkTracker::reset() {
+    rois_.clear();
+    framesSinceDetection_ = 0;
+}
+
+template <typename Image>
+void LandmarkTracker::followRois(const Image& image, const std::vector<NormalizedRect>& rois,
+                                 std::vector<FaceBox>& faces) {
+    thread_local std::vector<float> presence;
+    std::vector<std::vector<Point>> meshes = landmarks_.processRois(image, rois, presence);
+    for (size_t i = 0; i < meshes.size(); ++i) {
+        if (meshes[i].empty() || presence[i] < minPresence_) continue;
+        FaceBox face = faceFromLandmarks(std::move(meshes[i]), presence[i]);
+        // Two crops that drifted onto the same face keep the first.
+        const bool duplicate = std::any_of(faces.begin(), faces.end(),
+                                           [&](const FaceBox& other) { return containsCenterOf(other, face); });
+        if (!duplicate) faces.push_back(std::move(face));
+    }
+}
+
+template <typename Image>
+std::vector<FaceBox> LandmarkTracker::trackImpl(const Image& image) {
+    ++stats_.frames;
+    std::vector<FaceBox> faces;
+    if (image.empty()) return faces;
+    const cv::Size imageSize = image.size();
+
+    // Follow the tracked faces from the previous frame's landmarks.
+    if (!rois_.empty()) followRois(image, rois_, faces);
+
+    // Detect when a face was lost, nothing is tracked, or new faces are due.
+    // A due pass still runs with maxFaces tracked; it just adds no tracks.
+    const bool lost = faces.size() < rois_.size();
+    const bool due = redetectInterval_ > 0 && ++framesSinceDetection_ >= redetectInterval_;
+    if (faces.empty() || lost || due) {
+        framesSinceDetection_ = 0;
+        ++stats_.detectorRuns;
+
+        // Only faces not already tracked get a crop from their detection box.
+        std::vector<NormalizedRect> fresh;
+        for (const FaceBox& detection : detector_.detectFaces(image)) {
+            if (maxFaces_ > 0 && static_cast<int>(faces.size() + fresh.size()) >= maxFaces_) break;
+            const bool tracked = std::any_of(faces.begin(), faces.end(),
+                                             [&](const FaceBox& face) { return containsCenterOf(face, detection); });
+            if (!tracked) {
+                fresh.push_back(img::Preprocess::faceRoi(detection, imageSize, roiScale_, /*square=*/true, alignCrops_));
+            }
+        }
+        if (!fresh.empty()) followRois(image, fresh, faces);
+        NEPTUNE_LOG_DEBUG("LandmarkTracker", "Detection pass: " << fresh.size() << " new faces, "
+                          << faces.size() << " tracked");
+    }
+
+    // Next frame's crops, from this frame's landmarks.
+    rois_.clear();
+    for (const FaceBox& face : faces) {
+        rois_.push_back(img::Preprocess::landmarksRoi(face.landmarks, imageSize, roiScale_, alignCrops_));
+    }
+    return faces;
+}
+
+} // namespace neptune
@@ -5,382 +5,493 @@
 #include <cmath>
 #include <algorithm>
 #include <chrono>
+#include <cstdio>
+#include <limits>
 using namespace neptune;
 
+namespace {
+
+// Overlap of a face with a state's last box (center and size)
+float iou(const FaceBox& a, float cx, float cy, float w, float h) {
+    const float interW = std::min(static_cast<float>(a.x + a.width), cx + 0.5f * w) -
+                         std::max(static_cast<float>(a.x), cx - 0.5f * w);
+    const float interH = std::min(static_cast<float>(a.y + a.height), cy + 0.5f * h) -
+                         std::max(static_cast<float>(a.y), cy - 0.5f * h);
+    if (interW <= 0.0f || interH <= 0.0f) return 0.0f;
+    const float inter = interW * interH;
+    return inter / (static_cast<float>(a.width) * a.height + w * h - inter + 1e-6f);
+}
+
+// Hash grid level of a box: cells of 2^level pixels, between half the box
+// size and the box size, so a face that still overlaps its last box is at
+// most one cell away from it.
+int levelOf(float width, float height) {
+    return std::ilogb(std::max(1.0f, std::max(width, height)));
+}
+
+// MediaPipe 468-point mesh indices. Eye points in EAR order: P1 and P4 are
+// the corners, P2/P6 and P3/P5 face each other across the eyelids.
+constexpr size_t kMeshSize = 468;
+constexpr int kLeftEye[6] = {362, 385, 387, 263, 373, 380};
+constexpr int kRightEye[6] = {33, 159, 158, 133, 145, 153};
+constexpr int kNoseTip = 1;
+constexpr int kForehead = 10;
+constexpr int kChin = 175;
+
+struct FaceMeasures {
+    float leftEAR, rightEAR;
+    float yaw, pitch;   // normalized to [-1, 1]
+};
+
+float distance(const Point& a, const Point& b) {
+    const float dx = a.x - b.x;
+    const float dy = a.y - b.y;
+    return std::sqrt(dx * dx + dy * dy);
+}
+
+// Eye aspect ratio of the six points of an eye, and their center. -1 when
+// the eye is degenerate.
+float eyeAspectRatio(const Point* mesh, const int (&eye)[6], Point& center) {
+    Point p[6];
+    center = Point{0.0f, 0.0f};
+    NEPTUNE_LOG_DEBUG("LivenessChecker", "Eye landmarks: ");
+    for (int i = 0; i < 6; ++i) {
+        p[i] = mesh[eye[i]];
+        center.x += p[i].x;
+        center.y += p[i].y;
+        NEPTUNE_LOG_DEBUG("LivenessChecker", " P" << i << ": (" << p[i].x << ", " << p[i].y << ")");
+    }
+    center.x /= 6.0f;
+    center.y /= 6.0f;
+    // EAR formula: (|P2-P6| + |P3-P5|) / (2 * |P1-P4|)
+    const float vertical1 = distance(p[1], p[5]);
+    const float vertical2 = distance(p[2], p[4]);
+    const float horizontal = distance(p[0], p[3]);
+    NEPTUNE_LOG_DEBUG("LivenessChecker", "EAR components: vertical1=" << vertical1 << ", vertical2=" << vertical2 << ", horizontal=" << horizontal);
+    if (horizontal < 1e-6f) {
+        NEPTUNE_LOG_WARN("LivenessChecker", "Horizontal eye distance too small: " << horizontal);
+        return -1.0f;
+    }
+    return (vertical1 + vertical2) / (2.0f * horizontal);
+}
+
+// Both EARs and the head pose of a 468-point mesh, in one pass over the
+// index tables: the eye centers for the yaw come from the EAR points.
+FaceMeasures measureFace(const Point* mesh) {
+    FaceMeasures m;
+    Point leftEyeCenter, rightEyeCenter;
+    m.leftEAR = eyeAspectRatio(mesh, kLeftEye, leftEyeCenter);
+    m.rightEAR = eyeAspectRatio(mesh, kRightEye, rightEyeCenter);
+    NEPTUNE_LOG_DEBUG("LivenessChecker", "Left eye center: (" << leftEyeCenter.x << ", " << leftEyeCenter.y << ")");
+    NEPTUNE_LOG_DEBUG("LivenessChecker", "Right eye center: (" << rightEyeCenter.x << ", " << rightEyeCenter.y << ")");
+
+    // Yaw: nose tip offset from the middle of the eyes, in eye distances
+    const Point& noseTip = mesh[kNoseTip];
+    const float eyesDistance = std::abs(rightEyeCenter.x - leftEyeCenter.x);
+    if (eyesDistance < 1e-3f) {
+        NEPTUNE_LOG_WARN("LivenessChecker", "Eyes too close for yaw calculation: " << eyesDistance);
+        m.yaw = 0.0f;
+    } else {
+        const float eyesCenterX = (leftEyeCenter.x + rightEyeCenter.x) / 2.0f;
+        m.yaw = std::max(-1.0f, std::min(1.0f, (noseTip.x - eyesCenterX) / eyesDistance));
+    }
+
+    // Pitch: nose tip offset from the middle of forehead and chin, in face heights
+    const Point& forehead = mesh[kForehead];
+    const Point& chin = mesh[kChin];
+    NEPTUNE_LOG_DEBUG("LivenessChecker", "Pitch landmarks: nose (" << noseTip.x << ", " << noseTip.y << "), forehead ("
+                      << forehead.x << ", " << forehead.y << "), chin (" << chin.x << ", " << chin.y << ")");
+    const float faceHeight = std::abs(chin.y - forehead.y);
+    if (faceHeight < 1e-3f) {
+        NEPTUNE_LOG_WARN("LivenessChecker", "Face height too small for pitch calculation: " << faceHeight);
+        m.pitch = 0.0f;
+    } else {
+        const float faceCenterY = (forehead.y + chin.y) / 2.0f;
+        m.pitch = std::max(-1.0f, std::min(1.0f, (noseTip.y - faceCenterY) / faceHeight));
+    }
+    return m;
+}
+
+// Formats a result reason into the string's existing capacity.
+template <typename... Args>
+void setReason(std::string& reason, const char* format, Args... args) {
+    char buffer[192];
+    std::snprintf(buffer, sizeof(buffer), format, args...);
+    reason.assign(buffer);
+}
+
+} // namespace
+
 LivenessChecker::LivenessChecker(const NeptuneConfig& config)
     : config_(config),
-      lastHeadMoveTime_(std::chrono::steady_clock::now()),
-      firstDetectionTime_(std::chrono::steady_clock::now()),
-      blinkFrameCount_(0),
-      lastYaw_(0.0f),
-      lastPitch_(0.0f),
-      smoothedYaw_(0.0f),
-      smoothedPitch_(0.0f),
-      isInitialized_(false),
-      frameCount_(0),
       isVideoMode_(false),
-      hasProvenLiveness_(false),
-      totalBlinksDetected_(0),
-      totalHeadMovements_(0),
-      baselineEAR_(0.3f), // Initial guess
-      calibrationFrames_(0) {}
+      states_(static_cast<size_t>(std::max(1, config.livenessMaxFaces))) {
+    // Power-of-two bucket count, at least twice the slots
+    uint32_t bits = 1;
+    while ((size_t{1} << bits) < 2 * states_.size()) ++bits;
+    bucketShift_ = 64 - bits;
+    buckets_.assign(size_t{1} << bits, -1);
+    for (FaceState& state : states_) state.reset(std::chrono::steady_clock::time_point());
+}
+
+void LivenessChecker::FaceState::reset(std::chrono::steady_clock::time_point now) {
+    trackId = -1;
+    cx = cy = w = h = 0.0f;
+    lastFrame = 0;
+    lruPrev = lruNext = -1;
+    bucket = bucketPrev = bucketNext = -1;
+    earHistory.clear();
+    yawHistory.clear();
+    pitchHistory.clear();
+    blinkFrameCount = 0;
+    lastHeadMoveTime = now;
+    firstDetectionTime = now;
+    lastYaw = 0.0f;
+    lastPitch = 0.0f;
+    smoothedYaw = 0.0f;
+    smoothedPitch = 0.0f;
+    isInitialized = false;
+    frameCount = 0;
+    hasProvenLiveness = false;
+    totalBlinksDetected = 0;
+    totalHeadMovements = 0;
+    baselineEAR = 0.3f; // Initial guess
+    calibrationFrames = 0;
+}
 
 void LivenessChecker::setVideoMode(bool enabled) {
     isVideoMode_ = enabled;
-    Log::info("LivenessChecker", "Video mode set to: " + std::string(enabled ? "true" : "false"));
+    NEPTUNE_LOG_INFO("LivenessChecker", "Video mode set to: " << (enabled ? "true" : "false"));
     if (!enabled) {
         resetForNewFrame();
     }
 }
 
 void LivenessChecker::resetForNewFrame() {
-    frameCount_ = 0;
-    isInitialized_ = false;
-    earHistory_.clear();
-    yawHistory_.clear();
-    pitchHistory_.clear();
-    blinkFrameCount_ = 0;
-    lastHeadMoveTime_ = std::chrono::steady_clock::now();
-    firstDetectionTime_ = std::chrono::steady_clock::now();
-    lastYaw_ = 0.0f;
-    lastPitch_ = 0.0f;
-    smoothedYaw_ = 0.0f;
-    smoothedPitch_ = 0.0f;
-    hasProvenLiveness_ = false;
-    totalBlinksDetected_ = 0;
-    totalHeadMovements_ = 0;
-    baselineEAR_ = 0.3f;
-    calibrationFrames_ = 0;
-    Log::debug("LivenessChecker", "Reset for new frame/image - liveness proof required");
+    for (size_t i = 0; i < used_; ++i) states_[i].reset(std::chrono::steady_clock::time_point());
+    std::fill(buckets_.begin(), buckets_.end(), -1);
+    used_ = 0;
+    lruHead_ = lruTail_ = -1;
+    NEPTUNE_LOG_DEBUG("LivenessChecker", "Reset for new frame/image - liveness proof required");
 }
 
-float LivenessChecker::computeEAR(const std::vector<Point>& eyeLandmarks) {
-    if (eyeLandmarks.size() != 6) {
-        Log::warn("LivenessChecker", "Invalid eye landmarks count: " + std::to_string(eyeLandmarks.size()));
-        return -1.0f;
-    }
-    try {
-        Log::debug("LivenessChecker", "Eye landmarks: ");
-        for (int i = 0; i < 6; i++) {
-            Log::debug("LivenessChecker", " P" + std::to_string(i) + ": (" +
-                      std::to_string(eyeLandmarks[i].x) + ", " + std::to_string(eyeLandmarks[i].y) + ")");
-        }
-        // EAR formula: (|P2-P6| + |P3-P5|) / (2 * |P1-P4|)
-        float vertical1 = std::sqrt(std::pow(eyeLandmarks[1].x - eyeLandmarks[5].x, 2) +
-                                   std::pow(eyeLandmarks[1].y - eyeLandmarks[5].y, 2));
-        float vertical2 = std::sqrt(std::pow(eyeLandmarks[2].x - eyeLandmarks[4].x, 2) +
-                                   std::pow(eyeLandmarks[2].y - eyeLandmarks[4].y, 2));
-        float horizontal = std::sqrt(std::pow(eyeLandmarks[0].x - eyeLandmarks[3].x, 2) +
-                                    std::pow(eyeLandmarks[0].y - eyeLandmarks[3].y, 2));
-        Log::debug("LivenessChecker", "EAR components: vertical1=" + std::to_string(vertical1) +
-                  ", vertical2=" + std::to_string(vertical2) + ", horizontal=" + std::to_string(horizontal));
-        if (horizontal < 1e-6f) {
-            Log::warn("LivenessChecker", "Horizontal eye distance too small: " + std::to_string(horizontal));
-            return -1.0f;
-        }
-        float ear = (vertical1 + vertical2) / (2.0f * horizontal);
-        Log::debug("LivenessChecker", "Computed EAR: " + std::to_string(ear));
-        return ear;
-    } catch (const std::exception& e) {
-        Log::error("LivenessChecker", "EAR calculation error: " + std::string(e.what()));
-        return -1.0f;
-    }
+int LivenessChecker::bucketOf(int level, int gx, int gy) const {
+    const uint64_t key = (static_cast<uint64_t>(level) << 58) ^
+                         (static_cast<uint64_t>(static_cast<uint32_t>(gx)) << 29) ^
+                         static_cast<uint32_t>(gy);
+    return static_cast<int>((key * 0x9E3779B97F4A7C15ull) >> bucketShift_);
 }
 
-float LivenessChecker::estimateHeadYaw(const std::vector<Point>& landmarks) {
-    if (landmarks.size() != 468) {
-        Log::warn("LivenessChecker", "Invalid landmarks count for MediaPipe: " + std::to_string(landmarks.size()));
-        return 0.0f;
-    }
-    try {
-        const Point& noseTip = landmarks[1];
-        Point leftEyeCenter = {0.0f, 0.0f};
-        std::vector<int> leftEyeIndices = {362, 385, 387, 263, 373, 380};
-        for (int idx : leftEyeIndices) {
-            leftEyeCenter.x += landmarks[idx].x;
-            leftEyeCenter.y += landmarks[idx].y;
-        }
-        leftEyeCenter.x /= leftEyeIndices.size();
-        leftEyeCenter.y /= leftEyeIndices.size();
-        Point rightEyeCenter = {0.0f, 0.0f};
-        std::vector<int> rightEyeIndices = {33, 159, 158, 133, 145, 153};
-        for (int idx : rightEyeIndices) {
-            rightEyeCenter.x += landmarks[idx].x;
-            rightEyeCenter.y += landmarks[idx].y;
-        }
-        rightEyeCenter.x /= rightEyeIndices.size();
-        rightEyeCenter.y /= rightEyeIndices.size();
-        Log::debug("LivenessChecker", "Left eye center: (" + std::to_string(leftEyeCenter.x) + ", " + std::to_string(leftEyeCenter.y) + ")");
-        Log::debug("LivenessChecker", "Right eye center: (" + std::to_string(rightEyeCenter.x) + ", " + std::to_string(rightEyeCenter.y) + ")");
-        float eyesCenterX = (leftEyeCenter.x + rightEyeCenter.x) / 2.0f;
-        float eyesDistance = std::abs(rightEyeCenter.x - leftEyeCenter.x);
-        if (eyesDistance < 1e-3f) {
-            Log::warn("LivenessChecker", "Eyes too close for yaw calculation: " + std::to_string(eyesDistance));
-            return 0.0f;
-        }
-        float delta = noseTip.x - eyesCenterX;
-        float normalizedYaw = delta / eyesDistance;
-        return std::max(-1.0f, std::min(1.0f, normalizedYaw));
-    } catch (const std::exception& e) {
-        Log::error("LivenessChecker", "Head yaw estimation error: " + std::string(e.what()));
-        return 0.0f;
-    }
+void LivenessChecker::unlinkBucket(int slot) {
+    FaceState& s = states_[slot];
+    if (s.bucket < 0) return;
+    if (s.bucketPrev >= 0) states_[s.bucketPrev].bucketNext = s.bucketNext;
+    else buckets_[s.bucket] = s.bucketNext;
+    if (s.bucketNext >= 0) states_[s.bucketNext].bucketPrev = s.bucketPrev;
+    s.bucket = s.bucketPrev = s.bucketNext = -1;
 }
 
-float LivenessChecker::estimateHeadPitch(const std::vector<Point>& landmarks) {
-    if (landmarks.size() != 468) {
-        Log::warn("LivenessChecker", "Invalid landmarks count for MediaPipe: " + std::to_string(landmarks.size()));
-        return 0.0f;
-    }
-    try {
-        const int NOSE_TIP = 1;
-        const int FOREHEAD = 10;
-        const int CHIN = 175;
-        const Point& noseTip = landmarks[NOSE_TIP];
-        const Point& forehead = landmarks[FOREHEAD];
-        const Point& chin = landmarks[CHIN];
-        Log::debug("LivenessChecker", "Pitch landmarks:");
-        Log::debug("LivenessChecker", " Nose [1]: (" + std::to_string(noseTip.x) + ", " + std::to_string(noseTip.y) + ")");
-        Log::debug("LivenessChecker", " Forehead [10]: (" + std::to_string(forehead.x) + ", " + std::to_string(forehead.y) + ")");
-        Log::debug("LivenessChecker", " Chin [175]: (" + std::to_string(chin.x) + ", " + std::to_string(chin.y) + ")");
-        float faceHeight = std::abs(chin.y - forehead.y);
-        if (faceHeight < 1e-3f) {
-            Log::warn("LivenessChecker", "Face height too small for pitch calculation: " + std::to_string(faceHeight));
-            return 0.0f;
+void LivenessChecker::place(int slot, const FaceBox& face) {
+    unlinkBucket(slot);
+    FaceState& s = states_[slot];
+    s.w = static_cast<float>(face.width);
+    s.h = static_cast<float>(face.height);
+    s.cx = face.x + 0.5f * s.w;
+    s.cy = face.y + 0.5f * s.h;
+    const int level = levelOf(s.w, s.h);
+    const float cell = static_cast<float>(1 << level);
+    s.bucket = bucketOf(level, static_cast<int>(std::floor(s.cx / cell)), static_cast<int>(std::floor(s.cy / cell)));
+    s.bucketNext = buckets_[s.bucket];
+    if (s.bucketNext >= 0) states_[s.bucketNext].bucketPrev = slot;
+    buckets_[s.bucket] = slot;
+}
+
+void LivenessChecker::unlinkLru(int slot) {
+    FaceState& s = states_[slot];
+    if (s.lruPrev >= 0) states_[s.lruPrev].lruNext = s.lruNext;
+    else lruHead_ = s.lruNext;
+    if (s.lruNext >= 0) states_[s.lruNext].lruPrev = s.lruPrev;
+    else lruTail_ = s.lruPrev;
+    s.lruPrev = s.lruNext = -1;
+}
+
+void LivenessChecker::pushLru(int slot) {
+    FaceState& s = states_[slot];
+    s.lruPrev = -1;
+    s.lruNext = lruHead_;
+    if (lruHead_ >= 0) states_[lruHead_].lruPrev = slot;
+    lruHead_ = slot;
+    if (lruTail_ < 0) lruTail_ = slot;
+}
+
+LivenessChecker::FaceState& LivenessChecker::stateFor(const FaceBox& face, std::chrono::steady_clock::time_point now) {
+    // Candidates: states within one cell of the face's center, on its own
+    // grid level and the levels next to it (the face may have changed size).
+    const float cx = face.x + 0.5f * face.width;
+    const float cy = face.y + 0.5f * face.height;
+    const int level = levelOf(static_cast<float>(face.width), static_cast<float>(face.height));
+    int best = -1;
+    float bestScore = config_.livenessMinIou;
+    for (int l = std::max(0, level - 1); l <= level + 1; ++l) {
+        const float cell = static_cast<float>(1 << l);
+        const int gx = static_cast<int>(std::floor(cx / cell));
+        const int gy = static_cast<int>(std::floor(cy / cell));
+        for (int dy = -1; dy <= 1; ++dy) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                for (int s = buckets_[bucketOf(l, gx + dx, gy + dy)]; s >= 0; s = states_[s].bucketNext) {
+                    const FaceState& state = states_[s];
+                    // One face per state per frame, and only recently seen states
+                    if (state.lastFrame == frame_ ||
+                        frame_ - state.lastFrame > static_cast<uint64_t>(std::max(0, config_.livenessMaxMissedFrames) + 1)) {
+                        continue;
+                    }
+                    float score;
+                    if (face.trackId >= 0 && state.trackId >= 0) {
+                        if (face.trackId != state.trackId) continue;   // two different people
+                        score = 2.0f;                                  // same track beats any overlap
+                    } else {
+                        score = iou(face, state.cx, state.cy, state.w, state.h);
+                    }
+                    if (score >= bestScore) {
+                        best = s;
+                        bestScore = score;
+                    }
+                }
+            }
         }
-        float faceCenterY = (forehead.y + chin.y) / 2.0f;
-        float normalizedPitch = (noseTip.y - faceCenterY) / faceHeight;
-        return std::max(-1.0f, std::min(1.0f, normalizedPitch));
-    } catch (const std::exception& e) {
-        Log::error("LivenessChecker", "Head pitch estimation error: " + std::string(e.what()));
-        return 0.0f;
     }
+
+    if (best >= 0) {
+        unlinkLru(best);
+    } else if (used_ < states_.size()) {
+        best = static_cast<int>(used_++);
+        states_[best].reset(now);
+    } else {
+        // Slab full: reuse the least recently seen face's slot
+        best = lruTail_;
+        unlinkLru(best);
+        unlinkBucket(best);
+        states_[best].reset(now);
+        NEPTUNE_LOG_DEBUG("LivenessChecker", "Liveness state slab full (" << states_.size() << " faces), evicting the least recently seen face");
+    }
+    pushLru(best);
+    FaceState& state = states_[best];
+    if (face.trackId >= 0) state.trackId = face.trackId;
+    state.lastFrame = frame_;
+    place(best, face);
+    return state;
 }
 
-bool LivenessChecker::detectBlink(float currentEAR) {
+bool LivenessChecker::detectBlink(FaceState& state, float currentEAR) {
     if (currentEAR < 0.0f) {
-        Log::warn("LivenessChecker", "Invalid EAR value, skipping blink detection");
+        NEPTUNE_LOG_WARN("LivenessChecker", "Invalid EAR value, skipping blink detection");
         return false;
     }
-    earHistory_.push_back(currentEAR);
-    if (earHistory_.size() > 15) {
-        earHistory_.pop_front();
-    }
-    Log::debug("LivenessChecker", "Current EAR: " + std::to_string(currentEAR));
+    state.earHistory.push(currentEAR);
+    NEPTUNE_LOG_DEBUG("LivenessChecker", "Current EAR: " << currentEAR);
     // Calibration phase: compute baseline EAR over first 10 frames
-    if (calibrationFrames_ < 10) {
-        baselineEAR_ = (baselineEAR_ * calibrationFrames_ + currentEAR) / (calibrationFrames_ + 1);
-        calibrationFrames_++;
-        Log::debug("LivenessChecker", "Calibrating baseline EAR: " + std::to_string(baselineEAR_) +
-                  ", frame " + std::to_string(calibrationFrames_));
+    if (state.calibrationFrames < 10) {
+        state.baselineEAR = (state.baselineEAR * state.calibrationFrames + currentEAR) / (state.calibrationFrames + 1);
+        state.calibrationFrames++;
+        NEPTUNE_LOG_DEBUG("LivenessChecker", "Calibrating baseline EAR: " << state.baselineEAR << ", frame " << state.calibrationFrames);
         return false; // No blink detection during calibration
     }
-    float adaptiveThreshold = baselineEAR_ * 0.6f; // Adjusted multiplier
+    float adaptiveThreshold = state.baselineEAR * 0.6f; // Adjusted multiplier
     adaptiveThreshold = std::max(0.12f, std::min(adaptiveThreshold, 0.25f)); // Wider range
-    if (earHistory_.size() >= 5) {
+    if (state.earHistory.size() >= 5) {
         float avgEAR = 0.0f;
         float minEAR = std::numeric_limits<float>::max();
         float maxEAR = std::numeric_limits<float>::min();
-        for (float ear : earHistory_) {
+        for (size_t i = 0; i < state.earHistory.size(); ++i) {
+            const float ear = state.earHistory[i];
             avgEAR += ear;
             minEAR = std::min(minEAR, ear);
             maxEAR = std::max(maxEAR, ear);
         }
-        avgEAR /= earHistory_.size();
-        Log::debug("LivenessChecker", "EAR stats: avg=" + std::to_string(avgEAR) +
-                  ", min=" + std::to_string(minEAR) + ", max=" + std::to_string(maxEAR) +
-                  ", baseline=" + std::to_string(baselineEAR_) +
-                  ", threshold=" + std::to_string(adaptiveThreshold) +
-                  ", blink_frames=" + std::to_string(blinkFrameCount_));
+        avgEAR /= state.earHistory.size();
+        NEPTUNE_LOG_DEBUG("LivenessChecker", "EAR stats: avg=" << avgEAR << ", min=" << minEAR << ", max=" << maxEAR << ", baseline=" << state.baselineEAR << ", threshold=" << adaptiveThreshold << ", blink_frames=" << state.blinkFrameCount);
     }
     if (currentEAR < adaptiveThreshold) {
-        blinkFrameCount_++;
-        Log::debug("LivenessChecker", "Eyes closing/closed, frame count: " + std::to_string(blinkFrameCount_));
+        state.blinkFrameCount++;
+        NEPTUNE_LOG_DEBUG("LivenessChecker", "Eyes closing/closed, frame count: " << state.blinkFrameCount);
         return false;
     } else {
-        if (blinkFrameCount_ >= config_.blinkMinFrames && blinkFrameCount_ <= 8) {
-            totalBlinksDetected_++;
-            Log::info("LivenessChecker", "BLINK DETECTED! Closed for " + std::to_string(blinkFrameCount_) +
-                     " frames. EAR dropped to " + std::to_string(currentEAR) + " (threshold: " + std::to_string(adaptiveThreshold) +
-                     "). Total blinks: " + std::to_string(totalBlinksDetected_));
-            blinkFrameCount_ = 0;
+        if (state.blinkFrameCount >= config_.blinkMinFrames && state.blinkFrameCount <= 8) {
+            state.totalBlinksDetected++;
+            NEPTUNE_LOG_INFO("LivenessChecker", "BLINK DETECTED! Closed for " << state.blinkFrameCount << " frames. EAR dropped to " << currentEAR << " (threshold: " << adaptiveThreshold << "). Total blinks: " << state.totalBlinksDetected);
+            state.blinkFrameCount = 0;
             return true;
-        } else if (blinkFrameCount_ > 8) {
-            Log::debug("LivenessChecker", "Too many closed frames (" + std::to_string(blinkFrameCount_) +
-                      ") - sustained eye closure, not a blink");
+        } else if (state.blinkFrameCount > 8) {
+            NEPTUNE_LOG_DEBUG("LivenessChecker", "Too many closed frames (" << state.blinkFrameCount << ") - sustained eye closure, not a blink");
         }
-        blinkFrameCount_ = 0;
+        state.blinkFrameCount = 0;
         return false;
     }
 }
 
-bool LivenessChecker::detectHeadMovement(float currentYaw, float currentPitch) {
-    yawHistory_.push_back(currentYaw);
-    pitchHistory_.push_back(currentPitch);
-    const size_t MAX_HISTORY = 15;
-    if (yawHistory_.size() > MAX_HISTORY) {
-        yawHistory_.pop_front();
-    }
-    if (pitchHistory_.size() > MAX_HISTORY) {
-        pitchHistory_.pop_front();
-    }
-    if (!isInitialized_) {
-        smoothedYaw_ = currentYaw;
-        smoothedPitch_ = currentPitch;
-        lastYaw_ = currentYaw;
-        lastPitch_ = currentPitch;
-        isInitialized_ = true;
-        Log::info("LivenessChecker", "Initialized head pose tracking - Yaw: " + std::to_string(currentYaw) +
-                 ", Pitch: " + std::to_string(currentPitch));
+bool LivenessChecker::detectHeadMovement(FaceState& state, float currentYaw, float currentPitch,
+                                         std::chrono::steady_clock::time_point now) {
+    state.yawHistory.push(currentYaw);
+    state.pitchHistory.push(currentPitch);
+    if (!state.isInitialized) {
+        state.smoothedYaw = currentYaw;
+        state.smoothedPitch = currentPitch;
+        state.lastYaw = currentYaw;
+        state.lastPitch = currentPitch;
+        state.isInitialized = true;
+        NEPTUNE_LOG_INFO("LivenessChecker", "Initialized head pose tracking - Yaw: " << currentYaw << ", Pitch: " << currentPitch);
         return false;
     }
     const float alpha = 0.15f; // Reduced for more responsiveness
-    smoothedYaw_ = alpha * currentYaw + (1.0f - alpha) * smoothedYaw_;
-    smoothedPitch_ = alpha * currentPitch + (1.0f - alpha) * smoothedPitch_;
-    float yawChange = std::abs(smoothedYaw_ - lastYaw_) * 45.0f;
-    float pitchChange = std::abs(smoothedPitch_ - lastPitch_) * 45.0f;
-    Log::debug("LivenessChecker", "Instant changes: Yaw=" + std::to_string(yawChange) +
-              "°, Pitch=" + std::to_string(pitchChange) + "°");
+    state.smoothedYaw = alpha * currentYaw + (1.0f - alpha) * state.smoothedYaw;
+    state.smoothedPitch = alpha * currentPitch + (1.0f - alpha) * state.smoothedPitch;
+    float yawChange = std::abs(state.smoothedYaw - state.lastYaw) * 45.0f;
+    float pitchChange = std::abs(state.smoothedPitch - state.lastPitch) * 45.0f;
+    NEPTUNE_LOG_DEBUG("LivenessChecker", "Instant changes: Yaw=" << yawChange << "°, Pitch=" << pitchChange << "°");
     const float YAW_THRESHOLD = 2.0f; // Lowered for sensitivity
     const float PITCH_THRESHOLD = 1.5f; // Lowered for sensitivity
     bool movementDetected = (yawChange > YAW_THRESHOLD) || (pitchChange > PITCH_THRESHOLD);
     if (movementDetected) {
-        auto now = std::chrono::steady_clock::now();
-        double msSinceLast = std::chrono::duration_cast<std::chrono::milliseconds>(now - lastHeadMoveTime_).count();
+        double msSinceLast = std::chrono::duration_cast<std::chrono::milliseconds>(now - state.lastHeadMoveTime).count();
         if (msSinceLast < 500.0) { // Increased debounce interval
             movementDetected = false;
-            Log::debug("LivenessChecker", "Head movement ignored due to debounce");
+            NEPTUNE_LOG_DEBUG("LivenessChecker", "Head movement ignored due to debounce");
         } else {
-            totalHeadMovements_++;
-            lastHeadMoveTime_ = now;
-            Log::info("LivenessChecker", "HEAD MOVEMENT DETECTED: Yaw=" + std::to_string(yawChange) +
-                     "°, Pitch=" + std::to_string(pitchChange) + "°. Total: " + std::to_string(totalHeadMovements_));
+            state.totalHeadMovements++;
+            state.lastHeadMoveTime = now;
+            NEPTUNE_LOG_INFO("LivenessChecker", "HEAD MOVEMENT DETECTED: Yaw=" << yawChange << "°, Pitch=" << pitchChange << "°. Total: " << state.totalHeadMovements);
         }
     }
-    lastYaw_ = smoothedYaw_;
-    lastPitch_ = smoothedPitch_;
+    state.lastYaw = state.smoothedYaw;
+    state.lastPitch = state.smoothedPitch;
     return movementDetected;
 }
 
 LivenessResult LivenessChecker::check(const FaceBox& face) {
     LivenessResult result;
-    frameCount_++;
+    check(face, result);
+    return result;
+}
+
+void LivenessChecker::check(const FaceBox& face, LivenessResult& result) {
+    ++frame_;
+    checkFace(face, result);
+}
+
+std::vector<LivenessResult> LivenessChecker::checkFrame(const std::vector<FaceBox>& faces) {
+    std::vector<LivenessResult> results;
+    checkFrame(faces, results);
+    return results;
+}
+
+void LivenessChecker::checkFrame(const std::vector<FaceBox>& faces, std::vector<LivenessResult>& results) {
+    ++frame_;
+    results.resize(faces.size());
+    for (size_t i = 0; i < faces.size(); ++i) checkFace(faces[i], results[i]);
+}
+
+void LivenessChecker::checkFace(const FaceBox& face, LivenessResult& result) {
     if (!isVideoMode_) {
         result.status = LivenessStatus::NOT_LIVE;
         result.confidence = 0.95f;
         result.reason = "Static image - no temporal data available";
-        Log::info("LivenessChecker", "Static image detected - marked as NOT_LIVE");
-        return result;
+        NEPTUNE_LOG_INFO("LivenessChecker", "Static image detected - marked as NOT_LIVE");
+        return;
     }
+    // Stream time of the frame: replayed video runs the same as live
+    std::chrono::steady_clock::time_point now = face.detectionTime;
+    if (now == std::chrono::steady_clock::time_point()) {
+        // Unstamped face: a constant time would freeze probation and expiry
+        if (!warnedUnstamped_) {
+            NEPTUNE_LOG_WARN("LivenessChecker", "Face without detectionTime, using the wall clock");
+            warnedUnstamped_ = true;
+        }
+        now = std::chrono::steady_clock::now();
+    }
+    FaceState& state = stateFor(face, now);
+    state.frameCount++;
     if (face.landmarks.empty()) {
         result.status = LivenessStatus::NOT_LIVE;
         result.confidence = 0.8f;
         result.reason = "No landmarks available - cannot verify liveness";
-        return result;
+        return;
     }
-    if (face.landmarks.size() != 468) {
+    if (face.landmarks.size() != kMeshSize) {
         result.status = LivenessStatus::NOT_LIVE;
         result.confidence = 0.8f;
-        result.reason = "Invalid landmark count: " + std::to_string(face.landmarks.size()) + " (expected 468)";
-        Log::error("LivenessChecker", result.reason);
-        return result;
+        setReason(result.reason, "Invalid landmark count: %zu (expected 468)", face.landmarks.size());
+        NEPTUNE_LOG_ERROR("LivenessChecker", result.reason);
+        return;
     }
     try {
-        std::vector<Point> leftEye;
-        std::vector<int> leftEyeIndices = {362, 385, 387, 263, 373, 380};
-        for (int idx : leftEyeIndices) {
-            if (idx < face.landmarks.size()) {
-                leftEye.push_back(face.landmarks[idx]);
-            }
-        }
-        std::vector<Point> rightEye;
-        std::vector<int> rightEyeIndices = {33, 159, 158, 133, 145, 153};
-        for (int idx : rightEyeIndices) {
-            if (idx < face.landmarks.size()) {
-                rightEye.push_back(face.landmarks[idx]);
-            }
-        }
-        if (leftEye.size() != 6 || rightEye.size() != 6) {
-            result.status = LivenessStatus::NOT_LIVE;
-            result.confidence = 0.8f;
-            result.reason = "Could not extract eye landmarks - cannot verify liveness";
-            return result;
-        }
-        float leftEAR = computeEAR(leftEye);
-        float rightEAR = computeEAR(rightEye);
+        const FaceMeasures m = measureFace(face.landmarks.data());
+        const float leftEAR = m.leftEAR;
+        const float rightEAR = m.rightEAR;
         if (leftEAR < 0.0f || rightEAR < 0.0f) {
             result.status = LivenessStatus::NOT_LIVE;
             result.confidence = 0.8f;
             result.reason = "Could not compute EAR values - cannot verify liveness";
-            return result;
+            return;
         }
         float avgEAR = (leftEAR + rightEAR) / 2.0f;
-        Log::debug("LivenessChecker", "EAR: L=" + std::to_string(leftEAR) +
-                  " R=" + std::to_string(rightEAR) + " Avg=" + std::to_string(avgEAR));
-        bool blinkDetected = detectBlink(avgEAR);
-        float currentYaw = estimateHeadYaw(face.landmarks);
-        float currentPitch = estimateHeadPitch(face.landmarks);
-        Log::debug("LivenessChecker", "Head pose: Yaw=" + std::to_string(currentYaw) +
-                  " Pitch=" + std::to_string(currentPitch));
-        bool headMovementDetected = detectHeadMovement(currentYaw, currentPitch);
-        auto now = std::chrono::steady_clock::now();
+        NEPTUNE_LOG_DEBUG("LivenessChecker", "EAR: L=" << leftEAR << " R=" << rightEAR << " Avg=" << avgEAR);
+        bool blinkDetected = detectBlink(state, avgEAR);
+        float currentYaw = m.yaw;
+        float currentPitch = m.pitch;
+        NEPTUNE_LOG_DEBUG("LivenessChecker", "Head pose: Yaw=" << currentYaw << " Pitch=" << currentPitch);
+        bool headMovementDetected = detectHeadMovement(state, currentYaw, currentPitch, now);
         double msSinceFirstDetection = std::chrono::duration_cast<std::chrono::milliseconds>(
-            now - firstDetectionTime_).count();
+            now - state.firstDetectionTime).count();
         double msSinceLastMove = std::chrono::duration_cast<std::chrono::milliseconds>(
-            now - lastHeadMoveTime_).count();
-        Log::debug("LivenessChecker", "Time since first detection: " + std::to_string(msSinceFirstDetection) +
-                  "ms, Time since last move: " + std::to_string(msSinceLastMove) +
-                  "ms, Frame count: " + std::to_string(frameCount_));
+            now - state.lastHeadMoveTime).count();
+        NEPTUNE_LOG_DEBUG("LivenessChecker", "Time since first detection: " << msSinceFirstDetection << "ms, Time since last move: " << msSinceLastMove << "ms, Frame count: " << state.frameCount);
         // Relaxed liveness condition: 1 blink + 1 head movement OR 2 blinks OR 2 head movements
-        if ((totalBlinksDetected_ >= 1 && totalHeadMovements_ >= 1) ||
-            totalBlinksDetected_ >= 2 || totalHeadMovements_ >= 2) {
-            if (!hasProvenLiveness_) {
-                hasProvenLiveness_ = true;
-                Log::info("LivenessChecker", "LIVENESS PROVEN! Blinks: " + std::to_string(totalBlinksDetected_) +
-                         ", Head movements: " + std::to_string(totalHeadMovements_));
+        if ((state.totalBlinksDetected >= 1 && state.totalHeadMovements >= 1) ||
+            state.totalBlinksDetected >= 2 || state.totalHeadMovements >= 2) {
+            if (!state.hasProvenLiveness) {
+                state.hasProvenLiveness = true;
+                NEPTUNE_LOG_INFO("LivenessChecker", "LIVENESS PROVEN! Blinks: " << state.totalBlinksDetected << ", Head movements: " << state.totalHeadMovements);
             }
         }
-        if (!hasProvenLiveness_) {
+        if (!state.hasProvenLiveness) {
             const double PROBATION_PERIOD_MS = 20000.0; // Extended to 20 seconds
             if (msSinceFirstDetection < PROBATION_PERIOD_MS) {
                 result.status = LivenessStatus::NOT_LIVE;
                 result.confidence = 0.60f;
-                result.reason = "Awaiting liveness proof (" +
-                               std::to_string(static_cast<int>((PROBATION_PERIOD_MS - msSinceFirstDetection) / 1000)) +
-                               "s remaining) - please blink and move your head";
-                Log::debug("LivenessChecker", "Still in probation period, awaiting liveness proof");
+                setReason(result.reason, "Awaiting liveness proof (%ds remaining) - please blink and move your head",
+                          static_cast<int>((PROBATION_PERIOD_MS - msSinceFirstDetection) / 1000));
+                NEPTUNE_LOG_DEBUG("LivenessChecker", "Still in probation period, awaiting liveness proof");
             } else {
                 result.status = LivenessStatus::NOT_LIVE;
                 result.confidence = 0.90f;
                 result.reason = "No liveness detected - likely a photo or static image";
-                Log::warn("LivenessChecker", "Probation period expired without liveness proof - marking as NOT_LIVE");
+                NEPTUNE_LOG_WARN("LivenessChecker", "Probation period expired without liveness proof - marking as NOT_LIVE");
             }
         } else {
             if (msSinceLastMove < config_.livenessWindowMs) {
                 result.status = LivenessStatus::LIVE;
-                result.confidence = 0.85f + (totalBlinksDetected_ * 0.02f) + (totalHeadMovements_ * 0.03f);
+                result.confidence = 0.85f + (state.totalBlinksDetected * 0.02f) + (state.totalHeadMovements * 0.03f);
                 result.confidence = std::min(0.98f, result.confidence);
-                result.reason = "Liveness confirmed (blinks: " + std::to_string(totalBlinksDetected_) +
-                               ", movements: " + std::to_string(totalHeadMovements_) + ")";
+                setReason(result.reason, "Liveness confirmed (blinks: %d, movements: %d)",
+                          state.totalBlinksDetected, state.totalHeadMovements);
             } else {
                 result.status = LivenessStatus::NOT_LIVE;
                 result.confidence = 0.75f;
-                result.reason = "Liveness expired - no recent movement for " +
-                               std::to_string(msSinceLastMove) + "ms (had proven liveness before)";
+                setReason(result.reason, "Liveness expired - no recent movement for %fms (had proven liveness before)",
+                          msSinceLastMove);
                 if (msSinceLastMove > config_.livenessWindowMs * 2) {
-                    Log::info("LivenessChecker", "Resetting liveness proof due to extended inactivity");
-                    hasProvenLiveness_ = false;
-                    totalBlinksDetected_ = 0;
-                    totalHeadMovements_ = 0;
-                    firstDetectionTime_ = now;
+                    NEPTUNE_LOG_INFO("LivenessChecker", "Resetting liveness proof due to extended inactivity");
+                    state.hasProvenLiveness = false;
+                    state.totalBlinksDetected = 0;
+                    state.totalHeadMovements = 0;
+                    state.firstDetectionTime = now;
                 }
             }
         }
     } catch (const std::exception& e) {
-        Log::error("LivenessChecker", "Liveness check error: " + std::string(e.what()));
+        NEPTUNE_LOG_ERROR("LivenessChecker", "Liveness check error: " << e.what());
         result.status = LivenessStatus::NOT_LIVE;
         result.confidence = 0.8f;
         result.reason = "Processing error - cannot verify liveness: " + std::string(e.what());
     }
-    return result;
 }
\ No newline at end of file
@@ -17,9 +17,7 @@ std::vector<Point> MediaPipeLandmarks::extractEyeLandmarks(const std::vector<Poi
         if (index < static_cast<int>(landmarks.size())) {
             eyePoints.push_back(landmarks[index]);
         } else {
-            Log::warn("MediaPipeLandmarks", 
-                        "Landmark index " + std::to_string(index) + 
-                        " out of bounds (total: " + std::to_string(landmarks.size()) + ")");
+            NEPTUNE_LOG_WARN("MediaPipeLandmarks", "Landmark index " << index << " out of bounds (total: " << landmarks.size() << ")");
         }
     }
     
@@ -28,7 +26,7 @@ std::vector<Point> MediaPipeLandmarks::extractEyeLandmarks(const std::vector<Poi
 
 Point MediaPipeLandmarks::calculateEyeCenter(const std::vector<Point>& eyeLandmarks) {
     if (eyeLandmarks.empty()) {
-        Log::warn("MediaPipeLandmarks", "Empty eye landmarks for center calculation");
+        NEPTUNE_LOG_WARN("MediaPipeLandmarks", "Empty eye landmarks for center calculation");
         return Point(0, 0);
     }
     
@@ -46,9 +44,7 @@ Point MediaPipeLandmarks::calculateEyeCenter(const std::vector<Point>& eyeLandma
 
 float MediaPipeLandmarks::calculateEAR(const std::vector<Point>& eyeLandmarks) {
     if (eyeLandmarks.size() < 16) {
-        Log::warn("MediaPipeLandmarks", 
-                    "Insufficient eye landmarks for EAR calculation: " + 
-                    std::to_string(eyeLandmarks.size()));
+        NEPTUNE_LOG_WARN("MediaPipeLandmarks", "Insufficient eye landmarks for EAR calculation: " << eyeLandmarks.size());
         return 1.0f;
     }
     
@@ -69,28 +65,26 @@ float MediaPipeLandmarks::calculateEAR(const std::vector<Point>& eyeLandmarks) {
         float horizontal = dist(eyeLandmarks[0], eyeLandmarks[4]);
         
         if (horizontal < 1.0f) {
-            Log::warn("MediaPipeLandmarks", "Horizontal eye distance too small: " + std::to_string(horizontal));
+            NEPTUNE_LOG_WARN("MediaPipeLandmarks", "Horizontal eye distance too small: " << horizontal);
             return 1.0f;
         }
         
         return (vertical1 + vertical2 + vertical3) / (3.0f * horizontal);
         
     } catch (const std::exception& e) {
-        Log::error("MediaPipeLandmarks", "EAR calculation error: " + std::string(e.what()));
+        NEPTUNE_LOG_ERROR("MediaPipeLandmarks", "EAR calculation error: " << e.what());
         return 1.0f;
     }
 }
 
 bool MediaPipeLandmarks::validateLandmarks(const std::vector<Point>& landmarks, int expectedCount) {
     if (landmarks.empty()) {
-        Log::warn("MediaPipeLandmarks", "No landmarks provided for validation");
+        NEPTUNE_LOG_WARN("MediaPipeLandmarks", "No landmarks provided for validation");
         return false;
     }
     
     if (expectedCount > 0 && landmarks.size() != static_cast<size_t>(expectedCount)) {
-        Log::warn("MediaPipeLandmarks", 
-                    "Expected " + std::to_string(expectedCount) + 
-                    " landmarks, got " + std::to_string(landmarks.size()));
+        NEPTUNE_LOG_WARN("MediaPipeLandmarks", "Expected " << expectedCount << " landmarks, got " << landmarks.size());
         return false;
     }
     
@@ -100,17 +94,13 @@ bool MediaPipeLandmarks::validateLandmarks(const std::vector<Point>& landmarks,
         
         if (std::isnan(point.x) || std::isnan(point.y) ||
             std::isinf(point.x) || std::isinf(point.y)) {
-            Log::warn("MediaPipeLandmarks", 
-                        "Invalid landmark at index " + std::to_string(i) + 
-                        ": (" + std::to_string(point.x) + ", " + std::to_string(point.y) + ")");
+            NEPTUNE_LOG_WARN("MediaPipeLandmarks", "Invalid landmark at index " << i << ": (" << point.x << ", " << point.y << ")");
             return false;
         }
         
         // Check for reasonable coordinate values (assuming image coordinates)
         if (point.x < -1000 || point.x > 10000 || point.y < -1000 || point.y > 10000) {
-            Log::warn("MediaPipeLandmarks", 
-                        "Suspicious landmark value at index " + std::to_string(i) + 
-                        ": (" + std::to_string(point.x) + ", " + std::to_string(point.y) + ")");
+            NEPTUNE_LOG_WARN("MediaPipeLandmarks", "Suspicious landmark value at index " << i << ": (" << point.x << ", " << point.y << ")");
             return false;
         }
     }
@@ -136,9 +126,7 @@ std::vector<Point> MediaPipeLandmarks::extractLipLandmarks(const std::vector<Poi
 
 float MediaPipeLandmarks::calculateMAR(const std::vector<Point>& lipLandmarks) {
     if (lipLandmarks.size() < 20) {
-        Log::warn("MediaPipeLandmarks", 
-                    "Insufficient lip landmarks for MAR calculation: " + 
-                    std::to_string(lipLandmarks.size()));
+        NEPTUNE_LOG_WARN("MediaPipeLandmarks", "Insufficient lip landmarks for MAR calculation: " << lipLandmarks.size());
         return 0.0f;
     }
     
@@ -164,7 +152,7 @@ float MediaPipeLandmarks::calculateMAR(const std::vector<Point>& lipLandmarks) {
         return (vertical1 + vertical2 + vertical3) / (3.0f * horizontal);
         
     } catch (const std::exception& e) {
-        Log::error("MediaPipeLandmarks", "MAR calculation error: " + std::string(e.what()));
+        NEPTUNE_LOG_ERROR("MediaPipeLandmarks", "MAR calculation error: " << e.what());
         return 0.0f;
     }
 }
@@ -7,6 +7,10 @@
 
 #include "neptune/NeptuneSDK.h"
 #include "neptune/LivenessChecker.h"
+#include "neptune/ModelRegistry.h"
+
+#include <chrono>
+#include <future>
 
 
 namespace neptune {
@@ -18,16 +22,64 @@ NeptuneSDK::NeptuneSDK(const NeptuneConfig& config) : config_(config) {}
 std::unique_ptr<NeptuneSDK> NeptuneSDK::create(const NeptuneConfig& config) {
     auto sdk = std::unique_ptr<NeptuneSDK>(new NeptuneSDK(config));
     if (!sdk->init()) {
-        Log::error("NeptuneSDK", "Failed to initialize SDK");
+        NEPTUNE_LOG_ERROR("NeptuneSDK", "Failed to initialize SDK");
         return nullptr;
     }
     return sdk;
 }
 
 bool NeptuneSDK::init() {
-    faceDetector_ = FaceDetector::create(config_.faceDetectionModelPath, config_);
-    emotionRecognizer_ = EmotionRecognizer::create(config_.emotionModelPath, config_);
+    const auto start = std::chrono::steady_clock::now();
+    if (config_.asyncLogging) Log::startAsync();
+
+    if (config_.parallelInit) {
+        // Models are independent: load, allocate and warm them up concurrently.
+        auto detector = std::async(std::launch::async, [this] {
+            return FaceDetector::create(config_.faceDetectionModelPath, config_);
+        });
+        auto emotion = std::async(std::launch::async, [this] {
+            return EmotionRecognizer::create(config_.emotionModelPath, config_);
+        });
+        auto landmarks = std::async(std::launch::async, [this] { return createLandmarkExtractor(); });
+        faceDetector_ = detector.get();
+        emotionRecognizer_ = emotion.get();
+        landmarkExtractor_ = landmarks.get();
+    } else {
+        faceDetector_ = FaceDetector::create(config_.faceDetectionModelPath, config_);
+        emotionRecognizer_ = EmotionRecognizer::create(config_.emotionModelPath, config_);
+        landmarkExtractor_ = createLandmarkExtractor();
+    }
     livenessChecker_ = std::make_unique<LivenessChecker>(config_);
+    if (config_.trackIdentities) faceTracker_ = std::make_unique<FaceTracker>(config_);
+
+    if (config_.trackFaces) {
+        if (faceDetector_ && landmarkExtractor_) {
+            tracker_ = std::make_unique<LandmarkTracker>(*faceDetector_, *landmarkExtractor_, config_);
+        } else {
+            NEPTUNE_LOG_WARN("NeptuneSDK", "trackFaces needs a face landmark model, detecting on every frame");
+        }
+    }
+
+    startupReport_ = StartupReport();
+    startupReport_.parallel = config_.parallelInit;
+    if (faceDetector_) startupReport_.models.push_back(faceDetector_->startupTiming());
+    if (emotionRecognizer_) startupReport_.models.push_back(emotionRecognizer_->startupTiming());
+    if (landmarkExtractor_) startupReport_.models.push_back(landmarkExtractor_->startupTiming());
+    startupReport_.totalMs =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    for (const auto& m : startupReport_.models) {
+        NEPTUNE_LOG_INFO("NeptuneSDK", "Startup " << m.model << ": load " << m.loadMs << " ms, allocate " << m.allocateMs << " ms, first invoke " << m.firstInvokeMs << " ms");
+    }
+    NEPTUNE_LOG_INFO("NeptuneSDK", "Startup total " << startupReport_.totalMs << " ms (" << (startupReport_.parallel ? "parallel" : "sequential") << ")");
+
+    if (faceDetector_) {
+        NEPTUNE_LOG_INFO("NeptuneSDK", "Face detector backend: " << TfLiteEngine::backendName(faceDetector_->backend()));
+    }
+    if (emotionRecognizer_) {
+        NEPTUNE_LOG_INFO("NeptuneSDK", "Emotion recognizer backend: " << TfLiteEngine::backendName(emotionRecognizer_->backend()));
+    }
+    ModelRegistry::instance().logStats();
     
     return faceDetector_ && emotionRecognizer_;
 
@@ -35,21 +87,59 @@ bool NeptuneSDK::init() {
 }
 
 
+std::unique_ptr<LandmarkExtractor> NeptuneSDK::createLandmarkExtractor() const {
+    if (config_.faceLandmarkModelPath.empty()) return nullptr;
+    auto extractor = std::make_unique<LandmarkExtractor>(config_.faceLandmarkModelPath, config_);
+    if (!extractor->isLoaded()) {
+        NEPTUNE_LOG_ERROR("NeptuneSDK", "Failed to load face landmark model: " << config_.faceLandmarkModelPath);
+        return nullptr;
+    }
+    return extractor;
+}
+
 std::vector<NeptuneResult> NeptuneSDK::processImage(const cv::Mat& image) {
+    return process(image, std::chrono::steady_clock::now());
+}
+
+std::vector<NeptuneResult> NeptuneSDK::processImage(const cv::Mat& image, std::chrono::steady_clock::time_point timestamp) {
+    return process(image, timestamp);
+}
+
+std::vector<NeptuneResult> NeptuneSDK::processFrame(const YuvFrame& frame) {
+    return processFrame(frame, std::chrono::steady_clock::now());
+}
+
+std::vector<NeptuneResult> NeptuneSDK::processFrame(const YuvFrame& frame, std::chrono::steady_clock::time_point timestamp) {
+    if (!frame.valid()) {
+        NEPTUNE_LOG_ERROR("NeptuneSDK", "processFrame: invalid YUV frame");
+        return {};
+    }
+    return process(frame, timestamp);
+}
+
+template <typename Image>
+std::vector<NeptuneResult> NeptuneSDK::process(const Image& image, std::chrono::steady_clock::time_point timestamp) {
     std::vector<NeptuneResult> results;
 
-    auto faces = faceDetector_->detectFaces(image);
-    for (const auto& face : faces) {
-        cv::Rect roi(face.x, face.y, face.width, face.height);
-        cv::Mat faceCrop = image(roi).clone();
+    auto faces = tracker_ ? tracker_->track(image) : faceDetector_->detectFaces(image);
+    for (FaceBox& face : faces) face.detectionTime = timestamp;
+    if (faceTracker_) faceTracker_->update(faces);
+
+    // All faces of the frame go through the emotion model in one batch,
+    // each crop aligned on the face's eye keypoints.
+    std::vector<EmotionResult> emotions = emotionRecognizer_->predictEmotions(image, faces);
+
+    // Each face keeps its own blink and head-movement state across frames.
+    std::vector<LivenessResult> liveness = livenessChecker_->checkFrame(faces);
 
-        EmotionResult emotion = emotionRecognizer_->predictEmotion(faceCrop);
-        LivenessResult live = livenessChecker_->check(face);
+    results.reserve(faces.size());
+    for (size_t i = 0; i < faces.size(); ++i) {
+        const auto& face = faces[i];
         NeptuneResult processed;
         processed.hasFace = true;
         processed.faceBox = face;
-        processed.emotion = emotion;
-        processed.liveness = live;
+        processed.emotion = emotions[i];
+        processed.liveness = liveness[i];
 
         results.push_back(processed);
     }
@@ -0,0 +1,198 @@
+//
+// File: NeptuneFacialSDK/core/src/NonMaxSuppression.cpp
+//
+// Greedy NMS as a sweep in score order: a candidate joins the first kept face
+// (in score order) it overlaps by more than the IoU threshold, and otherwise
+// becomes a kept face itself. That is the same result as the usual "take the
+// best, drop or merge its overlaps, repeat" loop, but each candidate is only
+// tested against kept faces, and with the grid only against nearby ones.
+//
+
+#include "neptune/NonMaxSuppression.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace neptune {
+
+namespace {
+
+constexpr size_t kGridMinCandidates = 128;   // below this, scanning the kept faces is cheaper
+constexpr int kMaxGridSide = 64;             // cells per grid row/column
+constexpr int kSums = 4 + FaceDetection::kKeypoints * 2;
+
+// One kept face and, in weighted mode, the score-weighted sums of its members.
+struct Cluster {
+    int seed;
+    float weight;
+    float sums[kSums];
+};
+
+float iou(const FaceDetection& a, const FaceDetection& b) {
+    const int interW = std::max(0, std::min(a.x2, b.x2) - std::max(a.x1, b.x1));
+    const int interH = std::max(0, std::min(a.y2, b.y2) - std::max(a.y1, b.y1));
+    const float inter = static_cast<float>(interW) * interH;
+    const float areaA = static_cast<float>(a.width()) * a.height();
+    const float areaB = static_cast<float>(b.width()) * b.height();
+    return inter / (areaA + areaB - inter + 1e-6f);
+}
+
+void accumulate(Cluster& cluster, const FaceDetection& d) {
+    const float w = d.score;
+    cluster.weight += w;
+    cluster.sums[0] += w * d.x1;
+    cluster.sums[1] += w * d.y1;
+    cluster.sums[2] += w * d.x2;
+    cluster.sums[3] += w * d.y2;
+    for (int k = 0; k < FaceDetection::kKeypoints * 2; ++k) cluster.sums[4 + k] += w * d.keypoints[k];
+}
+
+// Uniform grid over the candidates' extent. Each cell lists the clusters
+// whose seed box touches it, as linked entries in flat arrays.
+class SeedGrid {
+public:
+    void reset(const std::vector<FaceDetection>& candidates) {
+        int x1 = candidates[0].x1, y1 = candidates[0].y1, x2 = candidates[0].x2, y2 = candidates[0].y2;
+        double side = 0.0;
+        for (const FaceDetection& d : candidates) {
+            x1 = std::min(x1, d.x1); y1 = std::min(y1, d.y1);
+            x2 = std::max(x2, d.x2); y2 = std::max(y2, d.y2);
+            side += std::max(d.width(), d.height());
+        }
+        // Cells about the size of an average candidate: most boxes touch at most four.
+        const float cell = std::max(1.0f, static_cast<float>(side / candidates.size()));
+        originX_ = static_cast<float>(x1);
+        originY_ = static_cast<float>(y1);
+        cols_ = std::clamp(static_cast<int>(std::ceil((x2 - x1) / cell)), 1, kMaxGridSide);
+        rows_ = std::clamp(static_cast<int>(std::ceil((y2 - y1) / cell)), 1, kMaxGridSide);
+        cellW_ = std::max(1.0f, static_cast<float>(x2 - x1) / cols_);
+        cellH_ = std::max(1.0f, static_cast<float>(y2 - y1) / rows_);
+        head_.assign(static_cast<size_t>(cols_) * rows_, -1);
+        entryCluster_.clear();
+        entryNext_.clear();
+    }
+
+    void add(const FaceDetection& box, int cluster) {
+        int c0, r0, c1, r1;
+        cellRange(box, c0, r0, c1, r1);
+        for (int r = r0; r <= r1; ++r) {
+            for (int c = c0; c <= c1; ++c) {
+                int& head = head_[static_cast<size_t>(r) * cols_ + c];
+                entryCluster_.push_back(cluster);
+                entryNext_.push_back(head);
+                head = static_cast<int>(entryCluster_.size()) - 1;
+            }
+        }
+    }
+
+    // Calls fn(cluster) for every cluster sharing a cell with `box`; a
+    // cluster spanning several of those cells is visited once per cell.
+    template <typename Fn>
+    void forEachNear(const FaceDetection& box, Fn&& fn) const {
+        int c0, r0, c1, r1;
+        cellRange(box, c0, r0, c1, r1);
+        for (int r = r0; r <= r1; ++r) {
+            for (int c = c0; c <= c1; ++c) {
+                for (int e = head_[static_cast<size_t>(r) * cols_ + c]; e >= 0; e = entryNext_[e]) {
+                    fn(entryCluster_[e]);
+                }
+            }
+        }
+    }
+
+private:
+    void cellRange(const FaceDetection& box, int& c0, int& r0, int& c1, int& r1) const {
+        c0 = std::clamp(static_cast<int>((box.x1 - originX_) / cellW_), 0, cols_ - 1);
+        r0 = std::clamp(static_cast<int>((box.y1 - originY_) / cellH_), 0, rows_ - 1);
+        c1 = std::clamp(static_cast<int>((box.x2 - originX_) / cellW_), 0, cols_ - 1);
+        r1 = std::clamp(static_cast<int>((box.y2 - originY_) / cellH_), 0, rows_ - 1);
+    }
+
+    float originX_ = 0.0f, originY_ = 0.0f;
+    float cellW_ = 1.0f, cellH_ = 1.0f;
+    int cols_ = 1, rows_ = 1;
+    std::vector<int> head_;
+    std::vector<int> entryCluster_;
+    std::vector<int> entryNext_;
+};
+
+} // namespace
+
+void nonMaxSuppression(const std::vector<FaceDetection>& candidates, const NmsOptions& options,
+                       std::vector<FaceDetection>& out) {
+    if (candidates.empty()) return;
+    const int n = static_cast<int>(candidates.size());
+    const size_t maxClusters = options.maxDetections > 0 ? static_cast<size_t>(options.maxDetections)
+                                                         : candidates.size();
+    const bool weighted = options.mode == NmsMode::WEIGHTED;
+
+    // Sort keys: the score's bits inverted (scores are non-negative, so their
+    // bit patterns order like the values), then the index, which keeps ties
+    // in candidate order and the sort free of indirection.
+    thread_local std::vector<uint64_t> order;
+    thread_local std::vector<Cluster> clusters;
+    thread_local SeedGrid grid;
+    order.resize(n);
+    for (int i = 0; i < n; ++i) {
+        uint32_t bits;
+        std::memcpy(&bits, &candidates[i].score, sizeof(bits));
+        order[i] = (static_cast<uint64_t>(~bits) << 32) | static_cast<uint32_t>(i);
+    }
+    std::sort(order.begin(), order.end());
+    clusters.clear();
+
+    // With few kept faces allowed, scanning them all beats maintaining the grid.
+    const bool useGrid = candidates.size() >= kGridMinCandidates && maxClusters > 8;
+    if (useGrid) grid.reset(candidates);
+
+    for (uint64_t key : order) {
+        const int i = static_cast<int>(key & 0xffffffffu);
+        const bool full = clusters.size() >= maxClusters;
+        if (full && !weighted) break;
+
+        // Earliest (best) kept face this candidate overlaps enough to join.
+        const FaceDetection& d = candidates[i];
+        int owner = -1;
+        if (useGrid) {
+            grid.forEachNear(d, [&](int c) {
+                if ((owner < 0 || c < owner) && iou(candidates[clusters[c].seed], d) > options.iouThreshold) owner = c;
+            });
+        } else {
+            for (size_t c = 0; c < clusters.size(); ++c) {
+                if (iou(candidates[clusters[c].seed], d) > options.iouThreshold) {
+                    owner = static_cast<int>(c);
+                    break;
+                }
+            }
+        }
+
+        if (owner >= 0) {
+            if (weighted) accumulate(clusters[owner], d);
+            continue;
+        }
+        // Once full, weighted mode only keeps sweeping to blend members into the kept faces.
+        if (full) continue;
+
+        Cluster& cluster = clusters.emplace_back();
+        cluster.seed = i;
+        cluster.weight = 0.0f;
+        std::fill(std::begin(cluster.sums), std::end(cluster.sums), 0.0f);
+        if (weighted) accumulate(cluster, d);
+        if (useGrid) grid.add(d, static_cast<int>(clusters.size()) - 1);
+    }
+
+    for (const Cluster& cluster : clusters) {
+        FaceDetection& kept = out.emplace_back(candidates[cluster.seed]);
+        if (!weighted || cluster.weight <= 0.0f) continue;
+        const float inv = 1.0f / cluster.weight;
+        kept.x1 = static_cast<int>(std::lround(cluster.sums[0] * inv));
+        kept.y1 = static_cast<int>(std::lround(cluster.sums[1] * inv));
+        kept.x2 = static_cast<int>(std::lround(cluster.sums[2] * inv));
+        kept.y2 = static_cast<int>(std::lround(cluster.sums[3] * inv));
+        for (int k = 0; k < FaceDetection::kKeypoints * 2; ++k) kept.keypoints[k] = cluster.sums[4 + k] * inv;
+    }
+}
+
+} // namespace neptune
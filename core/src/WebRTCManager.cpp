@@ -1,34 +1,41 @@
 #include "neptune/WebRTCManager.h"
+#include "neptune/EmbeddedModels.h"
 #include <iostream>
 #include <chrono>
 
 using namespace neptune;
 
-WebRTCManager::WebRTCManager()
-    : config(), // Initialize config (if it has a default constructor)
-      detector(nullptr), // Initialize unique_ptr to nullptr
-      emo(nullptr), // Initialize unique_ptr to nullptr
-      liveness(config), // Initialize liveness with config
-      landmarkExtractor("../../models/face_landmark.tflite") // Initialize landmarkExtractor
-{
-    // 1. Move your configuration code here
-    const std::string faceModelPath = "../../models/face_detection_short_range.tflite";
-    const std::string landmarkModelPath = "../../models/face_landmark.tflite";
-    const std::string emotionModelPath = "../../models/mobilenet_emotion.tflite";
-
-    config.faceDetectionModelPath = faceModelPath;
-    config.emotionModelPath = emotionModelPath;
+// 1. Configuration, applied before any member is built from it
+NeptuneConfig WebRTCManager::streamConfig(NeptuneConfig config) {
+    // Prefer models compiled into the library; fall back to the source tree.
+    config.faceDetectionModelPath =
+        embeddedOrPath("face_detection_short_range", "../../models/face_detection_short_range.tflite");
+    config.emotionModelPath = embeddedOrPath("mobilenet_emotion", "../../models/mobilenet_emotion.tflite");
     config.faceDetectorBackend = FaceDetectorBackend::MEDIAPIPE;
     config.earClosedThreshold = 0.25f;
     config.blinkMinFrames = 2;
     config.headYawChangeMinDeg = 20.0f;
     config.headPitchChangeMinDeg = 15.0f;
     config.livenessWindowMs = 3000.0;
+    config.trackFaces = true;
+    return config;
+}
 
+WebRTCManager::WebRTCManager(const NeptuneConfig& base)
+    : config(streamConfig(base)),
+      detector(nullptr), // Initialize unique_ptr to nullptr
+      emo(nullptr), // Initialize unique_ptr to nullptr
+      liveness(config), // Initialize liveness with config
+      landmarkExtractor(embeddedOrPath("face_landmark", "../../models/face_landmark.tflite"), config)
+{
     // 2. Move your AI initialization code here
-    detector = FaceDetector::create(faceModelPath, config);
-    emo = EmotionRecognizer::create(emotionModelPath, config);
-    LandmarkExtractor landmarkExtractor(landmarkModelPath);
+    detector = FaceDetector::create(config.faceDetectionModelPath, config);
+    emo = EmotionRecognizer::create(config.emotionModelPath, config);
+
+    // Frames come from one video stream: detect once, then follow faces from their landmarks
+    if (detector && landmarkExtractor.isLoaded()) {
+        tracker = std::make_unique<LandmarkTracker>(*detector, landmarkExtractor, config);
+    }
 
     // 3. Initialize Liveness checker for video mode
     liveness.setVideoMode(true); // We are in video mode
@@ -50,26 +57,39 @@ bool WebRTCManager::start() {
 
 void WebRTCManager::onFrameReceived(cv::Mat &frame) {
     // This is the exact same logic from your video loop, but now it processes a frame from the phone
-    auto faces = detector->detectFaces(frame);
+    const auto frameTime = std::chrono::steady_clock::now();
+    std::vector<FaceBox> faces;
+    if (tracker) {
+        // Faces come back with their landmarks; the detector only runs when one is lost or new ones are due.
+        faces = tracker->track(frame);
+    } else {
+        faces = detector->detectFaces(frame);
+
+        // Landmarks run once per frame for all faces (batched),
+        // on crops rotated to the detected eye keypoints.
+        auto landmarks2D = landmarkExtractor.processBatch(frame, faces);
+        for (size_t i = 0; i < faces.size(); ++i) faces[i].landmarks = std::move(landmarks2D[i]);
+    }
 
+    std::vector<FaceBox> emotionBoxes;
+    std::vector<size_t> emotionFaces;
     for (size_t i = 0; i < faces.size(); ++i) {
-        const auto& f = faces[i];
-        cv::Rect r = clampRect(cv::Rect(f.x, f.y, f.width, f.height), frame.size());
-
-        auto landmarks2D = landmarkExtractor.Process(frame, r);
-        faces[i].landmarks.clear();
-        for (auto& p : landmarks2D) {
-            faces[i].landmarks.push_back(Point{p.x, p.y});
+        faces[i].detectionTime = frameTime;
+        if (!faces[i].landmarks.empty()) {
+            emotionBoxes.push_back(faces[i]);   // now aligned on the mesh's eye corners
+            emotionFaces.push_back(i);
         }
+    }
+    auto emotions = emo->predictEmotions(frame, emotionBoxes);
 
-        if (!faces[i].landmarks.empty()) {
-            cv::Mat faceROI = frame(r).clone();
-            auto er = emo->predictEmotion(faceROI);
-            auto live = liveness.check(faces[i]);
+    // One liveness state per face, carried across frames by box overlap
+    auto liveResults = liveness.checkFrame(emotionBoxes);
 
-            std::cout << "RESULT FOR PHONE: Emotion=" << emotionToString(er.emotion)
-                      << " | Liveness=" << livenessToString(live) << std::endl;
-        }
+    for (size_t k = 0; k < emotionFaces.size(); ++k) {
+        const auto& live = liveResults[k];
+
+        std::cout << "RESULT FOR PHONE: Emotion=" << emotionToString(emotions[k].emotion)
+                  << " | Liveness=" << livenessToString(live) << std::endl;
     }
 }
 
@@ -8,10 +8,435 @@
 #include "neptune/Preprocess.h"
 #include "neptune/Log.h"
 
-using neptune::Log;  
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#define NEPTUNE_PREPROCESS_SSE2 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define NEPTUNE_PREPROCESS_NEON 1
+#endif
 
 namespace neptune {
     namespace img {
+
+    namespace {
+
+    // Bilinear source taps of one output column or row, using cv::resize's
+    // INTER_LINEAR convention (pixel centers aligned, edges clamped) so the
+    // fused path samples the same pixels as the two-step one.
+    struct LinearTap {
+        int i0;
+        int i1;
+        float w1;   // weight of i1; i0 gets 1 - w1
+    };
+
+    void computeTaps(int srcSize, int dstSize, std::vector<LinearTap>& taps) {
+        taps.resize(dstSize);
+        const double scale = static_cast<double>(srcSize) / dstSize;
+        for (int d = 0; d < dstSize; ++d) {
+            const float f = static_cast<float>((d + 0.5) * scale - 0.5);
+            int i = static_cast<int>(std::floor(f));
+            float w = f - i;
+            if (i < 0) { i = 0; w = 0.0f; }
+            if (i >= srcSize - 1) { i = srcSize - 1; w = 0.0f; }
+            taps[d] = {i, std::min(i + 1, srcSize - 1), w};
+        }
+    }
+
+    // Horizontal pass: one BGR source row resampled to taps.size() pixels,
+    // as unnormalized floats already in output channel order.
+    void resampleRow(const uint8_t* src, const LinearTap* taps, int width, bool swapRB, float* out) {
+        const int first = swapRB ? 2 : 0;
+        const int last = swapRB ? 0 : 2;
+        for (int x = 0; x < width; ++x, out += 3) {
+            const uint8_t* p0 = src + taps[x].i0 * 3;
+            const uint8_t* p1 = src + taps[x].i1 * 3;
+            const float w1 = taps[x].w1;
+            const float w0 = 1.0f - w1;
+            out[0] = p0[first] * w0 + p1[first] * w1;
+            out[1] = p0[1] * w0 + p1[1] * w1;
+            out[2] = p0[last] * w0 + p1[last] * w1;
+        }
+    }
+
+    // BT.601 limited-range YUV -> BGR in OpenCV's fixed point, so sampled
+    // pixels match cv::cvtColor(..., COLOR_YUV2BGR_NV12) exactly.
+    constexpr int kYuvShift = 20;
+    constexpr int kYuvCY = 1220542;
+    constexpr int kYuvCUB = 2116026;
+    constexpr int kYuvCUG = -409993;
+    constexpr int kYuvCVG = -852492;
+    constexpr int kYuvCVR = 1673527;
+
+    inline int clampByte(int v) { return std::min(255, std::max(0, v)); }
+
+    inline void yuvToBgr(int y, int u, int v, int bgr[3]) {
+        const int luma = std::max(0, y - 16) * kYuvCY + (1 << (kYuvShift - 1));
+        u -= 128;
+        v -= 128;
+        bgr[0] = clampByte((luma + kYuvCUB * u) >> kYuvShift);
+        bgr[1] = clampByte((luma + kYuvCVG * v + kYuvCUG * u) >> kYuvShift);
+        bgr[2] = clampByte((luma + kYuvCVR * v) >> kYuvShift);
+    }
+
+    // Row sources for the fused kernel: resample row `row` of the region
+    // being scaled into `out` (see resampleRow).
+    struct BgrRows {
+        const uint8_t* data;
+        size_t step;
+
+        void operator()(int row, const LinearTap* taps, int width, bool swapRB, float* out) const {
+            resampleRow(data + step * row, taps, width, swapRB, out);
+        }
+
+        void pixel(int x, int y, int bgr[3]) const {
+            const uint8_t* p = data + step * y + x * 3;
+            bgr[0] = p[0];
+            bgr[1] = p[1];
+            bgr[2] = p[2];
+        }
+    };
+
+    // Converts only the pixels the taps touch, so a small crop of a large
+    // frame costs a few hundred conversions instead of a full-frame cvtColor.
+    struct YuvRows {
+        const YuvFrame& frame;
+        int x0;   // region origin in the frame
+        int y0;
+
+        void operator()(int row, const LinearTap* taps, int width, bool swapRB, float* out) const {
+            const int y = y0 + row;
+            const uint8_t* luma = frame.y + static_cast<size_t>(y) * frame.yStride;
+            const uint8_t* cb;
+            const uint8_t* cr;
+            int chromaStep = 2;
+            if (frame.format == YuvFormat::I420) {
+                cb = frame.u + static_cast<size_t>(y / 2) * frame.uStride;
+                cr = frame.v + static_cast<size_t>(y / 2) * frame.vStride;
+                chromaStep = 1;
+            } else {
+                const uint8_t* chroma = frame.u + static_cast<size_t>(y / 2) * frame.uStride;
+                cb = frame.format == YuvFormat::NV12 ? chroma : chroma + 1;
+                cr = frame.format == YuvFormat::NV12 ? chroma + 1 : chroma;
+            }
+
+            const int first = swapRB ? 2 : 0;
+            const int last = swapRB ? 0 : 2;
+            int p0[3], p1[3];
+            for (int x = 0; x < width; ++x, out += 3) {
+                const int x1 = x0 + taps[x].i0;
+                const int x2 = x0 + taps[x].i1;
+                yuvToBgr(luma[x1], cb[(x1 / 2) * chromaStep], cr[(x1 / 2) * chromaStep], p0);
+                yuvToBgr(luma[x2], cb[(x2 / 2) * chromaStep], cr[(x2 / 2) * chromaStep], p1);
+                const float w1 = taps[x].w1;
+                const float w0 = 1.0f - w1;
+                out[0] = p0[first] * w0 + p1[first] * w1;
+                out[1] = p0[1] * w0 + p1[1] * w1;
+                out[2] = p0[last] * w0 + p1[last] * w1;
+            }
+        }
+
+        void pixel(int x, int y, int bgr[3]) const {
+            x += x0;
+            y += y0;
+            const int luma = frame.y[static_cast<size_t>(y) * frame.yStride + x];
+            if (frame.format == YuvFormat::I420) {
+                yuvToBgr(luma, frame.u[static_cast<size_t>(y / 2) * frame.uStride + x / 2],
+                         frame.v[static_cast<size_t>(y / 2) * frame.vStride + x / 2], bgr);
+                return;
+            }
+            const uint8_t* chroma = frame.u + static_cast<size_t>(y / 2) * frame.uStride + (x / 2) * 2;
+            const bool nv12 = frame.format == YuvFormat::NV12;
+            yuvToBgr(luma, chroma[nv12 ? 0 : 1], chroma[nv12 ? 1 : 0], bgr);
+        }
+    };
+
+    // Vertical pass: out[i] = a[i] * wa + b[i] * wb. Normalization is folded
+    // into the weights by the caller.
+    void blendRows(const float* a, const float* b, float wa, float wb, float* out, int n) {
+        int i = 0;
+#if defined(NEPTUNE_PREPROCESS_SSE2)
+        const __m128 wa4 = _mm_set1_ps(wa);
+        const __m128 wb4 = _mm_set1_ps(wb);
+        for (; i + 4 <= n; i += 4) {
+            const __m128 v = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(a + i), wa4),
+                                        _mm_mul_ps(_mm_loadu_ps(b + i), wb4));
+            _mm_storeu_ps(out + i, v);
+        }
+#elif defined(NEPTUNE_PREPROCESS_NEON)
+        for (; i + 4 <= n; i += 4) {
+            vst1q_f32(out + i, vmlaq_n_f32(vmulq_n_f32(vld1q_f32(a + i), wa), vld1q_f32(b + i), wb));
+        }
+#endif
+        for (; i < n; ++i) {
+            out[i] = a[i] * wa + b[i] * wb;
+        }
+    }
+
+    // Rounds already-scaled values, adds the zero point and saturates to T.
+    template <typename T>
+    void storeQuantized(const float* v, int n, int32_t zeroPoint, T* out) {
+        constexpr bool isInt8 = std::is_same<T, int8_t>::value;
+        int i = 0;
+#if defined(NEPTUNE_PREPROCESS_SSE2)
+        const __m128i zp = _mm_set1_epi32(zeroPoint);
+        for (; i + 8 <= n; i += 8) {
+            const __m128i lo = _mm_add_epi32(_mm_cvtps_epi32(_mm_loadu_ps(v + i)), zp);
+            const __m128i hi = _mm_add_epi32(_mm_cvtps_epi32(_mm_loadu_ps(v + i + 4)), zp);
+            const __m128i words = _mm_packs_epi32(lo, hi);
+            const __m128i bytes = isInt8 ? _mm_packs_epi16(words, words) : _mm_packus_epi16(words, words);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(out + i), bytes);
+        }
+#elif defined(NEPTUNE_PREPROCESS_NEON)
+        const int32x4_t zp = vdupq_n_s32(zeroPoint);
+        for (; i + 8 <= n; i += 8) {
+            const int32x4_t lo = vaddq_s32(vcvtnq_s32_f32(vld1q_f32(v + i)), zp);
+            const int32x4_t hi = vaddq_s32(vcvtnq_s32_f32(vld1q_f32(v + i + 4)), zp);
+            const int16x8_t words = vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi));
+            if (isInt8) vst1_s8(reinterpret_cast<int8_t*>(out + i), vqmovn_s16(words));
+            else vst1_u8(reinterpret_cast<uint8_t*>(out + i), vqmovun_s16(words));
+        }
+#endif
+        const int32_t lowest = isInt8 ? -128 : 0;
+        const int32_t highest = isInt8 ? 127 : 255;
+        for (; i < n; ++i) {
+            const int32_t q = static_cast<int32_t>(std::lrint(v[i])) + zeroPoint;
+            out[i] = static_cast<T>(std::min(highest, std::max(lowest, q)));
+        }
+    }
+
+    // Per-thread buffers of the fused kernel; they only grow, so steady-state
+    // calls do not allocate.
+    struct FusedScratch {
+        std::vector<LinearTap> xTaps;
+        std::vector<LinearTap> yTaps;
+        std::vector<float> rows[2];   // horizontally resampled source rows
+        int rowIndex[2] = {-1, -1};   // source row held by each buffer
+        std::vector<float> blended;   // quantized outputs only
+
+        // Resampled source row y, reusing the two cached rows when possible
+        // and never evicting row `keep`.
+        template <typename Rows>
+        const float* sourceRow(const Rows& source, int y, int keep, bool swapRB) {
+            for (int s = 0; s < 2; ++s) {
+                if (rowIndex[s] == y) return rows[s].data();
+            }
+            const int s = rowIndex[0] == keep ? 1 : 0;
+            source(y, xTaps.data(), static_cast<int>(xTaps.size()), swapRB, rows[s].data());
+            rowIndex[s] = y;
+            return rows[s].data();
+        }
+    };
+
+    // Resamples a width x height region, read through `source`, into the
+    // dense NHWC tensor `dst`, whose type and size the caller has checked.
+    template <typename Rows>
+    void fusedResizeNormalize(const Rows& source, int width, int height,
+                              const InputTensorView& dst, bool swapRB, bool keepAspect) {
+        const int dstWidth = dst.width();
+        const int dstHeight = dst.height();
+
+        // Same geometry as Preprocess::resize().
+        int newWidth = dstWidth;
+        int newHeight = dstHeight;
+        if (keepAspect) {
+            const float scale = std::min(dstWidth / float(width), dstHeight / float(height));
+            newWidth = std::max(1, int(width * scale));
+            newHeight = std::max(1, int(height * scale));
+        }
+        const int xOffset = (dstWidth - newWidth) / 2;
+        const int yOffset = (dstHeight - newHeight) / 2;
+
+        thread_local FusedScratch scratch;
+        const int rowValues = newWidth * 3;
+        computeTaps(width, newWidth, scratch.xTaps);
+        computeTaps(height, newHeight, scratch.yTaps);
+        scratch.rows[0].resize(rowValues);
+        scratch.rows[1].resize(rowValues);
+        scratch.rowIndex[0] = scratch.rowIndex[1] = -1;
+
+        const bool quantized = dst.isQuantized();
+        if (quantized) scratch.blended.resize(rowValues);
+
+        // Float tensors get v / 255; quantized ones v / 255 / scale, with the
+        // zero point added on store.
+        const float norm = quantized ? 1.0f / (255.0f * dst.scale) : 1.0f / 255.0f;
+        const int pad = quantized ? quantizeValue(0.0f, dst.scale, dst.zeroPoint, dst.type) : 0;
+
+        const size_t elemSize = tensorTypeSize(dst.type);
+        const size_t rowBytes = static_cast<size_t>(dstWidth) * 3 * elemSize;
+        const size_t leftBytes = static_cast<size_t>(xOffset) * 3 * elemSize;
+        const size_t rightBytes = rowBytes - leftBytes - static_cast<size_t>(rowValues) * elemSize;
+        uint8_t* out = static_cast<uint8_t*>(dst.data);
+
+        for (int y = 0; y < dstHeight; ++y, out += rowBytes) {
+            const int sy = y - yOffset;
+            if (sy < 0 || sy >= newHeight) {
+                std::memset(out, pad, rowBytes);
+                continue;
+            }
+            std::memset(out, pad, leftBytes);
+            std::memset(out + rowBytes - rightBytes, pad, rightBytes);
+
+            const LinearTap& tap = scratch.yTaps[sy];
+            const float* r0 = scratch.sourceRow(source, tap.i0, tap.i1, swapRB);
+            const float* r1 = scratch.sourceRow(source, tap.i1, tap.i0, swapRB);
+            const float w0 = (1.0f - tap.w1) * norm;
+            const float w1 = tap.w1 * norm;
+            uint8_t* content = out + leftBytes;
+
+            if (!quantized) {
+                blendRows(r0, r1, w0, w1, reinterpret_cast<float*>(content), rowValues);
+            } else {
+                blendRows(r0, r1, w0, w1, scratch.blended.data(), rowValues);
+                if (dst.type == TensorType::INT8) {
+                    storeQuantized(scratch.blended.data(), rowValues, dst.zeroPoint, reinterpret_cast<int8_t*>(content));
+                } else {
+                    storeQuantized(scratch.blended.data(), rowValues, dst.zeroPoint, content);
+                }
+            }
+        }
+    }
+
+    // Where the ROI lands in the tensor: all of it, or letterboxed like resize().
+    cv::Rect contentBox(float roiWidth, float roiHeight, int dstWidth, int dstHeight, bool keepAspect) {
+        if (!keepAspect) return cv::Rect(0, 0, dstWidth, dstHeight);
+        const float scale = std::min(dstWidth / roiWidth, dstHeight / roiHeight);
+        const int newWidth = std::min(dstWidth, std::max(1, int(roiWidth * scale)));
+        const int newHeight = std::min(dstHeight, std::max(1, int(roiHeight * scale)));
+        return cv::Rect((dstWidth - newWidth) / 2, (dstHeight - newHeight) / 2, newWidth, newHeight);
+    }
+
+    // Affine map from tensor pixel coordinates to image pixel coordinates
+    // that draws `roi` into the `content` box of the tensor.
+    cv::Matx23f roiTransform(const NormalizedRect& roi, const cv::Size& imageSize, const cv::Rect& content) {
+        const float roiWidth = roi.width * imageSize.width;
+        const float roiHeight = roi.height * imageSize.height;
+        const float sx = roiWidth / content.width;
+        const float sy = roiHeight / content.height;
+        // Tensor point -> ROI-local point relative to the ROI center.
+        const float ox = -content.x * sx - 0.5f * roiWidth;
+        const float oy = -content.y * sy - 0.5f * roiHeight;
+        const float c = std::cos(roi.rotation);
+        const float s = std::sin(roi.rotation);
+        const float cx = roi.x_center * imageSize.width;
+        const float cy = roi.y_center * imageSize.height;
+        return cv::Matx23f(c * sx, -s * sy, cx + c * ox - s * oy,
+                           s * sx, c * sy, cy + s * ox + c * oy);
+    }
+
+    // Fills the `content` box of `dst` by bilinearly sampling `source`
+    // (width x height pixels, border replicated) at m * (tensor pixel center);
+    // the rest of the tensor is padded with real 0.
+    template <typename Pixels>
+    void fusedWarpNormalize(const Pixels& source, int width, int height, const cv::Matx23f& m,
+                            const cv::Rect& content, const InputTensorView& dst, bool swapRB) {
+        const int dstWidth = dst.width();
+        const int dstHeight = dst.height();
+        const bool quantized = dst.isQuantized();
+        const float norm = quantized ? 1.0f / (255.0f * dst.scale) : 1.0f / 255.0f;
+        const int pad = quantized ? quantizeValue(0.0f, dst.scale, dst.zeroPoint, dst.type) : 0;
+        const int first = swapRB ? 2 : 0;
+        const int last = swapRB ? 0 : 2;
+
+        const int rowValues = content.width * 3;
+        thread_local std::vector<float> warped;
+        if (quantized) warped.resize(rowValues);
+
+        const size_t elemSize = tensorTypeSize(dst.type);
+        const size_t rowBytes = static_cast<size_t>(dstWidth) * 3 * elemSize;
+        const size_t leftBytes = static_cast<size_t>(content.x) * 3 * elemSize;
+        const size_t rightBytes = rowBytes - leftBytes - static_cast<size_t>(rowValues) * elemSize;
+        uint8_t* out = static_cast<uint8_t*>(dst.data);
+
+        for (int y = 0; y < dstHeight; ++y, out += rowBytes) {
+            if (y < content.y || y >= content.y + content.height) {
+                std::memset(out, pad, rowBytes);
+                continue;
+            }
+            std::memset(out, pad, leftBytes);
+            std::memset(out + rowBytes - rightBytes, pad, rightBytes);
+
+            float* row = quantized ? warped.data() : reinterpret_cast<float*>(out + leftBytes);
+            // Source position of the first pixel center, minus 0.5 for the
+            // source pixel-center convention; then step along the row.
+            const float u = content.x + 0.5f;
+            const float v = y + 0.5f;
+            float sx = m(0, 0) * u + m(0, 1) * v + m(0, 2) - 0.5f;
+            float sy = m(1, 0) * u + m(1, 1) * v + m(1, 2) - 0.5f;
+            const float stepX = m(0, 0);
+            const float stepY = m(1, 0);
+            int p00[3], p01[3], p10[3], p11[3];
+            for (int x = 0; x < content.width; ++x, sx += stepX, sy += stepY, row += 3) {
+                const int ix = static_cast<int>(std::floor(sx));
+                const int iy = static_cast<int>(std::floor(sy));
+                const float ax = sx - ix;
+                const float ay = sy - iy;
+                const int x0 = std::min(width - 1, std::max(0, ix));
+                const int x1 = std::min(width - 1, std::max(0, ix + 1));
+                const int y0 = std::min(height - 1, std::max(0, iy));
+                const int y1 = std::min(height - 1, std::max(0, iy + 1));
+                source.pixel(x0, y0, p00);
+                source.pixel(x1, y0, p01);
+                source.pixel(x0, y1, p10);
+                source.pixel(x1, y1, p11);
+
+                const float w00 = (1.0f - ax) * (1.0f - ay) * norm;
+                const float w01 = ax * (1.0f - ay) * norm;
+                const float w10 = (1.0f - ax) * ay * norm;
+                const float w11 = ax * ay * norm;
+                row[0] = p00[first] * w00 + p01[first] * w01 + p10[first] * w10 + p11[first] * w11;
+                row[1] = p00[1] * w00 + p01[1] * w01 + p10[1] * w10 + p11[1] * w11;
+                row[2] = p00[last] * w00 + p01[last] * w01 + p10[last] * w10 + p11[last] * w11;
+            }
+
+            if (dst.type == TensorType::INT8) {
+                storeQuantized(warped.data(), rowValues, dst.zeroPoint, reinterpret_cast<int8_t*>(out + leftBytes));
+            } else if (quantized) {
+                storeQuantized(warped.data(), rowValues, dst.zeroPoint, out + leftBytes);
+            }
+        }
+    }
+
+    template <typename Pixels>
+    bool warpInto(const Pixels& source, const cv::Size& imageSize, const NormalizedRect& roi,
+                  const InputTensorView& dst, bool swapRB, bool keepAspect, cv::Matx23f* tensorToImage) {
+        const float roiWidth = roi.width * imageSize.width;
+        const float roiHeight = roi.height * imageSize.height;
+        if (!(roiWidth > 0.0f) || !(roiHeight > 0.0f)) {
+            NEPTUNE_LOG_ERROR("Preprocess", "warpNormalizeInto: empty ROI");
+            return false;
+        }
+        const cv::Rect content = contentBox(roiWidth, roiHeight, dst.width(), dst.height(), keepAspect);
+        const cv::Matx23f m = roiTransform(roi, imageSize, content);
+        fusedWarpNormalize(source, imageSize.width, imageSize.height, m, content, dst, swapRB);
+        if (tensorToImage) *tensorToImage = m;
+        return true;
+    }
+
+    // Checks that `dst` is a dense NHWC tensor the fused kernel can fill.
+    bool checkFusedTarget(const InputTensorView& dst) {
+        if (!dst.valid() || dst.width() <= 0 || dst.height() <= 0 || dst.channels() != 3) {
+            NEPTUNE_LOG_ERROR("Preprocess", "resizeNormalizeInto: expected an NHWC tensor with 3 channels");
+            return false;
+        }
+        if (dst.isQuantized() ? dst.scale <= 0.0f : dst.type != TensorType::FLOAT32) {
+            NEPTUNE_LOG_ERROR("Preprocess", "resizeNormalizeInto: unsupported tensor type or missing quantization scale");
+            return false;
+        }
+        if (dst.bytes < static_cast<size_t>(dst.height()) * dst.width() * 3 * tensorTypeSize(dst.type)) {
+            NEPTUNE_LOG_ERROR("Preprocess", "resizeNormalizeInto: tensor view is smaller than its shape");
+            return false;
+        }
+        return true;
+    }
+
+    } // namespace
     
         cv::Mat Preprocess::resize(const cv::Mat& img, int targetWidth, int targetHeight) {
             int originalWidth = img.cols;
@@ -32,37 +457,205 @@ namespace neptune {
             int yOffset = (targetHeight - newHeight) / 2;
             resized.copyTo(output(cv::Rect(xOffset, yOffset, newWidth, newHeight)));
         
-            Log::info("Preprocess", "Resized with padding to " + std::to_string(targetWidth) + "x" + std::to_string(targetHeight));
+            NEPTUNE_LOG_DEBUG("Preprocess", "Resized with padding to " << targetWidth << "x" << targetHeight);
         
             return output;
         }
         
     
     std::vector<float> Preprocess::normalize(const cv::Mat& img) {
-        cv::Mat rgbImg;
-        // Convert BGR (OpenCV default) to RGB
-        cv::cvtColor(img, rgbImg, cv::COLOR_BGR2RGB);
-    
-        // Convert to float and scale to 0-1
-        cv::Mat floatImg;
-        rgbImg.convertTo(floatImg, CV_32FC3, 1.0f / 255.0f);
-    
         // Flatten in NHWC order
-        std::vector<float> processedData;
-        processedData.reserve(floatImg.total() * floatImg.channels());
-    
-        for (int i = 0; i < floatImg.rows; ++i) {
-            for (int j = 0; j < floatImg.cols; ++j) {
-                cv::Vec3f pixel = floatImg.at<cv::Vec3f>(i, j);
-                processedData.push_back(pixel[0]); // R
-                processedData.push_back(pixel[1]); // G
-                processedData.push_back(pixel[2]); // B
-            }
+        std::vector<float> processedData(img.total() * 3);
+
+        InputTensorView view;
+        view.data = processedData.data();
+        view.type = TensorType::FLOAT32;
+        view.rank = 4;
+        view.shape[0] = 1;
+        view.shape[1] = img.rows;
+        view.shape[2] = img.cols;
+        view.shape[3] = 3;
+        view.bytes = processedData.size() * sizeof(float);
+
+        if (!normalizeInto(img, view)) {
+            processedData.clear();
         }
     
-        Log::info("Preprocess", "Normalized image. Vector size: " + std::to_string(processedData.size()));
+        NEPTUNE_LOG_DEBUG("Preprocess", "Normalized image. Vector size: " << processedData.size());
         return processedData;
     }
+
+    bool Preprocess::normalizeInto(const cv::Mat& img, const InputTensorView& dst, bool swapRB) {
+        if (img.empty() || img.type() != CV_8UC3 || !dst.valid() ||
+            dst.height() != img.rows || dst.width() != img.cols || dst.channels() != 3) {
+            NEPTUNE_LOG_ERROR("Preprocess", "normalizeInto: tensor view does not match image");
+            return false;
+        }
+
+        if (dst.isQuantized()) {
+            if (dst.scale <= 0.0f) {
+                NEPTUNE_LOG_ERROR("Preprocess", "normalizeInto: quantized tensor has no scale");
+                return false;
+            }
+            // Quantize in the same pass: every 8-bit pixel value maps to one
+            // quantized value, so a 256-entry table covers normalize+quantize.
+            const bool isInt8 = dst.type == TensorType::INT8;
+            cv::Mat lut(1, 256, isInt8 ? CV_8S : CV_8U);
+            for (int v = 0; v < 256; ++v) {
+                const int32_t q = quantizeValue(v / 255.0f, dst.scale, dst.zeroPoint, dst.type);
+                if (isInt8) lut.at<int8_t>(v) = static_cast<int8_t>(q);
+                else lut.at<uint8_t>(v) = static_cast<uint8_t>(q);
+            }
+            cv::Mat out(img.rows, img.cols, isInt8 ? CV_8SC3 : CV_8UC3, dst.data);
+            cv::LUT(img, lut, out);
+            if (swapRB) {
+                // Channel swap is a byte permutation, so view int8 data as uint8.
+                cv::Mat bytes(img.rows, img.cols, CV_8UC3, dst.data);
+                cv::cvtColor(bytes, bytes, cv::COLOR_BGR2RGB);
+            }
+            return true;
+        }
+
+        if (dst.type != TensorType::FLOAT32) {
+            NEPTUNE_LOG_ERROR("Preprocess", "normalizeInto: unsupported tensor type");
+            return false;
+        }
+
+        // Wrap the tensor memory so OpenCV writes into it without reallocating.
+        cv::Mat out(img.rows, img.cols, CV_32FC3, dst.data);
+        img.convertTo(out, CV_32FC3, 1.0f / 255.0f);
+        if (swapRB) {
+            // Convert BGR (OpenCV default) to RGB, in place
+            cv::cvtColor(out, out, cv::COLOR_BGR2RGB);
+        }
+        return true;
+    }
+
+    bool Preprocess::resizeNormalizeInto(const cv::Mat& img, const InputTensorView& dst, bool swapRB, bool keepAspect) {
+        if (img.empty() || img.type() != CV_8UC3) {
+            NEPTUNE_LOG_ERROR("Preprocess", "resizeNormalizeInto: expected a CV_8UC3 image");
+            return false;
+        }
+        if (!checkFusedTarget(dst)) return false;
+
+        fusedResizeNormalize(BgrRows{img.data, img.step}, img.cols, img.rows, dst, swapRB, keepAspect);
+        return true;
+    }
+
+    bool Preprocess::resizeNormalizeInto(const cv::Mat& img, const cv::Rect& roi, const InputTensorView& dst,
+                                         bool swapRB, bool keepAspect) {
+        const cv::Rect region = roi & cv::Rect(0, 0, img.cols, img.rows);
+        if (region.empty()) {
+            NEPTUNE_LOG_ERROR("Preprocess", "resizeNormalizeInto: ROI is outside the image");
+            return false;
+        }
+        return resizeNormalizeInto(img(region), dst, swapRB, keepAspect);
+    }
+
+    bool Preprocess::resizeNormalizeInto(const YuvFrame& frame, const cv::Rect& roi, const InputTensorView& dst,
+                                         bool swapRB, bool keepAspect) {
+        if (!frame.valid()) {
+            NEPTUNE_LOG_ERROR("Preprocess", "resizeNormalizeInto: invalid YUV frame");
+            return false;
+        }
+        const cv::Rect region = roi & cv::Rect(0, 0, frame.width, frame.height);
+        if (region.empty()) {
+            NEPTUNE_LOG_ERROR("Preprocess", "resizeNormalizeInto: ROI is outside the frame");
+            return false;
+        }
+        if (!checkFusedTarget(dst)) return false;
+
+        fusedResizeNormalize(YuvRows{frame, region.x, region.y}, region.width, region.height, dst, swapRB, keepAspect);
+        return true;
+    }
+
+    NormalizedRect Preprocess::faceRoi(const FaceBox& face, const cv::Size& imageSize, float scale,
+                                       bool square, bool align) {
+        NormalizedRect roi;
+        if (imageSize.width <= 0 || imageSize.height <= 0) return roi;
+
+        float width = face.width * scale;
+        float height = face.height * scale;
+        if (square) width = height = std::max(width, height);
+        roi.x_center = (face.x + 0.5f * face.width) / imageSize.width;
+        roi.y_center = (face.y + 0.5f * face.height) / imageSize.height;
+        roi.width = width / imageSize.width;
+        roi.height = height / imageSize.height;
+
+        if (align) {
+            // Right eye -> left eye, as seen in the image: detector keypoints
+            // 0/1, or the outer eye corners 33/263 of a face mesh.
+            const auto& points = face.landmarks;
+            int right = -1, left = -1;
+            if (points.size() == 6) { right = 0; left = 1; }
+            else if (points.size() >= 468) { right = 33; left = 263; }
+            if (right >= 0) {
+                roi.rotation = std::atan2(points[left].y - points[right].y, points[left].x - points[right].x);
+            }
+        }
+        return roi;
+    }
+
+    NormalizedRect Preprocess::landmarksRoi(const std::vector<Point>& landmarks, const cv::Size& imageSize,
+                                            float scale, bool align) {
+        NormalizedRect roi;
+        if (imageSize.width <= 0 || imageSize.height <= 0 || landmarks.size() < 468) return roi;
+
+        const float angle = align ? std::atan2(landmarks[263].y - landmarks[33].y, landmarks[263].x - landmarks[33].x)
+                                  : 0.0f;
+        const float c = std::cos(angle);
+        const float s = std::sin(angle);
+
+        // Bounding box in the face's own (eye-aligned) frame.
+        float minU = std::numeric_limits<float>::max(), maxU = -minU;
+        float minV = minU, maxV = -minU;
+        for (const Point& p : landmarks) {
+            const float u = c * p.x + s * p.y;
+            const float v = -s * p.x + c * p.y;
+            minU = std::min(minU, u); maxU = std::max(maxU, u);
+            minV = std::min(minV, v); maxV = std::max(maxV, v);
+        }
+        const float u = 0.5f * (minU + maxU);
+        const float v = 0.5f * (minV + maxV);
+        const float side = std::max(maxU - minU, maxV - minV) * scale;
+
+        roi.x_center = (c * u - s * v) / imageSize.width;
+        roi.y_center = (s * u + c * v) / imageSize.height;
+        roi.width = side / imageSize.width;
+        roi.height = side / imageSize.height;
+        roi.rotation = angle;
+        return roi;
+    }
+
+    NormalizedRect Preprocess::rectRoi(const cv::Rect& rect, const cv::Size& imageSize) {
+        NormalizedRect roi;
+        if (imageSize.width <= 0 || imageSize.height <= 0) return roi;
+        roi.x_center = (rect.x + 0.5f * rect.width) / imageSize.width;
+        roi.y_center = (rect.y + 0.5f * rect.height) / imageSize.height;
+        roi.width = static_cast<float>(rect.width) / imageSize.width;
+        roi.height = static_cast<float>(rect.height) / imageSize.height;
+        return roi;
+    }
+
+    bool Preprocess::warpNormalizeInto(const cv::Mat& img, const NormalizedRect& roi, const InputTensorView& dst,
+                                       bool swapRB, bool keepAspect, cv::Matx23f* tensorToImage) {
+        if (img.empty() || img.type() != CV_8UC3) {
+            NEPTUNE_LOG_ERROR("Preprocess", "warpNormalizeInto: expected a CV_8UC3 image");
+            return false;
+        }
+        if (!checkFusedTarget(dst)) return false;
+        return warpInto(BgrRows{img.data, img.step}, img.size(), roi, dst, swapRB, keepAspect, tensorToImage);
+    }
+
+    bool Preprocess::warpNormalizeInto(const YuvFrame& frame, const NormalizedRect& roi, const InputTensorView& dst,
+                                       bool swapRB, bool keepAspect, cv::Matx23f* tensorToImage) {
+        if (!frame.valid()) {
+            NEPTUNE_LOG_ERROR("Preprocess", "warpNormalizeInto: invalid YUV frame");
+            return false;
+        }
+        if (!checkFusedTarget(dst)) return false;
+        return warpInto(YuvRows{frame, 0, 0}, frame.size(), roi, dst, swapRB, keepAspect, tensorToImage);
+    }
     
     } // namespace img
     } // namespace neptune
@@ -0,0 +1,52 @@
+//
+// File: NeptuneFacialSDK/core/src/img/YuvFrame.cpp
+//
+// Full-frame conversion of a strided YUV 4:2:0 view to BGR.
+//
+
+#include "neptune/YuvFrame.h"
+#include "neptune/Log.h"
+
+#include <opencv2/imgproc.hpp>
+
+#include <cstring>
+
+namespace neptune {
+
+cv::Mat YuvFrame::toBgr() const {
+    if (!valid()) {
+        NEPTUNE_LOG_ERROR("YuvFrame", "toBgr: invalid frame");
+        return cv::Mat();
+    }
+
+    // cvtColor wants the planes packed back to back without row padding.
+    const int chromaWidth = width / 2;
+    const int chromaHeight = height / 2;
+    cv::Mat packed(height + chromaHeight, width, CV_8UC1);
+    for (int r = 0; r < height; ++r) {
+        std::memcpy(packed.ptr(r), y + static_cast<size_t>(r) * yStride, width);
+    }
+    uint8_t* chroma = packed.ptr(height);
+    if (format == YuvFormat::I420) {
+        for (int r = 0; r < chromaHeight; ++r) {
+            std::memcpy(chroma + r * chromaWidth, u + static_cast<size_t>(r) * uStride, chromaWidth);
+        }
+        chroma += chromaWidth * chromaHeight;
+        for (int r = 0; r < chromaHeight; ++r) {
+            std::memcpy(chroma + r * chromaWidth, v + static_cast<size_t>(r) * vStride, chromaWidth);
+        }
+    } else {
+        for (int r = 0; r < chromaHeight; ++r) {
+            std::memcpy(chroma + r * width, u + static_cast<size_t>(r) * uStride, width);
+        }
+    }
+
+    cv::Mat bgr;
+    const int code = format == YuvFormat::NV12 ? cv::COLOR_YUV2BGR_NV12
+                   : format == YuvFormat::NV21 ? cv::COLOR_YUV2BGR_NV21
+                                               : cv::COLOR_YUV2BGR_I420;
+    cv::cvtColor(packed, bgr, code);
+    return bgr;
+}
+
+} // namespace neptune
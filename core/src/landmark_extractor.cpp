@@ -1,132 +1,268 @@
 
 #include "neptune/landmark_extractor.h"
 #include "neptune/Log.h"
+#include "neptune/Preprocess.h"
 
-#include <tensorflow/lite/kernels/register.h>
-#include <tensorflow/lite/model.h>
+#include <cmath>
+#include <cstring>
 
-LandmarkExtractor::LandmarkExtractor(const std::string& modelPath) {
-    model = tflite::FlatBufferModel::BuildFromFile(modelPath.c_str());
-    if (!model) {
+LandmarkExtractor::LandmarkExtractor(const std::string& modelPath, const neptune::NeptuneConfig& config)
+    : pool(neptune::InterpreterPool::create(modelPath, neptune::EngineOptions::fromConfig(config),
+                                            config.interpreterPoolSize,
+                                            config.blockWhenPoolBusy ? neptune::PoolAcquirePolicy::BLOCK
+                                                                     : neptune::PoolAcquirePolicy::TRY)),
+      roiScale(config.landmarkRoiScale),
+      alignCrops(config.alignFaceCrops) {
+    if (!pool) {
         // LOG_ERROR("Failed to load landmark model: " + modelPath);
         return;
     }
 
-    tflite::ops::builtin::BuiltinOpResolver resolver;
-    tflite::InterpreterBuilder(*model, resolver)(&interpreter);
-
-    if (!interpreter) {
-        // LOG_ERROR("Failed to create interpreter for landmark model");
-        return;
-    }
-
-    interpreter->AllocateTensors();
-
     // Model input dims (N,H,W,C)
-    auto* inputTensor = interpreter->tensor(interpreter->inputs()[0]);
-    inputHeight = inputTensor->dims->data[1];
-    inputWidth = inputTensor->dims->data[2];
+    inputHeight = pool->inputHeight();
+    inputWidth = pool->inputWidth();
 
     // LOG_INFO("[LandmarkExtractor] Model expects input: "
     //       + std::to_string(inputWidth) + "x" + std::to_string(inputHeight));
 }
 
 std::vector<neptune::Point> LandmarkExtractor::Process(const cv::Mat& image, const cv::Rect& faceRect) {
-    std::vector<neptune::Point> landmarks;
-    if (!interpreter) return landmarks;
+    return processOne(image, rectRoi(faceRect, image.size()));
+}
+
+std::vector<neptune::Point> LandmarkExtractor::Process(const neptune::YuvFrame& frame, const cv::Rect& faceRect) {
+    return processOne(frame, rectRoi(faceRect, frame.size()));
+}
+
+std::vector<neptune::Point> LandmarkExtractor::Process(const cv::Mat& image, const neptune::FaceBox& face) {
+    return processOne(image, faceRoi(face, image.size()));
+}
+
+std::vector<neptune::Point> LandmarkExtractor::Process(const neptune::YuvFrame& frame, const neptune::FaceBox& face) {
+    return processOne(frame, faceRoi(face, frame.size()));
+}
+
+std::vector<std::vector<neptune::Point>> LandmarkExtractor::processBatch(const cv::Mat& image,
+                                                                         const std::vector<cv::Rect>& faceRects) {
+    return processFaces(image, rectRois(faceRects, image.size()));
+}
 
-    // Crop face ROI
-    cv::Rect roi = faceRect & cv::Rect(0, 0, image.cols, image.rows);
-    if (roi.width <= 0 || roi.height <= 0) return landmarks;
-    
-    cv::Mat faceROI = image(roi).clone();
-    cv::Mat resized;
-    cv::resize(faceROI, resized, cv::Size(inputWidth, inputHeight));
+std::vector<std::vector<neptune::Point>> LandmarkExtractor::processBatch(const neptune::YuvFrame& frame,
+                                                                         const std::vector<cv::Rect>& faceRects) {
+    return processFaces(frame, rectRois(faceRects, frame.size()));
+}
 
-    // MediaPipe landmark models expect [0, 1] normalized input
-    resized.convertTo(resized, CV_32FC3, 1.0 / 255.0);
+std::vector<std::vector<neptune::Point>> LandmarkExtractor::processBatch(const cv::Mat& image,
+                                                                         const std::vector<neptune::FaceBox>& faces) {
+    return processFaces(image, faceRois(faces, image.size()));
+}
 
-    // Copy into tensor (ensure proper channel ordering)
-    float* input = interpreter->typed_input_tensor<float>(0);
+std::vector<std::vector<neptune::Point>> LandmarkExtractor::processBatch(const neptune::YuvFrame& frame,
+                                                                         const std::vector<neptune::FaceBox>& faces) {
+    return processFaces(frame, faceRois(faces, frame.size()));
+}
 
-    // Convert BGR to RGB and copy with proper layout
-    cv::Mat rgb;
-    cv::cvtColor(resized, rgb, cv::COLOR_BGR2RGB);
+std::vector<std::vector<neptune::Point>> LandmarkExtractor::processRois(const cv::Mat& image,
+                                                                        const std::vector<neptune::NormalizedRect>& rois,
+                                                                        std::vector<float>& presence) {
+    return processFaces(image, rois, &presence);
+}
 
-    // Copy data with proper memory layout (HWC format)
-    memcpy(input, rgb.data, sizeof(float) * inputWidth * inputHeight * 3);
+std::vector<std::vector<neptune::Point>> LandmarkExtractor::processRois(const neptune::YuvFrame& frame,
+                                                                        const std::vector<neptune::NormalizedRect>& rois,
+                                                                        std::vector<float>& presence) {
+    return processFaces(frame, rois, &presence);
+}
+
+neptune::NormalizedRect LandmarkExtractor::rectRoi(const cv::Rect& faceRect, const cv::Size& imageSize) const {
+    // Rect callers keep the old axis-aligned crop of the clipped rect; an
+    // empty result marks a face to skip.
+    const cv::Rect roi = faceRect & cv::Rect(cv::Point(), imageSize);
+    if (roi.area() <= 0) return neptune::NormalizedRect();
+    return neptune::img::Preprocess::rectRoi(roi, imageSize);
+}
+
+neptune::NormalizedRect LandmarkExtractor::faceRoi(const neptune::FaceBox& face, const cv::Size& imageSize) const {
+    if (face.width <= 0 || face.height <= 0) return neptune::NormalizedRect();
+    // MediaPipe's face mesh expects a square crop 1.5x the detection box,
+    // rotated so the eyes are level.
+    return neptune::img::Preprocess::faceRoi(face, imageSize, roiScale, /*square=*/true, alignCrops);
+}
+
+std::vector<neptune::NormalizedRect> LandmarkExtractor::rectRois(const std::vector<cv::Rect>& faceRects,
+                                                                 const cv::Size& imageSize) const {
+    std::vector<neptune::NormalizedRect> rois;
+    rois.reserve(faceRects.size());
+    for (const auto& rect : faceRects) rois.push_back(rectRoi(rect, imageSize));
+    return rois;
+}
+
+std::vector<neptune::NormalizedRect> LandmarkExtractor::faceRois(const std::vector<neptune::FaceBox>& faces,
+                                                                 const cv::Size& imageSize) const {
+    std::vector<neptune::NormalizedRect> rois;
+    rois.reserve(faces.size());
+    for (const auto& face : faces) rois.push_back(faceRoi(face, imageSize));
+    return rois;
+}
+
+template <typename Image>
+std::vector<neptune::Point> LandmarkExtractor::processOne(const Image& image, const neptune::NormalizedRect& roi) {
+    if (!pool) return {};
+    neptune::InterpreterPool::Lease engine = pool->acquire();
+    if (!engine) return {};
+    return processWith(*engine, image, roi);
+}
+
+template <typename Image>
+std::vector<neptune::Point> LandmarkExtractor::processWith(neptune::TfLiteEngine& engine, const Image& image,
+                                                           const neptune::NormalizedRect& roi, float* presence) const {
+    std::vector<neptune::Point> landmarks;
+    const cv::Size imageSize = image.size();
+    if (presence) *presence = 0.0f;
+
+    if (roi.width <= 0.0f || roi.height <= 0.0f) return landmarks;
+    if (!engine.setBatchSize(1)) return landmarks;
+
+    // Crop, rotate and scale the face ROI straight into the input tensor
+    neptune::InputTensorView input = engine.inputTensorView(0);
+    cv::Matx23f tensorToImage;
+    if (!preprocessInto(image, roi, input, tensorToImage)) {
+        return landmarks;
+    }
 
     // Run inference
-    if (interpreter->Invoke() != kTfLiteOk) {
+    if (!engine.invoke()) {
         return landmarks;
     }
 
     // Extract raw landmarks
-    auto* outputTensor = interpreter->tensor(interpreter->outputs()[0]);
-    int numValues = outputTensor->bytes / sizeof(float);
-    const float* output = interpreter->typed_output_tensor<float>(0);
-    int numLandmarks = numValues / 3; // (x,y,z)
-
-    landmarks.reserve(numLandmarks);
+    neptune::OutputTensorView output = engine.outputTensorView(0);
+    decodeLandmarks(output, static_cast<int>(output.size) / 3, tensorToImage, imageSize, landmarks);
+    if (presence) *presence = decodePresence(engine, 0, 1);
 
-    for (int i = 0; i < numLandmarks; i++) {
-        // MediaPipe outputs coordinates in [0, inputWidth/inputHeight] range (e.g., [0, 192])
-        float rawX = output[i * 3 + 0];
-        float rawY = output[i * 3 + 1];
-        
-        // Normalize to [0,1] relative to input dimensions
-        float normalizedX = rawX / static_cast<float>(inputWidth);
-        float normalizedY = rawY / static_cast<float>(inputHeight);
-        
-        // Map to face ROI coordinates, then to absolute image coordinates
-        float roiX = normalizedX * static_cast<float>(roi.width);
-        float roiY = normalizedY * static_cast<float>(roi.height);
-        
-        // Convert to absolute image coordinates
-        float absX = roiX + static_cast<float>(roi.x);
-        float absY = roiY + static_cast<float>(roi.y);
-        
-        // Clamp to image boundaries for safety
-        absX = std::max(0.0f, std::min(absX, static_cast<float>(image.cols - 1)));
-        absY = std::max(0.0f, std::min(absY, static_cast<float>(image.rows - 1)));
-        
-        landmarks.push_back({absX, absY});
-    }
+    // Placement diagnostics, only computed when debug logging is on
+    if (!landmarks.empty() && neptune::Log::enabled(neptune::LogLevel::Debug)) {
+        NEPTUNE_LOG_DEBUG("LandmarkExtractor", "Image size: " << imageSize.width << "x" << imageSize.height);
+        NEPTUNE_LOG_DEBUG("LandmarkExtractor", "ROI: center (" << roi.x_center * imageSize.width << ","
+                          << roi.y_center * imageSize.height << "), size " << roi.width * imageSize.width << "x"
+                          << roi.height * imageSize.height << ", rotation " << roi.rotation << " rad");
+        NEPTUNE_LOG_DEBUG("LandmarkExtractor", "Model input size: " << inputWidth << "x" << inputHeight);
 
-    // Enhanced debug output
-    if (!landmarks.empty()) {
-        std::cout << "DEBUG: Image size: " << image.cols << "x" << image.rows << "\n";
-        std::cout << "DEBUG: ROI: (" << roi.x << "," << roi.y << "," << roi.width << "," << roi.height << ")\n";
-        std::cout << "DEBUG: Model input size: " << inputWidth << "x" << inputHeight << "\n";
-        
         // Show first few landmarks for debugging
         for (int j = 0; j < std::min(3, static_cast<int>(landmarks.size())); j++) {
             float rawX = output[j * 3 + 0];
             float rawY = output[j * 3 + 1];
-            float normX = rawX / static_cast<float>(inputWidth);
-            float normY = rawY / static_cast<float>(inputHeight);
-            std::cout << "DEBUG: Landmark " << j << " - raw: (" << rawX << ", " << rawY 
-                      << "), normalized: (" << normX << ", " << normY << ")"
-                      << "), absolute: (" << landmarks[j].x << ", " << landmarks[j].y << ")\n";
+            NEPTUNE_LOG_DEBUG("LandmarkExtractor", "Landmark " << j << " - raw: (" << rawX << ", " << rawY
+                              << "), normalized: (" << rawX / static_cast<float>(inputWidth) << ", "
+                              << rawY / static_cast<float>(inputHeight) << "), absolute: (" << landmarks[j].x
+                              << ", " << landmarks[j].y << ")");
         }
 
         // Check if coordinates are reasonable
         bool allValid = true;
         for (const auto& landmark : landmarks) {
-            if (landmark.x < 0 || landmark.x >= image.cols ||
-                landmark.y < 0 || landmark.y >= image.rows) {
+            if (landmark.x < 0 || landmark.x >= imageSize.width ||
+                landmark.y < 0 || landmark.y >= imageSize.height) {
                 allValid = false;
                 break;
             }
         }
-        
         if (!allValid) {
-            std::cout << "WARNING: Some landmark coordinates are out of bounds!\n";
-            std::cout << " Expected range: [0, " << image.cols << ") x [0, " << image.rows << ")\n";
-        } else {
-            std::cout << "SUCCESS: All landmark coordinates are within bounds!\n";
+            NEPTUNE_LOG_DEBUG("LandmarkExtractor", "Some landmark coordinates are out of bounds, expected range [0, "
+                              << imageSize.width << ") x [0, " << imageSize.height << ")");
         }
     }
 
     return landmarks;
-}
\ No newline at end of file
+}
+
+template <typename Image>
+std::vector<std::vector<neptune::Point>> LandmarkExtractor::processFaces(const Image& image,
+                                                                         const std::vector<neptune::NormalizedRect>& rois,
+                                                                         std::vector<float>* presence) {
+    std::vector<std::vector<neptune::Point>> results(rois.size());
+    if (presence) presence->assign(rois.size(), 0.0f);
+    if (!pool || rois.empty()) return results;
+    neptune::InterpreterPool::Lease engine = pool->acquire();
+    if (!engine) return results;
+
+    const int batch = static_cast<int>(rois.size());
+
+    // A single face, or a model that cannot be batched, takes the per-face path.
+    if (batch == 1 || !engine->setBatchSize(batch)) {
+        for (int i = 0; i < batch; ++i) {
+            results[i] = processWith(*engine, image, rois[i], presence ? &(*presence)[i] : nullptr);
+        }
+        return results;
+    }
+
+    // Per-thread, so batched calls stop allocating once they have seen their largest batch.
+    thread_local std::vector<cv::Matx23f> transforms;
+    transforms.resize(batch);
+
+    neptune::InputTensorView input = engine->inputTensorView(0);
+    for (int i = 0; i < batch; ++i) {
+        neptune::InputTensorView item = input.slice(i);
+        if (rois[i].width > 0.0f && rois[i].height > 0.0f) {
+            if (!preprocessInto(image, rois[i], item, transforms[i])) return results;
+        } else if (item.valid()) {
+            // Keep the slot defined; its result is discarded below.
+            std::memset(item.data, 0, item.bytes);
+        }
+    }
+    if (!engine->invoke()) return results;
+
+    neptune::OutputTensorView output = engine->outputTensorView(0);
+    const int valuesPerFace = static_cast<int>(output.size) / batch;
+    for (int i = 0; i < batch; ++i) {
+        if (rois[i].width <= 0.0f || rois[i].height <= 0.0f) continue;
+        decodeLandmarks(output.slice(static_cast<size_t>(i) * valuesPerFace, valuesPerFace),
+                        valuesPerFace / 3, transforms[i], image.size(), results[i]);
+        if (presence) (*presence)[i] = decodePresence(*engine, i, batch);
+    }
+    return results;
+}
+
+template <typename Image>
+bool LandmarkExtractor::preprocessInto(const Image& image, const neptune::NormalizedRect& roi,
+                                       const neptune::InputTensorView& input, cv::Matx23f& tensorToImage) const {
+    // MediaPipe landmark models expect [0, 1] normalized RGB input (HWC),
+    // warped from the (rotated) ROI straight into the input tensor
+    return neptune::img::Preprocess::warpNormalizeInto(image, roi, input, /*swapRB=*/true,
+                                                       /*keepAspect=*/false, &tensorToImage);
+}
+
+float LandmarkExtractor::decodePresence(const neptune::TfLiteEngine& engine, int index, int batch) const {
+    // Output 0 holds the landmarks; the face flag is the output with one
+    // value per face (a logit, as MediaPipe's face mesh emits it).
+    for (int o = 1; o < engine.getNumOutputs(); ++o) {
+        const neptune::OutputTensorView flag = engine.outputTensorView(o);
+        if (flag.size == static_cast<size_t>(batch)) {
+            return 1.0f / (1.0f + std::exp(-flag[static_cast<size_t>(index)]));
+        }
+    }
+    return 1.0f;
+}
+
+void LandmarkExtractor::decodeLandmarks(const neptune::OutputTensorView& output, int numLandmarks,
+                                        const cv::Matx23f& tensorToImage, const cv::Size& imageSize,
+                                        std::vector<neptune::Point>& landmarks) const {
+    landmarks.clear();
+    landmarks.reserve(numLandmarks);
+
+    for (int i = 0; i < numLandmarks; i++) {
+        // MediaPipe outputs coordinates in [0, inputWidth/inputHeight] range (e.g., [0, 192])
+        float rawX = output[i * 3 + 0];
+        float rawY = output[i * 3 + 1];
+
+        // Back through the crop's affine map (undoes rotation, scale and offset)
+        float absX = tensorToImage(0, 0) * rawX + tensorToImage(0, 1) * rawY + tensorToImage(0, 2);
+        float absY = tensorToImage(1, 0) * rawX + tensorToImage(1, 1) * rawY + tensorToImage(1, 2);
+
+        // Clamp to image boundaries for safety
+        absX = std::max(0.0f, std::min(absX, static_cast<float>(imageSize.width - 1)));
+        absY = std::max(0.0f, std::min(absY, static_cast<float>(imageSize.height - 1)));
+
+        landmarks.push_back({absX, absY});
+    }
+}
@@ -0,0 +1,47 @@
+//
+// File: NeptuneFacialSDK/core/src/tflite/EmbeddedModels.cpp
+//
+// Lookup of models compiled into the library. The model data itself is
+// generated at build time by core/cmake/EmbedModels.cmake.
+//
+
+#include "neptune/EmbeddedModels.h"
+
+#include <cstring>
+
+namespace neptune {
+
+#ifndef NEPTUNE_EMBED_MODELS
+namespace detail {
+const EmbeddedModel kEmbeddedModels[] = {{nullptr, nullptr, 0}};
+const size_t kEmbeddedModelCount = 0;
+} // namespace detail
+#endif
+
+bool isEmbeddedModelPath(const std::string& path) {
+    return path.compare(0, std::strlen(kEmbeddedModelPrefix), kEmbeddedModelPrefix) == 0;
+}
+
+const EmbeddedModel* findEmbeddedModel(const std::string& nameOrPath) {
+    const std::string name = isEmbeddedModelPath(nameOrPath)
+        ? nameOrPath.substr(std::strlen(kEmbeddedModelPrefix)) : nameOrPath;
+    for (size_t i = 0; i < detail::kEmbeddedModelCount; ++i) {
+        if (name == detail::kEmbeddedModels[i].name) return &detail::kEmbeddedModels[i];
+    }
+    return nullptr;
+}
+
+std::vector<std::string> embeddedModelNames() {
+    std::vector<std::string> names;
+    names.reserve(detail::kEmbeddedModelCount);
+    for (size_t i = 0; i < detail::kEmbeddedModelCount; ++i) {
+        names.emplace_back(detail::kEmbeddedModels[i].name);
+    }
+    return names;
+}
+
+std::string embeddedOrPath(const std::string& name, const std::string& fallbackPath) {
+    return findEmbeddedModel(name) ? kEmbeddedModelPrefix + name : fallbackPath;
+}
+
+} // namespace neptune
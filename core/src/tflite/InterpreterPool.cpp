@@ -0,0 +1,139 @@
+//
+// File: NeptuneFacialSDK/core/src/tflite/InterpreterPool.cpp
+//
+// Implements the bounded, thread-safe pool of TfLiteEngine instances that
+// share one FlatBufferModel.
+//
+
+#include "neptune/InterpreterPool.h"
+#include "neptune/Log.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace neptune {
+
+// ------------------- Lease -------------------
+InterpreterPool::Lease::Lease(Lease&& other) noexcept
+    : pool_(other.pool_), engine_(other.engine_) {
+    other.pool_ = nullptr;
+    other.engine_ = nullptr;
+}
+
+InterpreterPool::Lease& InterpreterPool::Lease::operator=(Lease&& other) noexcept {
+    if (this != &other) {
+        release();
+        pool_ = other.pool_;
+        engine_ = other.engine_;
+        other.pool_ = nullptr;
+        other.engine_ = nullptr;
+    }
+    return *this;
+}
+
+InterpreterPool::Lease::~Lease() { release(); }
+
+void InterpreterPool::Lease::release() {
+    if (pool_ && engine_) pool_->giveBack(engine_);
+    pool_ = nullptr;
+    engine_ = nullptr;
+}
+
+// ------------------- Pool -------------------
+InterpreterPool::InterpreterPool(const std::string& modelPath, const EngineOptions& options,
+                                 int maxSize, PoolAcquirePolicy policy)
+    : modelPath_(modelPath), options_(options), maxSize_(std::max(1, maxSize)), policy_(policy) {}
+
+InterpreterPool::~InterpreterPool() = default;
+
+std::unique_ptr<InterpreterPool> InterpreterPool::create(const std::string& modelPath,
+                                                         const EngineOptions& options,
+                                                         int maxSize,
+                                                         PoolAcquirePolicy policy) {
+    auto pool = std::unique_ptr<InterpreterPool>(new InterpreterPool(modelPath, options, maxSize, policy));
+
+    // The registry mmaps the model once per process; every pooled interpreter
+    // (and every other pool on the same file) reads the same pages.
+    const auto start = std::chrono::steady_clock::now();
+    pool->model_ = ModelRegistry::instance().acquire(modelPath);
+    if (!pool->model_) return nullptr;
+    const double loadMs =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    auto first = pool->buildEngine(true);
+    if (!first) return nullptr;
+    pool->startupTiming_ = first->startupTiming();
+    pool->startupTiming_.loadMs = loadMs;
+    pool->inputWidth_ = first->inputWidth();
+    pool->inputHeight_ = first->inputHeight();
+    pool->backend_ = first->backend();
+    pool->idle_.push_back(first.get());
+    pool->engines_.push_back(std::move(first));
+    return pool;
+}
+
+std::unique_ptr<TfLiteEngine> InterpreterPool::buildEngine(bool first) {
+    EngineOptions options = options_;
+    // Engines added later are built on demand while frames are processed;
+    // a warm-up invoke there would only delay the frame that needed them.
+    if (!first) options.warmUp = false;
+    auto engine = std::make_unique<TfLiteEngine>(options);
+    if (!engine->attachModel(model_, modelPath_)) {
+        NEPTUNE_LOG_ERROR("InterpreterPool", "Failed to build interpreter: " << engine->getLastError());
+        return nullptr;
+    }
+    return engine;
+}
+
+InterpreterPool::Lease InterpreterPool::acquire() {
+    return acquireImpl(policy_ == PoolAcquirePolicy::BLOCK);
+}
+
+InterpreterPool::Lease InterpreterPool::tryAcquire() {
+    return acquireImpl(false);
+}
+
+InterpreterPool::Lease InterpreterPool::acquireImpl(bool wait) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        if (!idle_.empty()) {
+            TfLiteEngine* engine = idle_.back();
+            idle_.pop_back();
+            return Lease(this, engine);
+        }
+
+        if (!growthFailed_ && static_cast<int>(engines_.size()) + building_ < maxSize_) {
+            // Build outside the lock so other threads can keep returning leases.
+            ++building_;
+            lock.unlock();
+            auto engine = buildEngine(false);
+            lock.lock();
+            --building_;
+            if (engine) {
+                engines_.push_back(std::move(engine));
+                return Lease(this, engines_.back().get());
+            }
+            growthFailed_ = true;
+            NEPTUNE_LOG_WARN("InterpreterPool", "Pool for " << modelPath_ << " capped at " << engines_.size() << " interpreters");
+            continue;
+        }
+
+        if (!wait) return Lease();
+        available_.wait(lock);
+    }
+}
+
+void InterpreterPool::giveBack(TfLiteEngine* engine) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        idle_.push_back(engine);
+    }
+    available_.notify_one();
+}
+
+int InterpreterPool::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<int>(engines_.size());
+}
+
+} // namespace neptune
@@ -0,0 +1,245 @@
+//
+// File: NeptuneFacialSDK/core/src/tflite/ModelRegistry.cpp
+//
+// Implements the process-wide model registry.
+//
+
+#include "neptune/ModelRegistry.h"
+#include "neptune/Log.h"
+#include "neptune/EmbeddedModels.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define NEPTUNE_HAVE_MINCORE 1
+#endif
+
+namespace fs = std::filesystem;
+
+namespace neptune {
+
+namespace {
+
+uint64_t fnv1a(const void* data, size_t size) {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+// Bytes of [base, base + size) that are currently paged in. Falls back to
+// `size` where residency cannot be queried.
+size_t residentSize(const void* base, size_t size) {
+#ifdef NEPTUNE_HAVE_MINCORE
+    if (!base || size == 0) return 0;
+    const long pageSize = sysconf(_SC_PAGESIZE);
+    if (pageSize <= 0) return size;
+    const uintptr_t page = static_cast<uintptr_t>(pageSize);
+    const uintptr_t begin = reinterpret_cast<uintptr_t>(base) & ~(page - 1);
+    const uintptr_t end = reinterpret_cast<uintptr_t>(base) + size;
+    const size_t pages = (end - begin + page - 1) / page;
+
+    std::vector<unsigned char> vec(pages);
+#ifdef __APPLE__
+    const int rc = mincore(reinterpret_cast<void*>(begin), end - begin, reinterpret_cast<char*>(vec.data()));
+#else
+    const int rc = mincore(reinterpret_cast<void*>(begin), end - begin, vec.data());
+#endif
+    if (rc != 0) return size;
+
+    size_t resident = 0;
+    for (unsigned char v : vec) {
+        if (v & 1) ++resident;
+    }
+    return std::min(size, resident * static_cast<size_t>(page));
+#else
+    (void)base;
+    return size;
+#endif
+}
+
+} // namespace
+
+ModelRegistry& ModelRegistry::instance() {
+    static ModelRegistry registry;
+    return registry;
+}
+
+SharedModel ModelRegistry::acquire(const std::string& modelPath, std::string* error) {
+    auto fail = [&](const std::string& message) -> SharedModel {
+        if (error) *error = message;
+        NEPTUNE_LOG_ERROR("ModelRegistry", message);
+        return nullptr;
+    };
+
+    if (isEmbeddedModelPath(modelPath)) {
+        const EmbeddedModel* embedded = findEmbeddedModel(modelPath);
+        if (!embedded) return fail("No embedded model named: " + modelPath);
+        return acquireFromBuffer(embedded->data, embedded->size, modelPath, error);
+    }
+
+    std::error_code ec;
+    fs::path canonicalPath = fs::weakly_canonical(modelPath, ec);
+    const std::string key = ec ? modelPath : canonicalPath.string();
+
+    const uintmax_t fileSize = fs::file_size(key, ec);
+    if (ec) return fail("Cannot stat model file: " + modelPath);
+    const fs::file_time_type modified = fs::last_write_time(key, ec);
+    if (ec) return fail("Cannot stat model file: " + modelPath);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = byPath_.find(key);
+        if (it != byPath_.end() && it->second.fileSize == fileSize && it->second.modified == modified) {
+            if (SharedModel model = it->second.model.lock()) return model;
+        }
+    }
+
+    // Map and hash outside the lock so unrelated models can load in parallel.
+    std::unique_ptr<::tflite::FlatBufferModel> loaded =
+        ::tflite::FlatBufferModel::BuildFromFile(key.c_str());
+    if (!loaded) return fail("Failed to load TFLite model from: " + modelPath);
+    const ::tflite::Allocation* allocation = loaded->allocation();
+    const uint64_t hash = allocation ? fnv1a(allocation->base(), allocation->bytes()) : 0;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    pruneExpired();
+
+    // Same content already mapped (another path, or a concurrent load): share
+    // it. The hash only finds the candidate; the bytes decide.
+    if (hash != 0) {
+        auto owner = byHash_.find(hash);
+        if (owner != byHash_.end()) {
+            auto entry = byPath_.find(owner->second);
+            if (entry != byPath_.end()) {
+                if (SharedModel model = entry->second.model.lock()) {
+                    const ::tflite::Allocation* existing = model->allocation();
+                    if (existing && existing->bytes() == allocation->bytes() &&
+                        std::memcmp(existing->base(), allocation->base(), allocation->bytes()) == 0) {
+                        byPath_[key] = Entry{model, hash, fileSize, modified, key};
+                        return model;
+                    }
+                    NEPTUNE_LOG_WARN("ModelRegistry", key << " has the content hash of " << entry->second.name
+                                     << " but different bytes; loading it separately");
+                }
+            }
+        }
+    }
+
+    SharedModel model(std::move(loaded));
+    byPath_[key] = Entry{model, hash, fileSize, modified, key};
+    if (hash != 0) byHash_.emplace(hash, key);   // a colliding file does not take over the hash
+    NEPTUNE_LOG_INFO("ModelRegistry", "Loaded " << key << " (" << (allocation ? allocation->bytes() : 0) << " bytes)");
+    return model;
+}
+
+SharedModel ModelRegistry::acquireFromBuffer(const void* data, size_t size, const std::string& name,
+                                             std::string* error) {
+    if (!data || size == 0) {
+        const std::string message = "Empty model buffer: " + name;
+        if (error) *error = message;
+        NEPTUNE_LOG_ERROR("ModelRegistry", message);
+        return nullptr;
+    }
+
+    // The address identifies the buffer; no hashing, so embedded models
+    // are not paged in until the interpreter reads them.
+    const std::string key = "buffer:" + std::to_string(reinterpret_cast<uintptr_t>(data)) +
+                            ":" + std::to_string(size);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = byPath_.find(key);
+    if (it != byPath_.end()) {
+        if (SharedModel model = it->second.model.lock()) return model;
+    }
+    pruneExpired();
+
+    SharedModel model(::tflite::FlatBufferModel::BuildFromBuffer(static_cast<const char*>(data), size));
+    if (!model) {
+        const std::string message = "Failed to load TFLite model from buffer: " + name;
+        if (error) *error = message;
+        NEPTUNE_LOG_ERROR("ModelRegistry", message);
+        return nullptr;
+    }
+    byPath_[key] = Entry{model, 0, size, fs::file_time_type(), name};
+    NEPTUNE_LOG_INFO("ModelRegistry", "Loaded " << name << " from memory (" << size << " bytes)");
+    return model;
+}
+
+uint64_t ModelRegistry::contentHash(const SharedModel& model) {
+    if (!model) return 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        bool known = false;
+        for (const auto& [key, entry] : byPath_) {
+            if (entry.model.lock() != model) continue;
+            if (entry.contentHash != 0) return entry.contentHash;
+            known = true;
+        }
+        if (!known) return 0;
+    }
+
+    // Hash outside the lock; the caller's reference keeps the bytes alive.
+    const ::tflite::Allocation* allocation = model->allocation();
+    if (!allocation) return 0;
+    const uint64_t hash = fnv1a(allocation->base(), allocation->bytes());
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& [key, entry] : byPath_) {
+        if (entry.model.lock() == model) entry.contentHash = hash;
+    }
+    return hash;
+}
+
+void ModelRegistry::pruneExpired() {
+    for (auto it = byPath_.begin(); it != byPath_.end();) {
+        it = it->second.model.expired() ? byPath_.erase(it) : std::next(it);
+    }
+    for (auto it = byHash_.begin(); it != byHash_.end();) {
+        it = byPath_.count(it->second) ? std::next(it) : byHash_.erase(it);
+    }
+}
+
+std::vector<ModelStats> ModelRegistry::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<ModelStats> out;
+    std::vector<const ::tflite::FlatBufferModel*> seen;
+
+    for (const auto& [key, entry] : byPath_) {
+        SharedModel model = entry.model.lock();
+        if (!model) continue;
+        if (std::find(seen.begin(), seen.end(), model.get()) != seen.end()) continue;
+        seen.push_back(model.get());
+
+        ModelStats s;
+        s.path = entry.name;
+        s.contentHash = entry.contentHash;
+        if (const ::tflite::Allocation* allocation = model->allocation()) {
+            s.mappedBytes = allocation->bytes();
+            s.residentBytes = residentSize(allocation->base(), allocation->bytes());
+        }
+        s.users = model.use_count() - 1; // minus the local copy above
+        out.push_back(std::move(s));
+    }
+    return out;
+}
+
+size_t ModelRegistry::residentBytes() const {
+    size_t total = 0;
+    for (const auto& s : stats()) total += s.residentBytes;
+    return total;
+}
+
+void ModelRegistry::logStats() const {
+    for (const auto& s : stats()) {
+        NEPTUNE_LOG_INFO("ModelRegistry", s.path << ": mapped " << s.mappedBytes / 1024 << " KiB, resident " << s.residentBytes / 1024 << " KiB, users " << s.users);
+    }
+}
+
+} // namespace neptune
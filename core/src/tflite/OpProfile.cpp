@@ -0,0 +1,92 @@
+//
+// File: NeptuneFacialSDK/core/src/tflite/OpProfile.cpp
+//
+// CSV/JSON formatting of per-op profiling results.
+//
+
+#include "neptune/OpProfile.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <sstream>
+
+namespace neptune {
+
+namespace {
+
+std::string csvField(const std::string& s) {
+    if (s.find_first_of(",\"\n") == std::string::npos) return s;
+    std::string out = "\"";
+    for (char c : s) {
+        if (c == '"') out += '"';
+        out += c;
+    }
+    return out + "\"";
+}
+
+std::string jsonString(const std::string& s) {
+    std::string out = "\"";
+    for (char c : s) {
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) continue;
+                out += c;
+        }
+    }
+    return out + "\"";
+}
+
+} // namespace
+
+void OpProfile::summarize(std::vector<double> samples, double& mean, double& p95) {
+    mean = 0.0;
+    p95 = 0.0;
+    if (samples.empty()) return;
+    mean = std::accumulate(samples.begin(), samples.end(), 0.0) / samples.size();
+    // Nearest-rank percentile.
+    const size_t rank = static_cast<size_t>(std::ceil(0.95 * samples.size()));
+    const size_t index = std::min(samples.size() - 1, rank > 0 ? rank - 1 : 0);
+    std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+    p95 = samples[index];
+}
+
+std::string OpProfile::toCsv() const {
+    std::ostringstream out;
+    out << "model,node,name,type,batch,delegated,count,mean_us,p95_us,total_us\n";
+    for (const auto& op : ops) {
+        out << csvField(model) << ',' << op.nodeIndex << ',' << csvField(op.name) << ','
+            << csvField(op.type) << ',' << op.batchSize << ',' << (op.delegated ? 1 : 0) << ','
+            << op.count << ',' << op.meanUs << ',' << op.p95Us << ',' << op.totalUs << '\n';
+    }
+    return out.str();
+}
+
+std::string OpProfile::toJson() const {
+    std::ostringstream out;
+    out << "{\"model\":" << jsonString(model)
+        << ",\"invokes\":" << invokes
+        << ",\"invoke_mean_us\":" << invokeMeanUs
+        << ",\"invoke_p95_us\":" << invokeP95Us
+        << ",\"ops\":[";
+    for (size_t i = 0; i < ops.size(); ++i) {
+        const auto& op = ops[i];
+        out << (i ? "," : "")
+            << "{\"node\":" << op.nodeIndex
+            << ",\"name\":" << jsonString(op.name)
+            << ",\"type\":" << jsonString(op.type)
+            << ",\"batch\":" << op.batchSize
+            << ",\"delegated\":" << (op.delegated ? "true" : "false")
+            << ",\"count\":" << op.count
+            << ",\"mean_us\":" << op.meanUs
+            << ",\"p95_us\":" << op.p95Us
+            << ",\"total_us\":" << op.totalUs << "}";
+    }
+    out << "]}";
+    return out.str();
+}
+
+} // namespace neptune
@@ -0,0 +1,47 @@
+//
+// File: NeptuneFacialSDK/core/src/tflite/OpResolver.cpp
+//
+// Selects the full builtin or the generated selective op resolver.
+//
+
+#include "neptune/OpResolver.h"
+
+#ifndef NEPTUNE_SELECTIVE_OPS
+#include "tensorflow/lite/kernels/register.h"
+#endif
+
+namespace neptune {
+
+#ifdef NEPTUNE_SELECTIVE_OPS
+// Defined in the generated SelectedOpResolver.cpp.
+void registerSelectedOps(::tflite::MutableOpResolver& resolver);
+#endif
+
+// One resolver per thread: OpResolver keeps a mutable operator cache, so a
+// single instance must not be used by concurrent InterpreterBuilders (pool
+// growth, parallel init). Interpreters stay valid after their resolver is
+// destroyed, so thread exit is harmless.
+const ::tflite::OpResolver& opResolver() {
+#ifdef NEPTUNE_SELECTIVE_OPS
+    thread_local const ::tflite::MutableOpResolver resolver = [] {
+        ::tflite::MutableOpResolver r;
+        registerSelectedOps(r);
+        return r;
+    }();
+#else
+    // Default delegates are never applied implicitly so that
+    // TfLiteEngine::backend() reports exactly what runs the graph.
+    thread_local const ::tflite::ops::builtin::BuiltinOpResolverWithoutDefaultDelegates resolver;
+#endif
+    return resolver;
+}
+
+bool usesSelectiveOpResolver() {
+#ifdef NEPTUNE_SELECTIVE_OPS
+    return true;
+#else
+    return false;
+#endif
+}
+
+} // namespace neptune
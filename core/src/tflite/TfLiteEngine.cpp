@@ -9,13 +9,101 @@
 // File: NeptuneFacialSDK/core/src/tflite/TfLiteEngine.cpp
 #include "neptune/TfLiteEngine.h"
 #include "neptune/Log.h"
+#include "neptune/OpResolver.h"
+
+#include "tensorflow/lite/profiling/buffered_profiler.h"
+
+#ifdef NEPTUNE_WITH_XNNPACK
+#include "tensorflow/lite/delegates/xnnpack/xnnpack_delegate.h"
+#endif
 
 #include <cstring>
 #include <algorithm>
+#include <chrono>
+#include <atomic>
+#include <cctype>
+#include <cstdio>
+#include <filesystem>
+
+#if defined(__linux__) || defined(__ANDROID__)
+#include <sys/auxv.h>
+#elif defined(__APPLE__)
+#include <sys/sysctl.h>
+#endif
 
 namespace neptune {
 
-TfLiteEngine::TfLiteEngine() = default;
+static void noDelegateDelete(TfLiteDelegate*) {}
+
+static TensorType toTensorType(TfLiteType type) {
+    switch (type) {
+        case kTfLiteFloat32: return TensorType::FLOAT32;
+        case kTfLiteUInt8:   return TensorType::UINT8;
+        case kTfLiteInt8:    return TensorType::INT8;
+        default:             return TensorType::UNKNOWN;
+    }
+}
+
+static double msSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Identifies the CPU's SIMD capabilities, which decide how XNNPACK packs
+// weights; a cache packed on one CPU must not be mapped on another.
+static std::string cpuFingerprint() {
+    std::string id;
+#if defined(__x86_64__) || defined(__i386__)
+    id = "x86";
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx")) id += "-avx";
+    if (__builtin_cpu_supports("avx2")) id += "-avx2";
+    if (__builtin_cpu_supports("fma")) id += "-fma";
+    if (__builtin_cpu_supports("avx512f")) id += "-avx512f";
+    if (__builtin_cpu_supports("avx512bw")) id += "-avx512bw";
+#elif defined(__aarch64__) || defined(__arm__)
+    id = "arm";
+#if defined(__linux__) || defined(__ANDROID__)
+    char caps[48];
+    std::snprintf(caps, sizeof(caps), "-%lx-%lx", getauxval(AT_HWCAP), getauxval(AT_HWCAP2));
+    id += caps;
+#elif defined(__APPLE__)
+    char brand[128] = {};
+    size_t size = sizeof(brand);
+    if (sysctlbyname("machdep.cpu.brand_string", brand, &size, nullptr, 0) == 0) {
+        id += "-";
+        id += brand;
+    }
+#endif
+#else
+    id = "generic";
+#endif
+    for (char& c : id) {
+        if (!std::isalnum(static_cast<unsigned char>(c)) && c != '-') c = '_';
+    }
+    return id;
+}
+
+static int64_t elementCount(const TfLiteTensor* t) {
+    if (!t || !t->dims) return 0;
+    int64_t elems = 1;
+    for (int i = 0; i < t->dims->size; ++i) elems *= t->dims->data[i];
+    return elems;
+}
+
+EngineOptions EngineOptions::fromConfig(const NeptuneConfig& config) {
+    EngineOptions options;
+    options.useXnnpack = config.useXnnpack;
+    options.numThreads = config.numThreads;
+    options.allowFp16 = config.allowFp16Inference;
+    options.warmUp = config.warmUpModels;
+    options.weightsCacheDir = config.xnnpackCacheDir;
+    options.maxCachedBatchSizes = config.maxCachedBatchSizes;
+    return options;
+}
+
+TfLiteEngine::TfLiteEngine() : TfLiteEngine(EngineOptions()) {}
+TfLiteEngine::TfLiteEngine(const EngineOptions& options)
+    : options_(options), delegate_(nullptr, noDelegateDelete) {}
 TfLiteEngine::~TfLiteEngine() = default;
 // Add this function implementation to your file
 bool TfLiteEngine::isLoaded() const {
@@ -23,39 +111,332 @@ bool TfLiteEngine::isLoaded() const {
     return model_ != nullptr && interpreter_ != nullptr;
 }
 
+const char* TfLiteEngine::backendName(InferenceBackend backend) {
+    switch (backend) {
+        case InferenceBackend::XNNPACK: return "XNNPACK";
+        case InferenceBackend::BUILTIN:
+        default: return "BUILTIN";
+    }
+}
+
 bool TfLiteEngine::loadModel(const std::string& modelPath) {
-    model_ = ::tflite::FlatBufferModel::BuildFromFile(modelPath.c_str());
-    if (!model_) {
-        lastError_ = "Failed to load TFLite model from: " + modelPath;
+    const auto start = std::chrono::steady_clock::now();
+    SharedModel model = ModelRegistry::instance().acquire(modelPath, &lastError_);
+    if (!model) {
         //NEP_LOGE("[TfLiteEngine] %s", lastError_.c_str());
         return false;
     }
+    const double loadMs = msSince(start);
+    const bool ok = attachModel(std::move(model), modelPath);
+    timing_.loadMs = loadMs;
+    return ok;
+}
+
+bool TfLiteEngine::loadModelFromBuffer(const void* data, size_t size, const std::string& name) {
+    const auto start = std::chrono::steady_clock::now();
+    SharedModel model = ModelRegistry::instance().acquireFromBuffer(data, size, name, &lastError_);
+    if (!model) return false;
+    const double loadMs = msSince(start);
+    const bool ok = attachModel(std::move(model), name);
+    timing_.loadMs = loadMs;
+    return ok;
+}
+
+bool TfLiteEngine::attachModel(SharedModel model, const std::string& name) {
+    batchCache_.clear();
+    unsupportedBatchSizes_.clear();
+    customInputDims_.clear();
+    interpreter_.reset();
+    delegate_.reset();
+    backend_ = InferenceBackend::BUILTIN;
+    timing_ = ModelStartupTiming();
+    timing_.model = name;
+
+    model_ = std::move(model);
+    if (!model_) {
+        lastError_ = "Null model for: " + name;
+        return false;
+    }
+    weightsCachePath_ = resolveWeightsCachePath(name);
+
+    // A delegate that rejects the graph leaves the interpreter in an undefined
+    // state, so fall back by rebuilding a plain one rather than reusing it.
+    const auto start = std::chrono::steady_clock::now();
+    bool built = buildInterpreter(options_.useXnnpack);
+    if (!built && options_.useXnnpack) {
+        built = buildInterpreter(false);
+    }
+    if (!built) return false;
+    timing_.allocateMs = msSince(start);
+    timing_.backend = backend_;
+
+    const TfLiteTensor* input = interpreter_->inputs().empty()
+        ? nullptr : interpreter_->tensor(interpreter_->inputs()[0]);
+    batchSize_ = (input && input->dims && input->dims->size > 0) ? input->dims->data[0] : 1;
+
+    updateInputDims();
+    NEPTUNE_LOG_INFO("TfLiteEngine", name << " -> backend " << backendName(backend_) << ", threads " << options_.numThreads);
+
+    if (options_.warmUp) {
+        const double ms = warmUp();
+        if (ms < 0) {
+            NEPTUNE_LOG_WARN("TfLiteEngine", "Warm-up invoke failed for " << name << ": " << lastError_);
+        } else {
+            timing_.firstInvokeMs = ms;
+        }
+    }
+    return true;
+}
+
+double TfLiteEngine::warmUp() {
+    if (!interpreter_) {
+        lastError_ = "Interpreter not initialized";
+        return -1.0;
+    }
+    // Zeros are a valid input for every dtype we support; outputs are ignored.
+    for (int index : interpreter_->inputs()) {
+        TfLiteTensor* tensor = interpreter_->tensor(index);
+        if (tensor && tensor->data.raw) std::memset(tensor->data.raw, 0, tensor->bytes);
+    }
+    const auto start = std::chrono::steady_clock::now();
+    if (!invoke()) return -1.0;
+    return msSince(start);
+}
+
+bool TfLiteEngine::buildInterpreter(bool withDelegate, int batchSize, bool retryCache) {
+    interpreter_.reset();
+    delegate_.reset();
+    backend_ = InferenceBackend::BUILTIN;
 
-    ::tflite::ops::builtin::BuiltinOpResolver resolver;
-    ::tflite::InterpreterBuilder(*model_, resolver)(&interpreter_);
+    // Built once per thread rather than per interpreter; see OpResolver.h.
+    ::tflite::InterpreterBuilder builder(*model_, opResolver());
+    builder.SetNumThreads(options_.numThreads);
+    builder(&interpreter_);
     if (!interpreter_) {
         lastError_ = "Failed to create TFLite interpreter";
         return false;
     }
+    // Before delegation: XNNPACK only records per-op events when a profiler
+    // is attached at the time it takes over the graph.
+    if (profiler_) interpreter_->SetProfiler(profiler_.get());
+
+    // Resize before delegation so the delegate plans for the final shape,
+    // keeping the spatial size of an earlier resizeInputTensor().
+    if ((batchSize > 0 || !customInputDims_.empty()) && !interpreter_->inputs().empty()) {
+        const int inputIndex = interpreter_->inputs()[0];
+        const TfLiteTensor* input = interpreter_->tensor(inputIndex);
+        if (input && input->dims && input->dims->size > 0) {
+            const std::vector<int> original(input->dims->data, input->dims->data + input->dims->size);
+            std::vector<int> dims = original;
+            if (batchSize > 0) dims[0] = batchSize;
+            if (!customInputDims_.empty() && dims.size() == 4) {
+                std::copy(customInputDims_.begin(), customInputDims_.end(), dims.begin() + 1);
+            }
+            if (dims != original && interpreter_->ResizeInputTensor(inputIndex, dims) != kTfLiteOk) {
+                lastError_ = "ResizeInputTensor() to batch " + std::to_string(dims[0]) + " failed";
+                return false;
+            }
+        }
+    }
+
+    if (withDelegate) {
+#ifdef NEPTUNE_WITH_XNNPACK
+        TfLiteXNNPackDelegateOptions xnnOptions = TfLiteXNNPackDelegateOptionsDefault();
+        xnnOptions.num_threads = std::max(1, options_.numThreads);
+        // Keep int8/uint8 models on XNNPACK as well.
+        xnnOptions.flags |= TFLITE_XNNPACK_DELEGATE_FLAG_QS8 | TFLITE_XNNPACK_DELEGATE_FLAG_QU8;
+        if (options_.allowFp16) {
+            xnnOptions.flags |= TFLITE_XNNPACK_DELEGATE_FLAG_FORCE_FP16;
+        }
+
+        // Map an existing cache, or pack into a private file that is renamed
+        // into place once complete, so concurrent builders (threads or
+        // processes) never map a half-written cache.
+        std::string cacheBuildPath;
+        bool cacheHit = false;
+        if (!weightsCachePath_.empty()) {
+            std::error_code ec;
+            cacheHit = std::filesystem::exists(weightsCachePath_, ec);
+            if (!cacheHit) {
+                static std::atomic<unsigned> buildCounter{0};
+                cacheBuildPath = weightsCachePath_ + ".tmp" +
+                                 std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) +
+                                 "_" + std::to_string(buildCounter++);
+            }
+            xnnOptions.weight_cache_file_path = cacheHit ? weightsCachePath_.c_str() : cacheBuildPath.c_str();
+        }
+
+        delegate_ = DelegatePtr(TfLiteXNNPackDelegateCreate(&xnnOptions), TfLiteXNNPackDelegateDelete);
+        if (!delegate_ || interpreter_->ModifyGraphWithDelegate(delegate_.get()) != kTfLiteOk) {
+            if (cacheHit && retryCache) {
+                // Truncated or otherwise corrupt cache: drop it and pack afresh.
+                NEPTUNE_LOG_WARN("TfLiteEngine", "XNNPACK rejected weights cache " << weightsCachePath_
+                                 << ", rebuilding it");
+                std::error_code ec;
+                std::filesystem::remove(weightsCachePath_, ec);
+                return buildInterpreter(withDelegate, batchSize, false);
+            }
+            lastError_ = "XNNPACK delegate could not be applied";
+            NEPTUNE_LOG_WARN("TfLiteEngine", lastError_ << ", falling back to builtin kernels");
+            if (!cacheBuildPath.empty()) std::remove(cacheBuildPath.c_str());
+            return false;
+        }
+        backend_ = InferenceBackend::XNNPACK;
+        timing_.weightsCacheHit = cacheHit;
+        if (!cacheBuildPath.empty()) {
+            // The delegate keeps its mapping of the file across the rename.
+            std::error_code ec;
+            std::filesystem::rename(cacheBuildPath, weightsCachePath_, ec);
+            if (ec) std::remove(cacheBuildPath.c_str());
+        }
+#else
+        NEPTUNE_LOG_WARN("TfLiteEngine", "XNNPACK requested but neptune_core was built without it");
+#endif
+    }
 
     if (interpreter_->AllocateTensors() != kTfLiteOk) {
         lastError_ = "AllocateTensors() failed";
         return false;
     }
+    return true;
+}
 
-    updateInputDims();
-    //NEP_LOGI("[TfLiteEngine] Model loaded. Input HWC = %d x %d x %d",
-          //   inputHeight_, inputWidth_, inputChannels_);
+
+std::string TfLiteEngine::resolveWeightsCachePath(const std::string& name) {
+#ifdef NEPTUNE_WITH_XNNPACK
+    namespace fs = std::filesystem;
+    if (!options_.useXnnpack || options_.weightsCacheDir.empty()) return std::string();
+
+    const uint64_t hash = ModelRegistry::instance().contentHash(model_);
+    if (hash == 0) {
+        NEPTUNE_LOG_WARN("TfLiteEngine", "No content hash for " << name << ", XNNPACK weights cache disabled");
+        return std::string();
+    }
+
+    std::error_code ec;
+    const fs::path dir(options_.weightsCacheDir);
+    fs::create_directories(dir, ec);
+    if (ec) {
+        NEPTUNE_LOG_WARN("TfLiteEngine", "Cannot create weights cache dir " << dir.string() << ": " << ec.message());
+        return std::string();
+    }
+
+    // <model>-<content hash>-<cpu>[-fp16].xnncache: a changed model, CPU or
+    // packing mode gets a new file instead of a stale one.
+    const std::string stem = fs::path(name.substr(name.find(':') + 1)).stem().string();
+    char hex[17];
+    std::snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(hash));
+    const std::string prefix = stem + "-";
+    const std::string file = prefix + hex + "-" + cpuFingerprint() +
+                             (options_.allowFp16 ? "-fp16" : "") + ".xnncache";
+
+    // Drop caches of earlier versions of this model: same stem, followed by
+    // a different 16-digit hash.
+    auto isStaleVersion = [&](const std::string& other) {
+        const size_t hashEnd = prefix.size() + 16;
+        if (other.size() <= hashEnd || other.compare(0, prefix.size(), prefix) != 0 || other[hashEnd] != '-') {
+            return false;
+        }
+        if (other.size() < 9 || other.compare(other.size() - 9, 9, ".xnncache") != 0) return false;
+        for (size_t i = prefix.size(); i < hashEnd; ++i) {
+            if (!std::isxdigit(static_cast<unsigned char>(other[i]))) return false;
+        }
+        return other.compare(prefix.size(), 16, hex) != 0;
+    };
+    for (const auto& entry : fs::directory_iterator(dir, ec)) {
+        if (isStaleVersion(entry.path().filename().string())) fs::remove(entry.path(), ec);
+    }
+    return (dir / file).string();
+#else
+    (void)name;
+    return std::string();
+#endif
+}
+
+bool TfLiteEngine::setBatchSize(int batchSize) {
+    if (!interpreter_) {
+        lastError_ = "Interpreter not initialized";
+        return false;
+    }
+    if (batchSize <= 0) {
+        lastError_ = "Invalid batch size: " + std::to_string(batchSize);
+        return false;
+    }
+    if (batchSize == batchSize_) return true;
+    if (unsupportedBatchSizes_.count(batchSize)) {
+        lastError_ = "Model does not support batch size " + std::to_string(batchSize);
+        return false;
+    }
+
+    const int previous = batchSize_;
+    parkActive(previous);
+    if (restoreParked(batchSize)) {
+        batchSize_ = batchSize;
+        trimBatchCache();
+        return true;
+    }
+
+    bool built = buildInterpreter(options_.useXnnpack, batchSize);
+    if (!built && options_.useXnnpack) {
+        built = buildInterpreter(false, batchSize);
+    }
+    if (!built) {
+        // Remember the failure so callers falling back per face don't pay
+        // for a rebuild attempt every frame.
+        unsupportedBatchSizes_.insert(batchSize);
+        NEPTUNE_LOG_WARN("TfLiteEngine", "Batch size " << batchSize << " unsupported: " << lastError_);
+        restoreParked(previous);
+        return false;
+    }
+    batchSize_ = batchSize;
+    trimBatchCache();
     return true;
 }
 
+void TfLiteEngine::parkActive(int batchSize) {
+    CachedInterpreter& slot = batchCache_[batchSize];
+    slot.delegate = std::move(delegate_);
+    slot.interpreter = std::move(interpreter_);
+    slot.backend = backend_;
+    slot.lastUsed = ++parkCount_;
+    delegate_ = DelegatePtr(nullptr, noDelegateDelete);
+    backend_ = InferenceBackend::BUILTIN;
+}
+
+void TfLiteEngine::trimBatchCache() {
+    // Bound the memory held by parked interpreters: with varying crowd sizes
+    // every face count would otherwise keep its own arena and packed weights.
+    const size_t limit = static_cast<size_t>(std::max(0, options_.maxCachedBatchSizes));
+    while (batchCache_.size() > limit) {
+        auto oldest = batchCache_.begin();
+        for (auto it = batchCache_.begin(); it != batchCache_.end(); ++it) {
+            if (it->second.lastUsed < oldest->second.lastUsed) oldest = it;
+        }
+        NEPTUNE_LOG_DEBUG("TfLiteEngine", "Dropping cached interpreter for batch size " << oldest->first);
+        batchCache_.erase(oldest);
+    }
+}
+
+bool TfLiteEngine::restoreParked(int batchSize) {
+    auto it = batchCache_.find(batchSize);
+    if (it == batchCache_.end() || !it->second.interpreter) return false;
+    delegate_ = std::move(it->second.delegate);
+    interpreter_ = std::move(it->second.interpreter);
+    backend_ = it->second.backend;
+    batchCache_.erase(it);
+    if (profiler_) interpreter_->SetProfiler(profiler_.get());
+    return true;
+}
 
 bool TfLiteEngine::resizeInputTensor(int width, int height, int channels) {
     if (!interpreter_) {
         lastError_ = "Interpreter not initialized";
         return false;
     }
-    const std::vector<int> dims = {1, height, width, channels};
+    // Parked interpreters still have the old spatial size.
+    batchCache_.clear();
+    unsupportedBatchSizes_.clear();
+    const std::vector<int> dims = {batchSize_, height, width, channels};
     if (interpreter_->ResizeInputTensor(interpreter_->inputs()[0], dims) != kTfLiteOk) {
         lastError_ = "ResizeInputTensor() failed";
        // NEP_LOGE("[TfLiteEngine] %s", lastError_.c_str());
@@ -66,6 +447,7 @@ bool TfLiteEngine::resizeInputTensor(int width, int height, int channels) {
         //NEP_LOGE("[TfLiteEngine] %s", lastError_.c_str());
         return false;
     }
+    customInputDims_ = {height, width, channels};
     updateInputDims();
     return true;
 }
@@ -85,16 +467,14 @@ bool TfLiteEngine::setInputTensor(const std::vector<float>& inputData) {
         lastError_ = "Null input tensor";
         return false;
     }
-    if (tensor->type != kTfLiteFloat32) {
-        lastError_ = "Input tensor type is not float32";
+    const TensorType type = toTensorType(tensor->type);
+    if (type == TensorType::UNKNOWN) {
+        lastError_ = "Input tensor type is not float32, uint8 or int8";
         return false;
     }
 
     // Compute expected element count
-    int64_t elems = 1;
-    for (int i = 0; i < tensor->dims->size; ++i) {
-        elems *= tensor->dims->data[i];
-    }
+    const int64_t elems = elementCount(tensor);
 
     if (static_cast<int64_t>(inputData.size()) != elems) {
         lastError_ = "Input size mismatch: got " + std::to_string(inputData.size())
@@ -103,46 +483,230 @@ bool TfLiteEngine::setInputTensor(const std::vector<float>& inputData) {
         return false;
     }
 
-    std::memcpy(tensor->data.f, inputData.data(), elems * sizeof(float));
+    if (type == TensorType::FLOAT32) {
+        std::memcpy(tensor->data.f, inputData.data(), elems * sizeof(float));
+        return true;
+    }
+
+    // Quantized input: real values are mapped with the tensor's scale/zero point.
+    const float scale = tensor->params.scale;
+    const int32_t zeroPoint = tensor->params.zero_point;
+    if (scale <= 0.0f) {
+        lastError_ = "Quantized input tensor has no scale";
+        return false;
+    }
+    for (int64_t i = 0; i < elems; ++i) {
+        const int32_t q = quantizeValue(inputData[i], scale, zeroPoint, type);
+        if (type == TensorType::UINT8) tensor->data.uint8[i] = static_cast<uint8_t>(q);
+        else tensor->data.int8[i] = static_cast<int8_t>(q);
+    }
     return true;
 }
 
+InputTensorView TfLiteEngine::inputTensorView(int index) {
+    InputTensorView view;
+    if (!interpreter_) {
+        lastError_ = "Interpreter not initialized";
+        return view;
+    }
+    const auto& ins = interpreter_->inputs();
+    if (index < 0 || index >= static_cast<int>(ins.size())) {
+        lastError_ = "Input index out of range: " + std::to_string(index);
+        return view;
+    }
+
+    TfLiteTensor* tensor = interpreter_->tensor(ins[index]);
+    if (!tensor || !tensor->dims || !tensor->data.raw) {
+        lastError_ = "Null input tensor";
+        return view;
+    }
+    if (tensor->dims->size > kMaxTensorRank) {
+        lastError_ = "Input tensor rank too large: " + std::to_string(tensor->dims->size);
+        return view;
+    }
+
+    view.data = tensor->data.raw;
+    view.type = toTensorType(tensor->type);
+    view.rank = tensor->dims->size;
+    view.bytes = tensor->bytes;
+    view.scale = tensor->params.scale;
+    view.zeroPoint = tensor->params.zero_point;
+    int64_t stride = 1;
+    for (int i = view.rank - 1; i >= 0; --i) {
+        view.shape[i] = tensor->dims->data[i];
+        view.strides[i] = stride;
+        stride *= view.shape[i];
+    }
+    return view;
+}
+
 bool TfLiteEngine::invoke() {
     if (!interpreter_) {
         lastError_ = "Interpreter not initialized";
         return false;
     }
-    if (interpreter_->Invoke() != kTfLiteOk) {
+    if (!profiler_) {
+        if (interpreter_->Invoke() != kTfLiteOk) {
+            lastError_ = "Interpreter Invoke() failed";
+            return false;
+        }
+        return true;
+    }
+
+    profiler_->Reset();
+    profiler_->StartProfiling();
+    const auto start = std::chrono::steady_clock::now();
+    const TfLiteStatus status = interpreter_->Invoke();
+    const double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    profiler_->StopProfiling();
+    if (status != kTfLiteOk) {
         lastError_ = "Interpreter Invoke() failed";
         return false;
     }
+    invokeSamples_.push_back(us);
+    collectProfileEvents();
     return true;
 }
 
+bool TfLiteEngine::enableProfiling(int maxEventsPerInvoke) {
+    if (!interpreter_) {
+        lastError_ = "Interpreter not initialized";
+        return false;
+    }
+    if (!profiler_) {
+        // Grows past maxEventsPerInvoke instead of dropping events.
+        profiler_ = std::make_unique<::tflite::profiling::BufferedProfiler>(
+            static_cast<uint32_t>(std::max(1, maxEventsPerInvoke)), true);
+        if (backend_ == InferenceBackend::XNNPACK && !rebuildForProfiling()) return false;
+    }
+    interpreter_->SetProfiler(profiler_.get());
+    resetProfile();
+    return true;
+}
+
+bool TfLiteEngine::rebuildForProfiling() {
+    // The delegate was applied without a profiler and would report no ops,
+    // so rebuild it (and drop parked interpreters) now that there is one.
+    batchCache_.clear();
+    bool built = buildInterpreter(true, batchSize_);
+    if (!built) built = buildInterpreter(false, batchSize_);
+    if (!built) {
+        profiler_.reset();
+        return false;
+    }
+    updateInputDims();
+    return true;
+}
+
+void TfLiteEngine::disableProfiling() {
+    if (!profiler_) return;
+    if (interpreter_) interpreter_->SetProfiler(nullptr);
+    for (auto& entry : batchCache_) {
+        if (entry.second.interpreter) entry.second.interpreter->SetProfiler(nullptr);
+    }
+    profiler_.reset();
+}
+
+void TfLiteEngine::resetProfile() {
+    opSamples_.clear();
+    invokeSamples_.clear();
+}
+
+void TfLiteEngine::collectProfileEvents() {
+    using EventType = ::tflite::Profiler::EventType;
+    for (const ::tflite::profiling::ProfileEvent* event : profiler_->GetProfileEvents()) {
+        if (!event) continue;
+        const bool delegated = event->event_type == EventType::DELEGATE_OPERATOR_INVOKE_EVENT;
+        if (event->event_type != EventType::OPERATOR_INVOKE_EVENT && !delegated) continue;
+
+        const int node = static_cast<int>(event->event_metadata);
+        OpSamples& samples = opSamples_[OpKey(batchSize_, node, delegated, event->tag)];
+        if (samples.name.empty()) {
+            samples.name = event->tag;
+            // Name primary-subgraph nodes after their first output tensor.
+            const auto* nodeReg = (!delegated && event->extra_event_metadata == 0)
+                ? interpreter_->node_and_registration(node) : nullptr;
+            const TfLiteIntArray* outputs = nodeReg ? nodeReg->first.outputs : nullptr;
+            if (outputs && outputs->size > 0) {
+                const TfLiteTensor* t = interpreter_->tensor(outputs->data[0]);
+                if (t && t->name) samples.name = t->name;
+            }
+        }
+        samples.us.push_back(static_cast<double>(event->elapsed_time));
+    }
+}
+
+OpProfile TfLiteEngine::opProfile() const {
+    OpProfile profile;
+    profile.model = timing_.model;
+    profile.invokes = static_cast<int>(invokeSamples_.size());
+    OpProfile::summarize(invokeSamples_, profile.invokeMeanUs, profile.invokeP95Us);
+
+    profile.ops.reserve(opSamples_.size());
+    for (const auto& [key, samples] : opSamples_) {
+        OpProfileStat stat;
+        stat.batchSize = std::get<0>(key);
+        stat.nodeIndex = std::get<1>(key);
+        stat.delegated = std::get<2>(key);
+        stat.type = std::get<3>(key);
+        stat.name = samples.name;
+        stat.count = static_cast<int>(samples.us.size());
+        OpProfile::summarize(samples.us, stat.meanUs, stat.p95Us);
+        stat.totalUs = stat.meanUs * stat.count;
+        profile.ops.push_back(std::move(stat));
+    }
+    std::sort(profile.ops.begin(), profile.ops.end(),
+              [](const OpProfileStat& a, const OpProfileStat& b) { return a.totalUs > b.totalUs; });
+    return profile;
+}
+
 std::vector<float> TfLiteEngine::getOutputTensor(int index) const {
-    std::vector<float> out;
-    if (!interpreter_) return out;
+    OutputTensorView view = outputTensorView(index);
+    std::vector<float> out(view.size);
+    for (size_t i = 0; i < view.size; ++i) out[i] = view[i];
+    return out;
+}
+
+OutputTensorView TfLiteEngine::outputTensorView(int index) const {
+    OutputTensorView view;
+    if (!interpreter_) return view;
     const auto& outs = interpreter_->outputs();
-    if (index < 0 || index >= static_cast<int>(outs.size())) return out;
+    if (index < 0 || index >= static_cast<int>(outs.size())) return view;
 
     const TfLiteTensor* t = interpreter_->tensor(outs[index]);
-    if (!t || t->type != kTfLiteFloat32) return out;
+    if (!t || !t->data.raw) return view;
+    const TensorType type = toTensorType(t->type);
+    const int64_t elems = elementCount(t);
+    if (type == TensorType::UNKNOWN || elems <= 0) return view;
 
-    int64_t elems = 1;
-    for (int i = 0; i < t->dims->size; ++i) elems *= t->dims->data[i];
+    view.data = t->data.raw_const;
+    view.type = type;
+    view.size = static_cast<size_t>(elems);
+    view.scale = t->params.scale;
+    view.zeroPoint = t->params.zero_point;
+    return view;
+}
+
+TensorSpan<float> TfLiteEngine::outputTensorSpan(int index) const {
+    if (!interpreter_) return {};
+    const auto& outs = interpreter_->outputs();
+    if (index < 0 || index >= static_cast<int>(outs.size())) return {};
+
+    const TfLiteTensor* t = interpreter_->tensor(outs[index]);
+    if (!t || !t->dims || t->type != kTfLiteFloat32) return {};
+
+    const int64_t elems = elementCount(t);
 
     const float* data = t->data.f;
-    if (!data || elems <= 0) return out;
+    if (!data || elems <= 0) return {};
 
-    out.assign(data, data + elems);
-    return out;
+    return TensorSpan<float>(data, static_cast<size_t>(elems));
 }
 
 int TfLiteEngine::getInputTensorSize() const {
     if (!interpreter_ || interpreter_->inputs().empty()) return 0;
     const TfLiteTensor* t = interpreter_->tensor(interpreter_->inputs()[0]);
-    if (!t) return 0;
-    return t->bytes / static_cast<int>(sizeof(float));
+    return static_cast<int>(elementCount(t));
 }
 
 int TfLiteEngine::getOutputTensorSize(int index) const {
@@ -150,8 +714,7 @@ int TfLiteEngine::getOutputTensorSize(int index) const {
     const auto& outs = interpreter_->outputs();
     if (index < 0 || index >= static_cast<int>(outs.size())) return 0;
     const TfLiteTensor* t = interpreter_->tensor(outs[index]);
-    if (!t) return 0;
-    return t->bytes / static_cast<int>(sizeof(float));
+    return static_cast<int>(elementCount(t));
 }
 
 int TfLiteEngine::getNumOutputs() const {
@@ -1,21 +1,315 @@
 #include "neptune/Log.h"
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 namespace neptune {
 
+std::atomic<int> Log::level_{static_cast<int>(LogLevel::Info)};
+
+namespace {
+
+// One queued line in fixed storage, so logging threads never allocate.
+// Longer tags and messages are truncated.
+struct QueuedLine {
+    static constexpr size_t kMaxTag = 32;
+    static constexpr size_t kMaxMessage = 472;
+
+    LogLevel level;
+    uint16_t tagLength;
+    uint16_t messageLength;
+    char tag[kMaxTag];
+    char message[kMaxMessage];
+};
+
+uint16_t copyTruncated(char* dst, size_t capacity, const char* src, size_t length) {
+    if (length <= capacity) {
+        std::memcpy(dst, src, length);
+        return static_cast<uint16_t>(length);
+    }
+    std::memcpy(dst, src, capacity - 3);
+    std::memcpy(dst + capacity - 3, "...", 3);
+    return static_cast<uint16_t>(capacity);
+}
+
+// Single-producer/single-consumer ring: the owning thread pushes, whoever
+// holds the sink lock drains.
+class LineRing {
+public:
+    explicit LineRing(size_t capacity) : lines_(capacity), mask_(capacity - 1) {}
+
+    void push(LogLevel level, const char* tag, const std::string& message) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) == lines_.size()) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        QueuedLine& line = lines_[head & mask_];
+        line.level = level;
+        line.tagLength = copyTruncated(line.tag, QueuedLine::kMaxTag, tag, std::strlen(tag));
+        line.messageLength = copyTruncated(line.message, QueuedLine::kMaxMessage, message.data(), message.size());
+        head_.store(head + 1, std::memory_order_release);
+    }
+
+    template <typename Emit>
+    void drain(Emit&& emit) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        const size_t head = head_.load(std::memory_order_acquire);
+        for (; tail != head; ++tail) {
+            emit(lines_[tail & mask_]);
+        }
+        tail_.store(tail, std::memory_order_release);
+    }
+
+    bool empty() const {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_relaxed);
+    }
+
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+    std::atomic<bool> retired{false};   // owning thread has exited
+
+private:
+    std::vector<QueuedLine> lines_;
+    size_t mask_;
+    alignas(64) std::atomic<size_t> head_{0};
+    alignas(64) std::atomic<size_t> tail_{0};
+    std::atomic<uint64_t> dropped_{0};
+};
+
+// Marks the thread's ring retired when the thread exits; the writer frees
+// it once drained.
+struct ThreadRing {
+    std::shared_ptr<LineRing> ring;
+    ~ThreadRing() {
+        if (ring) ring->retired.store(true, std::memory_order_release);
+    }
+};
+
+size_t roundUpToPowerOfTwo(size_t n) {
+    size_t p = 2;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+class Backend {
+public:
+    // Never destroyed: lines logged from static destructors must still find
+    // a sink. startAsync() registers an atexit hook that drains the queues.
+    static Backend& instance() {
+        static Backend* backend = new Backend();
+        return *backend;
+    }
+
+    void write(LogLevel level, const char* tag, const std::string& message) {
+        if (async_.load(std::memory_order_acquire)) {
+            // Announce the push before rechecking, so stop() either sees it
+            // in flight and waits, or this thread sees async_ cleared.
+            pushing_.fetch_add(1);
+            if (async_.load()) {
+                threadRing().push(level, tag, message);
+                pushing_.fetch_sub(1, std::memory_order_release);
+                return;
+            }
+            pushing_.fetch_sub(1, std::memory_order_relaxed);
+        }
+        std::lock_guard<std::mutex> lock(sinkMutex_);
+        sink_->write(LogRecord{level, tag, message});
+        sink_->flush();
+    }
+
+    void setSink(std::shared_ptr<LogSink> sink) {
+        std::lock_guard<std::mutex> lock(sinkMutex_);
+        drainLocked();
+        sink_ = sink ? std::move(sink) : std::make_shared<ConsoleSink>();
+    }
+
+    void start(const LogAsyncOptions& options) {
+        std::lock_guard<std::mutex> control(controlMutex_);
+        if (writer_.joinable()) return;
+        if (!atexitRegistered_) {
+            std::atexit([] { Backend::instance().stop(); });
+            atexitRegistered_ = true;
+        }
+        capacity_.store(roundUpToPowerOfTwo(std::max<size_t>(options.queueCapacity, 2)), std::memory_order_relaxed);
+        const auto interval = std::chrono::milliseconds(std::max(1, options.flushIntervalMs));
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex_);
+            stopping_ = false;
+        }
+        writer_ = std::thread([this, interval] { run(interval); });
+        async_.store(true, std::memory_order_release);
+    }
+
+    void stop() {
+        std::lock_guard<std::mutex> control(controlMutex_);
+        if (!writer_.joinable()) return;
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex_);
+            stopping_ = true;
+        }
+        wake_.notify_one();
+        writer_.join();
+
+        // Holding the sink lock keeps synchronous lines behind the queued
+        // ones. Lines pushed by threads that saw async_ just before it was
+        // cleared must land before the final drain.
+        std::lock_guard<std::mutex> lock(sinkMutex_);
+        async_.store(false);
+        while (pushing_.load(std::memory_order_acquire) != 0) std::this_thread::yield();
+        drainLocked();
+    }
+
+    bool isAsync() const { return async_.load(std::memory_order_acquire); }
+
+    void flush() {
+        std::lock_guard<std::mutex> lock(sinkMutex_);
+        drainLocked();
+    }
+
+    uint64_t dropped() {
+        std::lock_guard<std::mutex> lock(registryMutex_);
+        uint64_t total = retiredDropped_;
+        for (const auto& ring : rings_) total += ring->dropped();
+        return total;
+    }
+
+private:
+    Backend() : sink_(std::make_shared<ConsoleSink>()) {}
+
+    // Rings keep the capacity they were created with.
+    LineRing& threadRing() {
+        thread_local ThreadRing local;
+        if (!local.ring) {
+            local.ring = std::make_shared<LineRing>(capacity_.load(std::memory_order_relaxed));
+            std::lock_guard<std::mutex> lock(registryMutex_);
+            rings_.push_back(local.ring);
+        }
+        return *local.ring;
+    }
+
+    void run(std::chrono::milliseconds interval) {
+        std::unique_lock<std::mutex> lock(wakeMutex_);
+        while (!stopping_) {
+            wake_.wait_for(lock, interval, [this] { return stopping_; });
+            lock.unlock();
+            flush();
+            lock.lock();
+        }
+    }
+
+    // Requires sinkMutex_. Writes every queued line, reports new drops and
+    // frees the rings of threads that have exited.
+    void drainLocked() {
+        {
+            std::lock_guard<std::mutex> lock(registryMutex_);
+            snapshot_.assign(rings_.begin(), rings_.end());
+        }
+        uint64_t dropped = 0;
+        for (const auto& ring : snapshot_) {
+            ring->drain([this](const QueuedLine& line) {
+                sink_->write(LogRecord{line.level, std::string_view(line.tag, line.tagLength),
+                                       std::string_view(line.message, line.messageLength)});
+            });
+            dropped += ring->dropped();
+        }
+        snapshot_.clear();
+
+        {
+            std::lock_guard<std::mutex> lock(registryMutex_);
+            dropped += retiredDropped_;
+            rings_.erase(std::remove_if(rings_.begin(), rings_.end(),
+                                        [this](const std::shared_ptr<LineRing>& ring) {
+                                            if (!ring->retired.load(std::memory_order_acquire) || !ring->empty()) {
+                                                return false;
+                                            }
+                                            retiredDropped_ += ring->dropped();
+                                            return true;
+                                        }),
+                         rings_.end());
+        }
+
+        if (dropped > reportedDropped_) {
+            const std::string message = std::to_string(dropped - reportedDropped_) +
+                                        " log lines dropped, queue full";
+            sink_->write(LogRecord{LogLevel::Warn, "Log", message});
+            reportedDropped_ = dropped;
+        }
+        sink_->flush();
+    }
+
+    std::atomic<bool> async_{false};
+    std::atomic<int> pushing_{0};          // write() calls between their async_ checks and the push
+    std::atomic<size_t> capacity_{256};
+
+    std::mutex sinkMutex_;                 // sink_, snapshot_, reportedDropped_
+    std::shared_ptr<LogSink> sink_;
+    std::vector<std::shared_ptr<LineRing>> snapshot_;
+    uint64_t reportedDropped_ = 0;
+
+    std::mutex registryMutex_;             // rings_, retiredDropped_; taken once per new thread
+    std::vector<std::shared_ptr<LineRing>> rings_;
+    uint64_t retiredDropped_ = 0;
+
+    std::mutex controlMutex_;              // start/stop
+    std::thread writer_;
+    bool atexitRegistered_ = false;
+
+    std::mutex wakeMutex_;
+    std::condition_variable wake_;
+    bool stopping_ = false;
+};
+
+} // namespace
+
+void Log::write(LogLevel level, const char* tag, const std::string& message) {
+    Backend::instance().write(level, tag, message);
+}
+
+void Log::setSink(std::shared_ptr<LogSink> sink) {
+    Backend::instance().setSink(std::move(sink));
+}
+
+void Log::startAsync(const LogAsyncOptions& options) {
+    Backend::instance().start(options);
+}
+
+void Log::stopAsync() {
+    Backend::instance().stop();
+}
+
+bool Log::isAsync() {
+    return Backend::instance().isAsync();
+}
+
+void Log::flush() {
+    Backend::instance().flush();
+}
+
+uint64_t Log::droppedMessages() {
+    return Backend::instance().dropped();
+}
+
 void Log::info(const std::string& tag, const std::string& message) {
-    std::cout << "[INFO][" << tag << "] " << message << std::endl;
+    if (enabled(LogLevel::Info)) write(LogLevel::Info, tag.c_str(), message);
 }
 
 void Log::warn(const std::string& tag, const std::string& message) {
-    std::cout << "[WARN][" << tag << "] " << message << std::endl;
+    if (enabled(LogLevel::Warn)) write(LogLevel::Warn, tag.c_str(), message);
 }
 
 void Log::error(const std::string& tag, const std::string& message) {
-    std::cerr << "[ERROR][" << tag << "] " << message << std::endl;
+    if (enabled(LogLevel::Error)) write(LogLevel::Error, tag.c_str(), message);
 }
 
 void Log::debug(const std::string& tag, const std::string& message) {
-    std::cout << "[DEBUG][" << tag << "] " << message << std::endl;
+    if (enabled(LogLevel::Debug)) write(LogLevel::Debug, tag.c_str(), message);
 }
 
-} // namespace neptune
\ No newline at end of file
+} // namespace neptune
@@ -0,0 +1,105 @@
+#include "neptune/LogSink.h"
+
+#include <filesystem>
+
+namespace neptune {
+
+const char* logLevelName(LogLevel level) {
+    switch (level) {
+        case LogLevel::Debug: return "DEBUG";
+        case LogLevel::Info: return "INFO";
+        case LogLevel::Warn: return "WARN";
+        case LogLevel::Error: return "ERROR";
+        default: return "";
+    }
+}
+
+namespace {
+
+void appendLine(std::string& out, const LogRecord& record) {
+    out.append("[").append(logLevelName(record.level)).append("][");
+    out.append(record.tag).append("] ").append(record.message).append("\n");
+}
+
+} // namespace
+
+void ConsoleSink::write(const LogRecord& record) {
+    appendLine(record.level == LogLevel::Error ? err_ : out_, record);
+}
+
+void ConsoleSink::flush() {
+    // No fflush: stdout stays buffered, stderr is not.
+    if (!out_.empty()) {
+        std::fwrite(out_.data(), 1, out_.size(), stdout);
+        out_.clear();
+    }
+    if (!err_.empty()) {
+        std::fwrite(err_.data(), 1, err_.size(), stderr);
+        err_.clear();
+    }
+}
+
+RotatingFileSink::RotatingFileSink(std::string path, size_t maxBytes, int maxFiles)
+    : path_(std::move(path)), maxBytes_(maxBytes), maxFiles_(maxFiles) {
+    open();
+}
+
+RotatingFileSink::~RotatingFileSink() {
+    if (file_) std::fclose(file_);
+}
+
+void RotatingFileSink::open() {
+    file_ = std::fopen(path_.c_str(), "ab");
+    if (!file_) return;
+    std::error_code ec;
+    const auto existing = std::filesystem::file_size(path_, ec);
+    size_ = ec ? 0 : static_cast<size_t>(existing);
+}
+
+void RotatingFileSink::rotate() {
+    std::fclose(file_);
+    file_ = nullptr;
+    std::error_code ec;
+    if (maxFiles_ <= 0) {
+        std::filesystem::remove(path_, ec);
+    } else {
+        std::filesystem::remove(path_ + "." + std::to_string(maxFiles_), ec);
+        for (int i = maxFiles_ - 1; i >= 1; --i) {
+            std::filesystem::rename(path_ + "." + std::to_string(i), path_ + "." + std::to_string(i + 1), ec);
+        }
+        std::filesystem::rename(path_, path_ + ".1", ec);
+    }
+    open();
+}
+
+void RotatingFileSink::write(const LogRecord& record) {
+    if (!file_) return;
+    std::string line;
+    appendLine(line, record);
+    if (size_ > 0 && size_ + line.size() > maxBytes_) {
+        rotate();
+        if (!file_) return;
+    }
+    size_ += std::fwrite(line.data(), 1, line.size(), file_);
+}
+
+void RotatingFileSink::flush() {
+    if (file_) std::fflush(file_);
+}
+
+void MemorySink::write(const LogRecord& record) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.push_back(Entry{record.level, std::string(record.tag), std::string(record.message)});
+}
+
+std::vector<MemorySink::Entry> MemorySink::entries() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_;
+}
+
+void MemorySink::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+}
+
+} // namespace neptune
@@ -0,0 +1,48 @@
+//
+// File: NeptuneFacialSDK/core/src/util/WorkerPool.cpp
+//
+// Implements the fixed-size worker thread pool.
+//
+
+#include "neptune/WorkerPool.h"
+
+namespace neptune {
+
+WorkerPool::WorkerPool(int threads) {
+    threads_.reserve(threads > 0 ? threads : 0);
+    for (int i = 0; i < threads; ++i) {
+        threads_.emplace_back([this] { run(); });
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (std::thread& thread : threads_) thread.join();
+}
+
+void WorkerPool::post(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.push_back(std::move(task));
+    }
+    wake_.notify_one();
+}
+
+void WorkerPool::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        wake_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+        if (tasks_.empty()) return;   // stopping, and nothing left to run
+        std::function<void()> task = std::move(tasks_.front());
+        tasks_.pop_front();
+        lock.unlock();
+        task();
+        lock.lock();
+    }
+}
+
+} // namespace neptune
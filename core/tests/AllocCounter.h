@@ -0,0 +1,27 @@
+//
+// File: NeptuneFacialSDK/core/tests/AllocCounter.h
+//
+// Counts heap allocations for the allocation checks of the tests: replaces
+// the global operator new/delete, so include it from exactly one source file
+// of a test executable. Set gCounting around the code under test and read
+// gAllocations afterwards.
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Heap allocations while counting is on.
+static std::atomic<bool> gCounting{false};
+static std::atomic<size_t> gAllocations{0};
+
+void* operator new(std::size_t size) {
+    if (gCounting.load(std::memory_order_relaxed)) gAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
@@ -0,0 +1,70 @@
+//
+// File: NeptuneFacialSDK/core/tests/TestUtil.h
+//
+// Helpers shared by the standalone tests and benchmarks.
+//
+
+#pragma once
+
+#include "neptune/TensorView.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+// Dense 1 x height x width x 3 tensor of `type`, without storage. Quantized
+// types map the [0, 1] range of normalized pixels onto their full range.
+inline neptune::InputTensorView nhwcView(neptune::TensorType type, int width, int height) {
+    neptune::InputTensorView view;
+    view.type = type;
+    view.rank = 4;
+    view.shape[0] = 1;
+    view.shape[1] = height;
+    view.shape[2] = width;
+    view.shape[3] = 3;
+    view.strides[3] = 1;
+    view.strides[2] = 3;
+    view.strides[1] = static_cast<int64_t>(width) * 3;
+    view.strides[0] = static_cast<int64_t>(height) * width * 3;
+    view.bytes = static_cast<size_t>(view.strides[0]) * neptune::tensorTypeSize(type);
+    if (view.isQuantized()) {
+        view.scale = 1.0f / 255.0f;
+        view.zeroPoint = type == neptune::TensorType::INT8 ? -128 : 0;
+    }
+    return view;
+}
+
+// A float tensor over `storage`, prefilled with -1 so pixels the
+// preprocessing misses stand out.
+inline neptune::InputTensorView makeView(std::vector<float>& storage, int width, int height) {
+    neptune::InputTensorView view = nhwcView(neptune::TensorType::FLOAT32, width, height);
+    storage.assign(static_cast<size_t>(view.elementCount()), -1.0f);
+    view.data = storage.data();
+    return view;
+}
+
+// A FLOAT32, UINT8 or INT8 tensor over `storage`, filled with 0xAB bytes so
+// unwritten elements show up.
+inline neptune::InputTensorView makeView(std::vector<uint8_t>& storage, neptune::TensorType type, int width,
+                                         int height) {
+    neptune::InputTensorView view = nhwcView(type, width, height);
+    storage.assign(view.bytes, 0xAB);
+    view.data = storage.data();
+    return view;
+}
+
+// Median wall time of `runs` calls of fn, in microseconds, after one untimed
+// call that sizes caches and scratch buffers.
+template <typename Fn>
+double medianUs(int runs, Fn&& fn) {
+    std::vector<double> samples(runs);
+    fn();
+    for (int i = 0; i < runs; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        fn();
+        samples[i] = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    }
+    std::nth_element(samples.begin(), samples.begin() + runs / 2, samples.end());
+    return samples[runs / 2];
+}
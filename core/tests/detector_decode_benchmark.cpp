@@ -0,0 +1,210 @@
+//
+// File: NeptuneFacialSDK/core/tests/detector_decode_benchmark.cpp
+//
+// Cost of decoding the face detector outputs (short range: 896 anchors,
+// full range: 2304) as the number of anchors above the score threshold
+// grows. The baseline is a plain scalar decoder: sigmoid on every anchor and
+// a FaceBox with a heap-allocated landmark vector per candidate. The new one
+// is DetectionDecoder: a logit compare per anchor, with SIMD decode of the
+// survivors only. Median microseconds over --runs calls. Before timing, it
+// checks that both produce the same boxes and keypoints, and exits non-zero
+// if they differ.
+//
+
+#include "TestUtil.h"
+#include "neptune/DetectionDecoder.h"
+#include "neptune/TensorView.h"
+#include "neptune/Types.h"
+
+#include <opencv2/core.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace neptune;
+
+namespace {
+
+constexpr float kMinConfidence = 0.5f;
+
+struct LegacyAnchor {
+    float x_center, y_center, w, h;
+};
+
+// Fixed-size anchors, one AoS entry each, in the model's output order.
+std::vector<LegacyAnchor> legacyAnchors(const DetectorSpec& spec) {
+    std::vector<LegacyAnchor> anchors;
+    const int numLayers = static_cast<int>(spec.strides.size());
+    for (int layer = 0; layer < numLayers;) {
+        int perCell = 0;
+        int last = layer;
+        for (; last < numLayers && spec.strides[last] == spec.strides[layer]; ++last) {
+            perCell += spec.interpolatedScale ? 2 : 1;
+        }
+        const int fm = static_cast<int>(std::ceil(static_cast<float>(spec.inputWidth) / spec.strides[layer]));
+        for (int y = 0; y < fm; ++y) {
+            for (int x = 0; x < fm; ++x) {
+                for (int a = 0; a < perCell; ++a) {
+                    anchors.push_back(LegacyAnchor{(x + 0.5f) / fm, (y + 0.5f) / fm, 1.0f, 1.0f});
+                }
+            }
+        }
+        layer = last;
+    }
+    return anchors;
+}
+
+void legacyDecode(const DetectorSpec& spec, const std::vector<LegacyAnchor>& anchors, const OutputTensorView& raw,
+                  const OutputTensorView& scores, const cv::Size& imageSize, std::vector<FaceBox>& decoded) {
+    const int n = static_cast<int>(scores.size);
+    const int kInput = spec.inputWidth;
+    const float ratio = std::min(static_cast<float>(kInput) / imageSize.width,
+                                 static_cast<float>(kInput) / imageSize.height);
+    const int padX = static_cast<int>((kInput - imageSize.width * ratio) * 0.5f);
+    const int padY = static_cast<int>((kInput - imageSize.height * ratio) * 0.5f);
+    const float scale = spec.boxScale;
+    decoded.clear();
+    decoded.reserve(n);
+    for (int i = 0; i < n; ++i) {
+        const float score = 1.0f / (1.0f + std::exp(-scores[i]));
+        if (score < kMinConfidence) continue;
+        const int off = i * 16;
+        const LegacyAnchor an = anchors[i];
+        const float xc = an.x_center + raw[off + 0] / scale * an.w;
+        const float yc = an.y_center + raw[off + 1] / scale * an.h;
+        const float wn = raw[off + 2] / scale * an.w;
+        const float hn = raw[off + 3] / scale * an.h;
+        const int x1t = static_cast<int>(std::clamp(xc - 0.5f * wn, 0.0f, 1.0f) * kInput);
+        const int y1t = static_cast<int>(std::clamp(yc - 0.5f * hn, 0.0f, 1.0f) * kInput);
+        const int x2t = static_cast<int>(std::clamp(xc + 0.5f * wn, 0.0f, 1.0f) * kInput);
+        const int y2t = static_cast<int>(std::clamp(yc + 0.5f * hn, 0.0f, 1.0f) * kInput);
+        const int x1 = std::clamp(static_cast<int>((x1t - padX) / ratio), 0, imageSize.width - 1);
+        const int y1 = std::clamp(static_cast<int>((y1t - padY) / ratio), 0, imageSize.height - 1);
+        const int x2 = std::clamp(static_cast<int>((x2t - padX) / ratio), 0, imageSize.width - 1);
+        const int y2 = std::clamp(static_cast<int>((y2t - padY) / ratio), 0, imageSize.height - 1);
+        if (x2 - x1 <= 0 || y2 - y1 <= 0) continue;
+
+        FaceBox fb;
+        fb.x = x1; fb.y = y1; fb.width = x2 - x1; fb.height = y2 - y1; fb.confidence = score;
+        for (int k = 4; k < 16; k += 2) {
+            const float lx = raw[off + k] / scale * an.w + an.x_center;
+            const float ly = raw[off + k + 1] / scale * an.h + an.y_center;
+            fb.landmarks.push_back(Point(
+                static_cast<float>(std::clamp(static_cast<int>((lx * kInput - padX) / ratio), 0, imageSize.width - 1)),
+                static_cast<float>(std::clamp(static_cast<int>((ly * kInput - padY) / ratio), 0, imageSize.height - 1))));
+        }
+        decoded.push_back(fb);
+    }
+}
+
+// Detector outputs with `faces` anchors above the threshold.
+void synthesize(int anchors, int faces, std::mt19937& rng, std::vector<float>& raw, std::vector<float>& scores) {
+    std::uniform_real_distribution<float> offset(-20.0f, 20.0f);
+    std::uniform_real_distribution<float> size(2.0f, 120.0f);
+    std::uniform_real_distribution<float> low(-12.0f, -0.5f);
+    std::uniform_real_distribution<float> high(0.1f, 6.0f);
+    raw.resize(static_cast<size_t>(anchors) * 16);
+    scores.resize(anchors);
+    for (int i = 0; i < anchors; ++i) {
+        float* r = &raw[static_cast<size_t>(i) * 16];
+        r[0] = offset(rng); r[1] = offset(rng);
+        r[2] = size(rng); r[3] = size(rng);
+        for (int k = 4; k < 16; ++k) r[k] = offset(rng);
+        scores[i] = low(rng);
+    }
+    std::vector<int> order(anchors);
+    for (int i = 0; i < anchors; ++i) order[i] = i;
+    std::shuffle(order.begin(), order.end(), rng);
+    for (int i = 0; i < faces && i < anchors; ++i) scores[order[i]] = high(rng);
+}
+
+OutputTensorView view(const std::vector<float>& data) {
+    OutputTensorView v;
+    v.data = data.data();
+    v.type = TensorType::FLOAT32;
+    v.size = data.size();
+    return v;
+}
+
+bool sameResults(const std::vector<FaceBox>& expected, const std::vector<FaceDetection>& actual) {
+    if (expected.size() != actual.size()) return false;
+    for (size_t i = 0; i < expected.size(); ++i) {
+        const FaceBox& e = expected[i];
+        const FaceDetection& a = actual[i];
+        if (e.x != a.x1 || e.y != a.y1 || e.width != a.width() || e.height != a.height() ||
+            std::abs(e.confidence - a.score) > 1e-6f) {
+            return false;
+        }
+        for (int k = 0; k < FaceDetection::kKeypoints; ++k) {
+            if (e.landmarks[k].x != a.keypoints[2 * k] || e.landmarks[k].y != a.keypoints[2 * k + 1]) return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int runs = 2000;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--runs" && i + 1 < argc) runs = std::max(1, std::atoi(argv[++i]));
+        else {
+            std::cout << "Usage: " << argv[0] << " [--runs <n>]\n";
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    std::mt19937 rng(1234);
+    std::vector<float> raw, scores;
+    std::vector<FaceBox> legacy;
+    std::vector<FaceDetection> decoded;
+    const cv::Size imageSize(1280, 720);
+
+    for (const auto& [name, spec] : {std::pair<const char*, DetectorSpec>{"short_range", DetectorSpec::shortRange()},
+                                     std::pair<const char*, DetectorSpec>{"full_range", DetectorSpec::fullRange()}}) {
+        const std::vector<LegacyAnchor> anchors = legacyAnchors(spec);
+        const DetectionDecoder decoder(spec, kMinConfidence);
+        const int n = static_cast<int>(decoder.anchorCount());
+        if (n != static_cast<int>(anchors.size()) || n != static_cast<int>(spec.anchorCount())) {
+            std::cerr << "FAIL: " << name << " anchor count " << n << " vs " << anchors.size() << "\n";
+            return 1;
+        }
+
+        // Same boxes and keypoints on many random outputs first.
+        for (int trial = 0; trial < 200; ++trial) {
+            synthesize(n, trial % 40, rng, raw, scores);
+            const cv::Size size(2 * (64 + static_cast<int>(rng() % 900)), 2 * (64 + static_cast<int>(rng() % 600)));
+            legacyDecode(spec, anchors, view(raw), view(scores), size, legacy);
+            decoded.clear();
+            decoder.decode(view(raw), view(scores), size, decoded);
+            if (!sameResults(legacy, decoded)) {
+                std::cerr << "FAIL: " << name << " decoders disagree on trial " << trial << "\n";
+                return 1;
+            }
+        }
+
+        std::cout << name << " (" << n << " anchors)\n";
+        std::cout << std::left << std::setw(12) << "survivors" << std::right << std::setw(14) << "legacy_us"
+                  << std::setw(14) << "decoder_us" << std::setw(10) << "speedup\n";
+        for (int faces : {0, 1, 2, 8, 32, 128}) {
+            synthesize(n, faces, rng, raw, scores);
+            const double before = medianUs(runs, [&] {
+                legacyDecode(spec, anchors, view(raw), view(scores), imageSize, legacy);
+            });
+            const double after = medianUs(runs, [&] {
+                decoded.clear();
+                decoder.decode(view(raw), view(scores), imageSize, decoded);
+            });
+            std::cout << std::left << std::setw(12) << faces << std::right << std::fixed << std::setprecision(2)
+                      << std::setw(14) << before << std::setw(14) << after << std::setw(9) << before / after << "x\n";
+        }
+    }
+    return 0;
+}
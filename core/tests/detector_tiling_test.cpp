@@ -0,0 +1,110 @@
+//
+// File: NeptuneFacialSDK/core/tests/detector_tiling_test.cpp
+//
+// Checks the per-model detector configuration and the tile layout used by
+// tiled detection:
+// - short and full range specs generate MediaPipe's 896 and 2304 anchors,
+//   and a full-range anchor decodes to the expected box and keypoint;
+// - tiles cover the frame, overlap, stay within maxTiles and never shrink
+//   below the model input; small frames are not tiled.
+// Exits non-zero on the first failure.
+//
+
+#include "neptune/DetectionDecoder.h"
+#include "neptune/TensorView.h"
+
+#include <opencv2/core.hpp>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+using namespace neptune;
+
+static bool expect(const char* what, bool ok) {
+    if (!ok) std::cerr << "FAIL: " << what << "\n";
+    return ok;
+}
+
+static OutputTensorView view(const std::vector<float>& data) {
+    OutputTensorView v;
+    v.data = data.data();
+    v.type = TensorType::FLOAT32;
+    v.size = data.size();
+    return v;
+}
+
+static bool testAnchorCounts() {
+    const DetectionDecoder shortRange(DetectorSpec::shortRange(), 0.5f);
+    const DetectionDecoder fullRange(DetectorSpec::fullRange(), 0.5f);
+    DetectorSpec spec;
+    return expect("short range anchors", shortRange.anchorCount() == 896) &&
+           expect("full range anchors", fullRange.anchorCount() == 2304) &&
+           expect("128x128 is short range", DetectorSpec::forInputSize(128, 128, spec) && spec.strides.size() == 4) &&
+           expect("192x192 is full range", DetectorSpec::forInputSize(192, 192, spec) && spec.strides.size() == 1) &&
+           expect("unknown input size", !DetectorSpec::forInputSize(256, 256, spec));
+}
+
+static bool testFullRangeDecode() {
+    const DetectionDecoder decoder(DetectorSpec::fullRange(), 0.5f);
+    const int n = static_cast<int>(decoder.anchorCount());
+    std::vector<float> boxes(static_cast<size_t>(n) * 16, 0.0f);
+    std::vector<float> scores(n, -10.0f);
+
+    // Cell (10, 20) of the 48x48 stride-4 map: center (42, 82) in model pixels.
+    const int anchor = 20 * 48 + 10;
+    scores[anchor] = 2.0f;
+    float* raw = &boxes[static_cast<size_t>(anchor) * 16];
+    raw[2] = 48.0f;   // width: 48 / 192 of the input
+    raw[3] = 24.0f;
+    raw[4] = 9.6f;    // first keypoint: 9.6 px right of the center
+
+    std::vector<FaceDetection> out;
+    decoder.decode(view(boxes), view(scores), cv::Size(192, 192), out);
+    if (!expect("one detection", out.size() == 1)) return false;
+    const FaceDetection& d = out[0];
+    const auto near = [](float a, float b) { return std::abs(a - b) <= 1.0f; };
+    return expect("score", std::abs(d.score - 1.0f / (1.0f + std::exp(-2.0f))) < 1e-6f) &&
+           expect("box x", near(d.x1, 18) && near(d.x2, 66)) &&
+           expect("box y", near(d.y1, 70) && near(d.y2, 94)) &&
+           expect("keypoint", near(d.keypoints[0], 51) && near(d.keypoints[1], 82));
+}
+
+static bool testTiles() {
+    const cv::Size frame(3840, 2160);
+    for (int maxTiles : {2, 4, 8, 16}) {
+        const std::vector<cv::Rect> tiles = detectionTiles(frame, 0, 0.2f, maxTiles, 192);
+        if (!expect("tiles within maxTiles", !tiles.empty() && static_cast<int>(tiles.size()) <= maxTiles)) {
+            return false;
+        }
+
+        // Every pixel column and row is covered, neighbours overlap, tiles stay inside.
+        std::vector<char> covered(static_cast<size_t>(frame.area()), 0);
+        for (const cv::Rect& tile : tiles) {
+            if (!expect("tile inside frame", (tile & cv::Rect(cv::Point(), frame)) == tile)) return false;
+            if (!expect("tile not below model input", tile.width >= 192 && tile.height >= 192)) return false;
+            for (int y = tile.y; y < tile.br().y; ++y) {
+                std::fill_n(covered.begin() + static_cast<size_t>(y) * frame.width + tile.x, tile.width, 1);
+            }
+        }
+        if (!expect("frame covered", std::count(covered.begin(), covered.end(), 1) == frame.area())) return false;
+        if (tiles.size() > 1 && !expect("tiles overlap", (tiles[0] & tiles[1]).area() > 0)) return false;
+    }
+
+    // More threads give smaller tiles.
+    const int side4 = detectionTiles(frame, 0, 0.2f, 4, 192)[0].width;
+    const int side16 = detectionTiles(frame, 0, 0.2f, 16, 192)[0].width;
+    if (!expect("tiles shrink with threads", side16 < side4)) return false;
+
+    // Fixed tile size: 640 px tiles with 20% overlap step by 512 px.
+    const std::vector<cv::Rect> fixed = detectionTiles(cv::Size(1920, 1080), 640, 0.2f, 1, 128);
+    return expect("fixed tile grid", fixed.size() == 4 * 2 && fixed[0].width == 640) &&
+           expect("small frame not tiled", detectionTiles(cv::Size(160, 120), 0, 0.2f, 8, 192).empty()) &&
+           expect("single thread not tiled", detectionTiles(frame, 0, 0.2f, 1, 192).empty());
+}
+
+int main() {
+    if (!testAnchorCounts() || !testFullRangeDecode() || !testTiles()) return 1;
+    std::cout << "detector_tiling_test passed\n";
+    return 0;
+}
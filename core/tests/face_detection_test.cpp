@@ -4,6 +4,7 @@
 #include "neptune/EmotionRecognizer.h"
 #include "neptune/LivenessChecker.h"
 #include "neptune/landmark_extractor.h"
+#include "neptune/EmbeddedModels.h"
 #include "neptune/Types.h"
 #include "neptune/Log.h"
 
@@ -69,14 +70,17 @@ int main(int argc, char** argv) {
     if (argc < 2) {
         std::cerr << "Usage:\n"
                   << "  " << argv[0] << " --image <path> [--backend <0=tflite|1=mediapipe|2=auto>] [--fps] [--debug]\n"
-                  << "  " << argv[0] << " --video [--backend <0|1|2>] [--fps] [--debug]\n";
+                  << "  " << argv[0] << " --video [--backend <0|1|2>] [--fps] [--debug]\n"
+                  << "  Inference: [--xnnpack] [--threads <n>] [--fp16]\n";
         return 1;
     }
 
-    // Default model paths (adjust paths if your build system places models elsewhere)
-    const std::string faceModelPath = "../../models/face_detection_short_range.tflite";
-    const std::string landmarkModelPath = "../../models/face_landmark.tflite";
-    const std::string emotionModelPath = "../../models/mobilenet_emotion.tflite";
+    // Default model paths: embedded models when built with NEPTUNE_EMBED_MODELS,
+    // otherwise files (adjust paths if your build system places models elsewhere)
+    const std::string faceModelPath =
+        embeddedOrPath("face_detection_short_range", "../../models/face_detection_short_range.tflite");
+    const std::string landmarkModelPath = embeddedOrPath("face_landmark", "../../models/face_landmark.tflite");
+    const std::string emotionModelPath = embeddedOrPath("mobilenet_emotion", "../../models/mobilenet_emotion.tflite");
 
     NeptuneConfig config;
     config.faceDetectionModelPath = faceModelPath;
@@ -87,6 +91,7 @@ int main(int argc, char** argv) {
     config.headYawChangeMinDeg = 20.0f;
     config.headPitchChangeMinDeg = 15.0f;
     config.livenessWindowMs = 3000.0;
+    config.warmUpModels = true;   // report first-invoke times below
 
     bool showFps = false;
     bool debugMode = false;
@@ -109,6 +114,12 @@ int main(int argc, char** argv) {
             imagePath = argv[++i];
         } else if (arg == "--video") {
             videoMode = true;
+        } else if (arg == "--xnnpack") {
+            config.useXnnpack = true;
+        } else if (arg == "--threads" && i + 1 < argc) {
+            config.numThreads = std::atoi(argv[++i]);
+        } else if (arg == "--fp16") {
+            config.allowFp16Inference = true;
         }
     }
 
@@ -126,13 +137,22 @@ int main(int argc, char** argv) {
     auto detector = FaceDetector::create(faceModelPath, config);
     auto emo = EmotionRecognizer::create(emotionModelPath, config);
     LivenessChecker liveness(config);
-    LandmarkExtractor landmarkExtractor(landmarkModelPath);
+    LandmarkExtractor landmarkExtractor(landmarkModelPath, config);
 
     if (!detector || !emo) {
         std::cerr << "ERROR: Failed to initialize detector or emotion recognizer.\n";
         return 1;
     }
 
+    std::cout << "Inference backends: detector=" << TfLiteEngine::backendName(detector->backend())
+              << " landmarks=" << TfLiteEngine::backendName(landmarkExtractor.backend())
+              << " emotion=" << TfLiteEngine::backendName(emo->backend()) << "\n";
+    for (const ModelStartupTiming& t : {detector->startupTiming(), landmarkExtractor.startupTiming(),
+                                        emo->startupTiming()}) {
+        std::cout << "Startup " << t.model << ": load " << t.loadMs << " ms, allocate " << t.allocateMs
+                  << " ms, first invoke " << t.firstInvokeMs << " ms\n";
+    }
+
     std::cout << "Neptune SDK initialized successfully!\n";
 
     // Set video mode based on input
@@ -159,8 +179,8 @@ int main(int argc, char** argv) {
             const auto& f = faces[i];
             cv::Rect r = clampRect(cv::Rect(f.x, f.y, f.width, f.height), image.size());
 
-            // Use Process(frame, rect) when the LandmarkExtractor expects a full-image + rect
-            auto landmarks2D = landmarkExtractor.Process(image, r);
+            // Full image + detection: the crop is rotated to the eye keypoints
+            auto landmarks2D = landmarkExtractor.Process(image, f);
 
             // The extractor returns absolute image coordinates (since we passed the full image + rect)
             faces[i].landmarks.clear();
@@ -176,9 +196,8 @@ int main(int argc, char** argv) {
             drawLandmarks(displayImage, faces[i].landmarks, cv::Scalar(255, 255, 0));
 
             if (!faces[i].landmarks.empty()) {
-                // For emotion/liveness we pass the cropped face ROI
-                cv::Mat faceROI = image(r).clone();
-                auto er = emo->predictEmotion(faceROI);
+                // Emotion is cropped and aligned from the full image as well
+                auto er = emo->predictEmotions(image, std::vector<FaceBox>{faces[i]})[0];
                 auto live = liveness.check(faces[i]); // Will immediately return NOT_LIVE for static images
 
                 std::string infoText = emotionToString(er.emotion) + " | " + livenessToString(live);
@@ -208,19 +227,21 @@ int main(int argc, char** argv) {
             if (frame.empty()) break;
 
             frameCounter++;
+            const auto frameTime = std::chrono::steady_clock::now();   // liveness runs on frame time
 
             auto start = std::chrono::high_resolution_clock::now();
             auto faces = detector->detectFaces(frame);
             auto end = std::chrono::high_resolution_clock::now();
             double detectionTime = std::chrono::duration<double, std::milli>(end - start).count();
+            for (auto& f : faces) f.detectionTime = frameTime;
 
             cv::Mat displayImage = frame.clone();
             for (size_t i = 0; i < faces.size(); ++i) {
                 const auto& f = faces[i];
                 cv::Rect r = clampRect(cv::Rect(f.x, f.y, f.width, f.height), frame.size());
 
-                // Match the LandmarkExtractor signature: pass full frame + rect so returned points are absolute
-                auto landmarks2D = landmarkExtractor.Process(frame, r);
+                // Full frame + detection, so returned points are absolute
+                auto landmarks2D = landmarkExtractor.Process(frame, f);
 
                 faces[i].landmarks.clear();
                 for (auto& p : landmarks2D) {
@@ -235,8 +256,7 @@ int main(int argc, char** argv) {
                 drawLandmarks(displayImage, faces[i].landmarks, cv::Scalar(255, 255, 0));
 
                 if (!faces[i].landmarks.empty()) {
-                    cv::Mat faceROI = frame(r).clone();
-                    auto er = emo->predictEmotion(faceROI);
+                    auto er = emo->predictEmotions(frame, std::vector<FaceBox>{faces[i]})[0];
                     auto live = liveness.check(faces[i]); // Will use proper temporal tracking for video
 
                     std::string infoText = emotionToString(er.emotion) + " | " + livenessToString(live);
@@ -0,0 +1,150 @@
+//
+// File: NeptuneFacialSDK/core/tests/face_tracker_benchmark.cpp
+//
+// FaceTracker on synthetic crowds of 10 to 400 faces: each face drifts with
+// its own velocity inside its own grid cell, its detections jitter by a few
+// percent, 5% of them are missed, and detections come in shuffled order.
+// Median microseconds per update() over --frames frames, per track count.
+// Exits non-zero if a face ever changes trackId once it has one, if faces
+// go without an id after warm-up, or if update() allocates after warm-up.
+//
+
+#include "AllocCounter.h"
+#include "neptune/FaceTracker.h"
+#include "neptune/Types.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace neptune;
+
+namespace {
+
+struct SimFace {
+    float x, y, vx, vy, size;
+    float cellX, cellY, cellSize;
+    int trackId = -1;
+};
+
+void step(SimFace& f) {
+    f.x += f.vx;
+    f.y += f.vy;
+    const float room = f.cellSize - f.size;
+    if (f.x < f.cellX || f.x > f.cellX + room) f.vx = -f.vx;
+    if (f.y < f.cellY || f.y > f.cellY + room) f.vy = -f.vy;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int frames = 300;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--frames" && i + 1 < argc) frames = std::max(50, std::atoi(argv[++i]));
+        else {
+            std::cout << "Usage: " << argv[0] << " [--frames <n>]\n";
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    std::cout << std::left << std::setw(10) << "tracks" << std::right << std::setw(14) << "update_us"
+              << std::setw(14) << "id_switches" << std::setw(14) << "allocations\n";
+    for (int count : {10, 50, 100, 200, 400}) {
+        NeptuneConfig config;
+        config.maxTracks = 512;
+        FaceTracker tracker(config);
+
+        // One face per cell of a square grid over a 3840x2160 frame.
+        std::mt19937 rng(11 + count);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        const int side = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(count))));
+        const float cell = std::min(3840.0f, 2160.0f) / side;
+        std::vector<SimFace> sim(count);
+        for (int i = 0; i < count; ++i) {
+            SimFace& f = sim[i];
+            f.cellX = (i % side) * cell;
+            f.cellY = (i / side) * cell;
+            f.cellSize = cell;
+            f.size = cell * (0.35f + 0.2f * unit(rng));
+            f.x = f.cellX + unit(rng) * (cell - f.size);
+            f.y = f.cellY + unit(rng) * (cell - f.size);
+            f.vx = (unit(rng) - 0.5f) * 0.04f * f.size;
+            f.vy = (unit(rng) - 0.5f) * 0.04f * f.size;
+        }
+
+        std::vector<FaceBox> faces;
+        std::vector<int> source;   // sim index of each detection
+        faces.reserve(count);
+        source.reserve(count);
+        std::vector<double> samples;
+        samples.reserve(frames);
+        int switches = 0, unassigned = 0;
+        size_t allocations = 0;
+        std::normal_distribution<float> jitter(0.0f, 0.02f);
+
+        for (int frame = 0; frame < frames; ++frame) {
+            faces.clear();
+            source.clear();
+            for (int i = 0; i < count; ++i) {
+                SimFace& f = sim[i];
+                step(f);
+                if (unit(rng) < 0.05f) continue;
+                FaceBox& box = faces.emplace_back();
+                box.x = static_cast<int>(f.x + jitter(rng) * f.size);
+                box.y = static_cast<int>(f.y + jitter(rng) * f.size);
+                box.width = box.height = static_cast<int>(f.size * (1.0f + jitter(rng)));
+                box.confidence = 0.9f;
+                source.push_back(i);
+            }
+            for (size_t i = faces.size(); i > 1; --i) {
+                const size_t j = rng() % i;
+                std::swap(faces[i - 1], faces[j]);
+                std::swap(source[i - 1], source[j]);
+            }
+
+            const bool warm = frame >= 10;
+            gAllocations = 0;
+            gCounting = warm;
+            const auto start = std::chrono::steady_clock::now();
+            tracker.update(faces);
+            const double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+            gCounting = false;
+            if (!warm) continue;
+            allocations += gAllocations;
+            samples.push_back(us);
+
+            for (size_t k = 0; k < faces.size(); ++k) {
+                SimFace& f = sim[source[k]];
+                if (faces[k].trackId < 0) {
+                    ++unassigned;
+                } else if (f.trackId < 0) {
+                    f.trackId = faces[k].trackId;
+                } else if (f.trackId != faces[k].trackId) {
+                    ++switches;
+                    f.trackId = faces[k].trackId;
+                }
+            }
+        }
+
+        std::nth_element(samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+        std::cout << std::left << std::setw(10) << count << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(14) << samples[samples.size() / 2] << std::setw(14) << switches
+                  << std::setw(13) << allocations << "\n";
+        if (switches > 0 || allocations > 0) {
+            std::cerr << "FAIL: " << count << " tracks: " << switches << " id switches, " << allocations
+                      << " allocations after warm-up\n";
+            return 1;
+        }
+        if (unassigned > count) {
+            std::cerr << "FAIL: " << count << " tracks: " << unassigned << " detections without an id after warm-up\n";
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,106 @@
+//
+// File: NeptuneFacialSDK/core/tests/landmark_tracking_test.cpp
+//
+// Detect-once-then-track on a synthetic clip: a still face image panned a
+// few pixels per frame. Checks that LandmarkTracker keeps the face on every
+// frame, follows the pan, and runs the detector only on the first frame and
+// every --interval frames after. Prints detector runs and the average time
+// per frame with and without tracking. Exits non-zero on failure.
+//
+
+#include "neptune/EmbeddedModels.h"
+#include "neptune/FaceDetector.h"
+#include "neptune/LandmarkTracker.h"
+#include "neptune/Types.h"
+#include "neptune/landmark_extractor.h"
+
+#include <opencv2/opencv.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+using namespace neptune;
+
+int main(int argc, char** argv) {
+    std::string imagePath = "../tests/assets/face.jpeg";
+    int frames = 90;
+    int interval = 30;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--image" && i + 1 < argc) imagePath = argv[++i];
+        else if (arg == "--frames" && i + 1 < argc) frames = std::max(2, std::atoi(argv[++i]));
+        else if (arg == "--interval" && i + 1 < argc) interval = std::atoi(argv[++i]);
+        else {
+            std::cout << "Usage: " << argv[0] << " [--image <path>] [--frames <n>] [--interval <n>]\n";
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    const cv::Mat still = cv::imread(imagePath);
+    if (still.empty()) {
+        std::cerr << "FAIL: cannot read " << imagePath << "\n";
+        return 1;
+    }
+
+    NeptuneConfig config;
+    config.maxFaces = 1;
+    config.trackFaces = true;
+    config.redetectIntervalFrames = interval;
+    auto detector = FaceDetector::create(
+        embeddedOrPath("face_detection_short_range", "../../models/face_detection_short_range.tflite"), config);
+    LandmarkExtractor landmarks(embeddedOrPath("face_landmark", "../../models/face_landmark.tflite"), config);
+    if (!detector || !landmarks.isLoaded()) {
+        std::cerr << "FAIL: cannot load the detection or landmark model\n";
+        return 1;
+    }
+
+    // Frame k is the image shifted right by k/3 pixels (borders replicated).
+    const auto frameAt = [&](int k, cv::Mat& frame) {
+        const cv::Matx23f shift(1, 0, k / 3.0f, 0, 1, 0);
+        cv::warpAffine(still, frame, shift, still.size(), cv::INTER_LINEAR, cv::BORDER_REPLICATE);
+    };
+
+    LandmarkTracker tracker(*detector, landmarks, config);
+    cv::Mat frame;
+    float firstCenter = 0.0f;
+    double trackedMs = 0.0;
+    for (int k = 0; k < frames; ++k) {
+        frameAt(k, frame);
+        const auto start = std::chrono::steady_clock::now();
+        const std::vector<FaceBox> faces = tracker.track(frame);
+        trackedMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (faces.size() != 1 || faces[0].landmarks.size() < 468) {
+            std::cerr << "FAIL: frame " << k << ": " << faces.size() << " faces\n";
+            return 1;
+        }
+        const float center = faces[0].x + 0.5f * faces[0].width;
+        if (k == 0) firstCenter = center;
+        if (std::abs(center - firstCenter - k / 3.0f) > 0.05f * faces[0].width) {
+            std::cerr << "FAIL: frame " << k << ": face center " << center << " did not follow the pan\n";
+            return 1;
+        }
+    }
+
+    const uint64_t expectedRuns = interval > 0 ? 1 + (frames - 1) / interval : 1;
+    const TrackingStats& stats = tracker.stats();
+    if (stats.detectorRuns != expectedRuns) {
+        std::cerr << "FAIL: detector ran on " << stats.detectorRuns << " frames, expected " << expectedRuns << "\n";
+        return 1;
+    }
+
+    // Same clip, detector plus landmarks on every frame.
+    double detectMs = 0.0;
+    for (int k = 0; k < frames; ++k) {
+        frameAt(k, frame);
+        const auto start = std::chrono::steady_clock::now();
+        std::vector<FaceBox> faces = detector->detectFaces(frame);
+        auto meshes = landmarks.processBatch(frame, faces);
+        detectMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    std::cout << "frames " << stats.frames << ", detector runs " << stats.detectorRuns << "\n"
+              << "per frame: tracking " << trackedMs / frames << " ms, detect every frame "
+              << detectMs / frames << " ms\n";
+    return 0;
+}
@@ -0,0 +1,264 @@
+//
+// File: NeptuneFacialSDK/core/tests/liveness_tracking_test.cpp
+//
+// Per-face liveness state on synthetic 468-point meshes. A blinking face and
+// a still one side by side, in alternating order, must end LIVE and NOT_LIVE
+// respectively, even while the blinking one drifts. A slab smaller than the
+// crowd must evict without losing the faces it keeps. Crowds of 25 to 400
+// blinking faces must all end LIVE; prints microseconds per face for each.
+// After warm-up, check() and checkFrame() into reused results must not
+// allocate. A 30 s clip in stream time must reach the timed states (probation,
+// expiry) at CPU speed, identically on two runs. Exits non-zero on failure.
+//
+
+#include "AllocCounter.h"
+#include "neptune/LivenessChecker.h"
+#include "neptune/Log.h"
+#include "neptune/Types.h"
+
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace neptune;
+
+namespace {
+
+// Both eyes: the six EAR points (outer corner, two upper lid, inner corner,
+// two lower lid), as LivenessChecker reads them.
+const int kRightEye[6] = {33, 159, 158, 133, 145, 153};
+const int kLeftEye[6] = {263, 387, 385, 362, 380, 373};
+
+// Stream time of a frame of 30 fps video; starts after zero, which means unset
+std::chrono::steady_clock::time_point frameTime(int frame) {
+    return std::chrono::steady_clock::time_point(std::chrono::microseconds((frame + 1) * 33333LL));
+}
+
+// A frontal face mesh in a size x size box at (x, y), on the given frame;
+// ear is the eye aspect ratio of both eyes.
+FaceBox makeFace(int frame, float x, float y, float size, float ear) {
+    FaceBox face;
+    face.detectionTime = frameTime(frame);
+    face.x = static_cast<int>(x);
+    face.y = static_cast<int>(y);
+    face.width = face.height = static_cast<int>(size);
+    face.confidence = 0.9f;
+    face.landmarks.assign(468, Point{x + 0.5f * size, y + 0.5f * size});
+    face.landmarks[10] = Point{x + 0.5f * size, y + 0.1f * size};    // forehead
+    face.landmarks[175] = Point{x + 0.5f * size, y + 0.9f * size};   // chin
+    const float lid = 0.5f * ear * 0.2f * size;   // EAR = 2 * (2 * lid) / (2 * 0.2 * size)
+    for (int eye = 0; eye < 2; ++eye) {
+        const int* idx = eye == 0 ? kRightEye : kLeftEye;
+        const float ex = x + (eye == 0 ? 0.3f : 0.7f) * size;
+        const float ey = y + 0.4f * size;
+        face.landmarks[idx[0]] = Point{ex - 0.1f * size, ey};
+        face.landmarks[idx[1]] = Point{ex - 0.03f * size, ey - lid};
+        face.landmarks[idx[2]] = Point{ex + 0.03f * size, ey - lid};
+        face.landmarks[idx[3]] = Point{ex + 0.1f * size, ey};
+        face.landmarks[idx[4]] = Point{ex + 0.03f * size, ey + lid};
+        face.landmarks[idx[5]] = Point{ex - 0.03f * size, ey + lid};
+    }
+    return face;
+}
+
+// Eyes closed for 3 frames out of every 15, after the 10 calibration frames
+float blinkingEar(int frame) {
+    return frame >= 10 && frame % 15 < 3 ? 0.05f : 0.3f;
+}
+
+NeptuneConfig videoConfig() {
+    NeptuneConfig config;
+    config.livenessWindowMs = 60000.0;
+    return config;
+}
+
+bool testTwoFaces() {
+    LivenessChecker checker(videoConfig());
+    checker.setVideoMode(true);
+    std::vector<LivenessResult> results;
+    for (int frame = 0; frame < 60; ++frame) {
+        std::vector<FaceBox> faces = {
+            makeFace(frame, 100.0f + frame, 100.0f, 120.0f, blinkingEar(frame)),   // drifts right
+            makeFace(frame, 400.0f, 100.0f, 120.0f, 0.3f),
+        };
+        if (frame % 2) std::swap(faces[0], faces[1]);
+        results = checker.checkFrame(faces);
+        if (frame % 2) std::swap(results[0], results[1]);
+    }
+    if (checker.faceCount() != 2) {
+        std::cerr << "FAIL: two faces: " << checker.faceCount() << " liveness states\n";
+        return false;
+    }
+    if (results[0].status != LivenessStatus::LIVE || results[1].status != LivenessStatus::NOT_LIVE) {
+        std::cerr << "FAIL: two faces: blinking face '" << results[0].reason << "', still face '"
+                  << results[1].reason << "'\n";
+        return false;
+    }
+    return true;
+}
+
+bool testEviction() {
+    NeptuneConfig config = videoConfig();
+    config.livenessMaxFaces = 4;
+    LivenessChecker checker(config);
+    checker.setVideoMode(true);
+    // Six faces on the first frame; afterwards only the last four, which
+    // fill the slab and must keep their state.
+    std::vector<LivenessResult> results;
+    for (int frame = 0; frame < 60; ++frame) {
+        std::vector<FaceBox> faces;
+        for (int i = frame == 0 ? 0 : 2; i < 6; ++i) {
+            faces.push_back(makeFace(frame, 150.0f * i, 100.0f, 120.0f, blinkingEar(frame)));
+        }
+        results = checker.checkFrame(faces);
+    }
+    if (checker.faceCount() != 4) {
+        std::cerr << "FAIL: eviction: " << checker.faceCount() << " liveness states, slab holds 4\n";
+        return false;
+    }
+    for (const LivenessResult& r : results) {
+        if (r.status != LivenessStatus::LIVE) {
+            std::cerr << "FAIL: eviction: face lost its state: '" << r.reason << "'\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+bool testAllocations() {
+    LivenessChecker single(videoConfig());
+    LivenessChecker crowd(videoConfig());
+    single.setVideoMode(true);
+    crowd.setVideoMode(true);
+    LivenessResult result;
+    std::vector<LivenessResult> results;
+    std::vector<std::vector<FaceBox>> frames;   // meshes built up front
+    for (int frame = 0; frame < 120; ++frame) {
+        std::vector<FaceBox> faces;
+        for (int i = 0; i < 8; ++i) {
+            faces.push_back(makeFace(frame, 150.0f * i + 0.5f * frame, 100.0f, 120.0f, blinkingEar(frame + i)));
+        }
+        frames.push_back(std::move(faces));
+    }
+
+    size_t allocations = 0;
+    for (int frame = 0; frame < 120; ++frame) {
+        const bool warm = frame >= 20;
+        gAllocations = 0;
+        gCounting = warm;
+        single.check(frames[frame][0], result);
+        crowd.checkFrame(frames[frame], results);
+        gCounting = false;
+        if (warm) allocations += gAllocations;
+    }
+    if (allocations > 0) {
+        std::cerr << "FAIL: allocations: " << allocations << " heap allocations in 100 frames after warm-up\n";
+        return false;
+    }
+    if (result.status != LivenessStatus::LIVE || results[7].status != LivenessStatus::LIVE) {
+        std::cerr << "FAIL: allocations: blinking faces not LIVE: '" << result.reason << "'\n";
+        return false;
+    }
+    return true;
+}
+
+// 30 s of 30 fps video in stream time: a face that blinks twice early on and a
+// still one. Both must go through the timed states (probation, expiry of the
+// blinking face's liveness, the still face failing probation at 20 s) though
+// the clip runs far faster than real time, and a second run must give the
+// same results frame for frame.
+bool testStreamTime() {
+    const int frames = 900;
+    std::vector<std::vector<LivenessResult>> runs[2];
+    double wallMs = 0.0;
+    for (auto& run : runs) {
+        LivenessChecker checker{NeptuneConfig()};
+        checker.setVideoMode(true);
+        const auto start = std::chrono::steady_clock::now();
+        for (int frame = 0; frame < frames; ++frame) {
+            const float ear = frame < 40 ? blinkingEar(frame) : 0.3f;
+            run.push_back(checker.checkFrame({makeFace(frame, 100.0f, 100.0f, 120.0f, ear),
+                                              makeFace(frame, 400.0f, 100.0f, 120.0f, 0.3f)}));
+        }
+        wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    bool wasLive = false, expired = false;
+    for (int frame = 0; frame < frames; ++frame) {
+        for (int i = 0; i < 2; ++i) {
+            const LivenessResult& a = runs[0][frame][i];
+            const LivenessResult& b = runs[1][frame][i];
+            if (a.status != b.status || a.confidence != b.confidence || a.reason != b.reason) {
+                std::cerr << "FAIL: stream time: frame " << frame << " differs between runs: '" << a.reason
+                          << "' vs '" << b.reason << "'\n";
+                return false;
+            }
+        }
+        const LivenessResult& blinking = runs[0][frame][0];
+        wasLive = wasLive || blinking.status == LivenessStatus::LIVE;
+        expired = expired || (wasLive && blinking.reason.rfind("Liveness expired", 0) == 0);
+    }
+    const LivenessResult& still = runs[0][frames - 1][1];
+    if (!wasLive || !expired || still.reason.rfind("No liveness detected", 0) != 0) {
+        std::cerr << "FAIL: stream time: blinking face live " << wasLive << ", expired " << expired
+                  << ", still face '" << still.reason << "'\n";
+        return false;
+    }
+    std::cout << "stream time: 30000 ms of video checked in " << wallMs << " ms\n";
+    return true;
+}
+
+// Microseconds per face, or -1 when a blinking face of the crowd is not LIVE.
+double runCrowd(int count) {
+    NeptuneConfig config = videoConfig();
+    config.livenessMaxFaces = count;
+    LivenessChecker checker(config);
+    checker.setVideoMode(true);
+    const int side = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(count))));
+    const float cell = 2160.0f / side;
+    std::vector<FaceBox> faces;
+    std::vector<LivenessResult> results;
+    double us = 0.0;
+    const int frames = 60;
+    for (int frame = 0; frame < frames; ++frame) {
+        faces.clear();
+        for (int i = 0; i < count; ++i) {
+            const float drift = 0.02f * cell * std::sin(0.1f * frame + i);
+            faces.push_back(makeFace(frame, (i % side) * cell + 0.2f * cell + drift, (i / side) * cell + 0.2f * cell,
+                                     0.5f * cell, blinkingEar(frame + i % 5)));
+        }
+        const auto start = std::chrono::steady_clock::now();
+        results = checker.checkFrame(faces);
+        us += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    }
+    for (const LivenessResult& r : results) {
+        if (r.status != LivenessStatus::LIVE) return -1.0;
+    }
+    return us / (static_cast<double>(frames) * count);
+}
+
+} // namespace
+
+int main() {
+    Log::setLevel(LogLevel::Error);   // blinks are logged at info level
+
+    bool ok = testTwoFaces() && testEviction() && testAllocations() && testStreamTime();
+    if (ok) {
+        std::cout << std::left << std::setw(10) << "faces" << std::right << std::setw(14) << "us_per_face\n";
+        for (int count : {25, 100, 400}) {
+            const double us = runCrowd(count);
+            if (us < 0.0) {
+                std::cerr << "FAIL: crowd of " << count << ": a blinking face is not LIVE\n";
+                ok = false;
+                break;
+            }
+            std::cout << std::left << std::setw(10) << count << std::right << std::fixed << std::setprecision(2)
+                      << std::setw(13) << us << "\n";
+        }
+    }
+    if (ok) std::cout << "liveness_tracking_test: PASS\n";
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,153 @@
+//
+// File: NeptuneFacialSDK/core/tests/log_async_test.cpp
+//
+// Checks the asynchronous logging backend with a MemorySink: every line from
+// several threads arrives once, in order per thread, also while the writer
+// stops; a full queue drops and counts instead of blocking; RotatingFileSink
+// keeps the configured number of files. Exits non-zero on the first failure.
+//
+
+#include "neptune/Log.h"
+#include "neptune/LogSink.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace neptune;
+
+static bool fail(const std::string& what) {
+    std::cerr << "FAIL: " << what << "\n";
+    return false;
+}
+
+static bool testOrderedDelivery() {
+    auto sink = std::make_shared<MemorySink>();
+    Log::setSink(sink);
+    Log::startAsync();
+
+    const int threads = 4;
+    const int lines = 100;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([t] {
+            for (int i = 0; i < lines; ++i) NEPTUNE_LOG_INFO("Worker", t << " " << i);
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    Log::flush();
+
+    std::vector<int> next(threads, 0);
+    for (const auto& entry : sink->entries()) {
+        int t = -1, i = -1;
+        if (std::sscanf(entry.message.c_str(), "%d %d", &t, &i) != 2 || t < 0 || t >= threads) {
+            return fail("unexpected line: " + entry.message);
+        }
+        if (i != next[t]++) return fail("lines of thread " + std::to_string(t) + " out of order");
+    }
+    for (int t = 0; t < threads; ++t) {
+        if (next[t] != lines) return fail("thread " + std::to_string(t) + " lost lines");
+    }
+    Log::stopAsync();
+    return true;
+}
+
+// Lines logged while the writer stops are neither lost nor reordered.
+static bool testStopWhileLogging() {
+    auto sink = std::make_shared<MemorySink>();
+    Log::setSink(sink);
+    LogAsyncOptions options;
+    options.queueCapacity = 4096;
+    Log::startAsync(options);
+
+    const int threads = 4;
+    const int lines = 2000;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([t] {
+            for (int i = 0; i < lines; ++i) NEPTUNE_LOG_INFO("Worker", t << " " << i);
+        });
+    }
+    std::this_thread::yield();
+    Log::stopAsync();
+    for (auto& worker : workers) worker.join();
+
+    std::vector<int> next(threads, 0);
+    for (const auto& entry : sink->entries()) {
+        int t = -1, i = -1;
+        if (std::sscanf(entry.message.c_str(), "%d %d", &t, &i) != 2 || t < 0 || t >= threads) {
+            return fail("unexpected line: " + entry.message);
+        }
+        if (i != next[t]++) return fail("stop: lines of thread " + std::to_string(t) + " lost or out of order");
+    }
+    for (int t = 0; t < threads; ++t) {
+        if (next[t] != lines) return fail("stop: thread " + std::to_string(t) + " lost lines");
+    }
+    return true;
+}
+
+static bool testDropWhenFull() {
+    auto sink = std::make_shared<MemorySink>();
+    Log::setSink(sink);
+    // Writer effectively asleep: the burst has to overflow the queue.
+    LogAsyncOptions options;
+    options.queueCapacity = 16;
+    options.flushIntervalMs = 60000;
+    Log::startAsync(options);
+
+    const uint64_t droppedBefore = Log::droppedMessages();
+    std::thread burst([] {
+        for (int i = 0; i < 100; ++i) NEPTUNE_LOG_WARN("Burst", "line " << i);
+    });
+    burst.join();
+    Log::stopAsync();
+
+    const uint64_t dropped = Log::droppedMessages() - droppedBefore;
+    size_t delivered = 0;
+    bool reported = false;
+    for (const auto& entry : sink->entries()) {
+        if (entry.tag == "Burst") ++delivered;
+        if (entry.tag == "Log" && entry.message.find("dropped") != std::string::npos) reported = true;
+    }
+    if (delivered != 16 || dropped != 84) {
+        return fail("expected 16 delivered / 84 dropped, got " + std::to_string(delivered) + " / " +
+                    std::to_string(dropped));
+    }
+    if (!reported) return fail("drop count was not reported to the sink");
+    return true;
+}
+
+static bool testRotation() {
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "neptune_log_test";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    const std::string path = (dir / "sdk.log").string();
+    {
+        auto sink = std::make_shared<RotatingFileSink>(path, 1024, 2);
+        if (!sink->isOpen()) return fail("cannot open " + path);
+        Log::setSink(sink);
+        for (int i = 0; i < 200; ++i) NEPTUNE_LOG_ERROR("Rotate", "line " << i << " padding padding padding");
+        Log::setSink(nullptr);
+    }
+    int files = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+        ++files;
+        if (std::filesystem::file_size(entry.path()) > 1024) return fail(entry.path().string() + " exceeds maxBytes");
+    }
+    std::filesystem::remove_all(dir);
+    if (files != 3) return fail("expected sdk.log + 2 rotated files, found " + std::to_string(files));
+    return true;
+}
+
+int main() {
+    Log::setLevel(LogLevel::Info);
+    const bool ok = testOrderedDelivery() && testStopWhileLogging() && testDropWhenFull() && testRotation();
+    Log::setSink(nullptr);
+    if (!ok) return 1;
+    std::cout << "PASS\n";
+    return 0;
+}
@@ -0,0 +1,140 @@
+//
+// File: NeptuneFacialSDK/core/tests/model_profile_test.cpp
+//
+// Per-op profiling of the SDK models. Runs each model N times through
+// TfLiteEngine with profiling enabled, prints the most expensive ops and
+// dumps the full statistics as CSV and JSON. With --xnnpack, fails when the
+// delegate's ops are missing from the profile.
+//
+
+#include "neptune/TfLiteEngine.h"
+#include "neptune/EmbeddedModels.h"
+#include "neptune/Preprocess.h"
+#include "neptune/Types.h"
+
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+using namespace neptune;
+
+static bool writeFile(const std::filesystem::path& path, const std::string& content) {
+    std::ofstream out(path);
+    out << content;
+    return static_cast<bool>(out);
+}
+
+static bool profileModel(const std::string& modelPath, const EngineOptions& options, const cv::Mat& image,
+                         int runs, const std::filesystem::path& outDir) {
+    TfLiteEngine engine(options);
+    if (!engine.loadModel(modelPath)) {
+        std::cerr << "ERROR: " << engine.getLastError() << "\n";
+        return false;
+    }
+
+    // Enabled first: on XNNPACK this rebuilds the interpreter.
+    if (!engine.enableProfiling()) {
+        std::cerr << "ERROR: " << engine.getLastError() << "\n";
+        return false;
+    }
+
+    // Real input data keeps data-dependent kernels honest.
+    if (!img::Preprocess::resizeNormalizeInto(image, engine.inputTensorView(0), /*swapRB=*/true,
+                                              /*keepAspect=*/false)) {
+        std::cerr << "ERROR: cannot fill input tensor of " << modelPath << "\n";
+        return false;
+    }
+
+    engine.warmUp();   // keep one-time costs out of the statistics
+    engine.resetProfile();
+    for (int i = 0; i < runs; ++i) {
+        if (!engine.invoke()) {
+            std::cerr << "ERROR: " << engine.getLastError() << "\n";
+            return false;
+        }
+    }
+    const OpProfile profile = engine.opProfile();
+    if (engine.backend() == InferenceBackend::XNNPACK &&
+        std::none_of(profile.ops.begin(), profile.ops.end(), [](const OpProfileStat& op) { return op.delegated; })) {
+        std::cerr << "ERROR: " << modelPath << " runs on XNNPACK but the profile has no delegated ops\n";
+        return false;
+    }
+
+    std::cout << "\n== " << modelPath << " (" << TfLiteEngine::backendName(engine.backend()) << ", "
+              << profile.invokes << " invokes, mean " << profile.invokeMeanUs << " us, p95 "
+              << profile.invokeP95Us << " us)\n";
+    std::cout << std::left << std::setw(6) << "node" << std::setw(28) << "type" << std::setw(12) << "mean_us"
+              << std::setw(12) << "p95_us" << "name\n";
+    for (size_t i = 0; i < profile.ops.size() && i < 10; ++i) {
+        const OpProfileStat& op = profile.ops[i];
+        std::cout << std::setw(6) << op.nodeIndex << std::setw(28) << op.type << std::setw(12) << op.meanUs
+                  << std::setw(12) << op.p95Us << op.name << "\n";
+    }
+
+    const std::string stem = std::filesystem::path(modelPath.substr(modelPath.find(':') + 1)).stem().string();
+    const auto csvPath = outDir / (stem + "_ops.csv");
+    const auto jsonPath = outDir / (stem + "_ops.json");
+    if (!writeFile(csvPath, profile.toCsv()) || !writeFile(jsonPath, profile.toJson())) {
+        std::cerr << "ERROR: cannot write profile to " << outDir << "\n";
+        return false;
+    }
+    std::cout << "Wrote " << csvPath.string() << " and " << jsonPath.string() << "\n";
+    return true;
+}
+
+int main(int argc, char** argv) {
+    int runs = 100;
+    std::string imagePath;
+    std::filesystem::path outDir = ".";
+    NeptuneConfig config;
+    std::vector<std::string> models;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--runs" && i + 1 < argc) runs = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--image" && i + 1 < argc) imagePath = argv[++i];
+        else if (arg == "--out" && i + 1 < argc) outDir = argv[++i];
+        else if (arg == "--xnnpack") config.useXnnpack = true;
+        else if (arg == "--threads" && i + 1 < argc) config.numThreads = std::atoi(argv[++i]);
+        else if (arg == "--fp16") config.allowFp16Inference = true;
+        else if (arg == "--help") {
+            std::cout << "Usage: " << argv[0] << " [--runs <n>] [--image <path>] [--out <dir>]"
+                      << " [--xnnpack] [--threads <n>] [--fp16] [model ...]\n";
+            return 0;
+        } else {
+            models.push_back(arg);
+        }
+    }
+
+    if (models.empty()) {
+        models = {
+            embeddedOrPath("face_detection_short_range", "../../models/face_detection_short_range.tflite"),
+            embeddedOrPath("face_landmark", "../../models/face_landmark.tflite"),
+            embeddedOrPath("mobilenet_emotion", "../../models/mobilenet_emotion.tflite"),
+        };
+    }
+
+    cv::Mat image;
+    if (!imagePath.empty()) {
+        image = cv::imread(imagePath);
+        if (image.empty()) {
+            std::cerr << "ERROR: cannot read image " << imagePath << "\n";
+            return 1;
+        }
+    } else {
+        image = cv::Mat(480, 640, CV_8UC3);
+        cv::randu(image, cv::Scalar::all(0), cv::Scalar::all(255));
+    }
+
+    std::filesystem::create_directories(outDir);
+    const EngineOptions options = EngineOptions::fromConfig(config);
+
+    bool ok = true;
+    for (const auto& model : models) {
+        ok = profileModel(model, options, image, runs, outDir) && ok;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,209 @@
+//
+// File: NeptuneFacialSDK/core/tests/nms_benchmark.cpp
+//
+// Cost of non-max suppression on crowd-like frames, from 10 to 5000 detector
+// candidates (about ten per face, spread over a 4K frame). The baseline is
+// the previous quadratic greedy pass over FaceBox copies; the new one is
+// nonMaxSuppression() in hard and weighted mode, with every face kept.
+// Median microseconds over --runs calls. Before timing, it checks both modes
+// against straightforward reference loops, and exits non-zero if they differ.
+//
+
+#include "TestUtil.h"
+#include "neptune/NonMaxSuppression.h"
+#include "neptune/Types.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace neptune;
+
+namespace {
+
+constexpr float kIou = 0.3f;
+
+float iou(const FaceDetection& a, const FaceDetection& b) {
+    const int interW = std::max(0, std::min(a.x2, b.x2) - std::max(a.x1, b.x1));
+    const int interH = std::max(0, std::min(a.y2, b.y2) - std::max(a.y1, b.y1));
+    const float inter = static_cast<float>(interW) * interH;
+    return inter / (static_cast<float>(a.width()) * a.height() + static_cast<float>(b.width()) * b.height() - inter + 1e-6f);
+}
+
+float iouBox(const FaceBox& a, const FaceBox& b) {
+    const int interW = std::max(0, std::min(a.x + a.width, b.x + b.width) - std::max(a.x, b.x));
+    const int interH = std::max(0, std::min(a.y + a.height, b.y + b.height) - std::max(a.y, b.y));
+    const float inter = static_cast<float>(interW) * interH;
+    return inter / (static_cast<float>(a.width) * a.height + static_cast<float>(b.width) * b.height - inter + 1e-6f);
+}
+
+// The pass FaceDetector used to run, on FaceBoxes with their landmark vectors.
+std::vector<FaceBox> legacyNms(std::vector<FaceBox> boxes, float threshold, int topK) {
+    std::sort(boxes.begin(), boxes.end(), [](const FaceBox& a, const FaceBox& b) { return a.confidence > b.confidence; });
+    std::vector<FaceBox> result;
+    std::vector<bool> suppressed(boxes.size(), false);
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        if (suppressed[i]) continue;
+        result.push_back(boxes[i]);
+        if (static_cast<int>(result.size()) >= topK) break;
+        for (size_t j = i + 1; j < boxes.size(); ++j) {
+            if (!suppressed[j] && iouBox(boxes[i], boxes[j]) > threshold) suppressed[j] = true;
+        }
+    }
+    return result;
+}
+
+// MediaPipe's weighted loop: take the best remaining candidate, average it
+// with every remaining one it overlaps, remove them all, repeat.
+std::vector<FaceDetection> referenceWeighted(std::vector<FaceDetection> remaining, int maxDetections) {
+    std::sort(remaining.begin(), remaining.end(),
+              [](const FaceDetection& a, const FaceDetection& b) { return a.score > b.score; });
+    std::vector<FaceDetection> result;
+    while (!remaining.empty() && (maxDetections <= 0 || static_cast<int>(result.size()) < maxDetections)) {
+        const FaceDetection top = remaining[0];
+        double weight = 0.0, sums[4 + FaceDetection::kKeypoints * 2] = {};
+        std::vector<FaceDetection> rest;
+        for (const FaceDetection& d : remaining) {
+            if (iou(top, d) > kIou) {
+                weight += d.score;
+                sums[0] += d.score * d.x1; sums[1] += d.score * d.y1;
+                sums[2] += d.score * d.x2; sums[3] += d.score * d.y2;
+                for (int k = 0; k < FaceDetection::kKeypoints * 2; ++k) sums[4 + k] += d.score * d.keypoints[k];
+            } else {
+                rest.push_back(d);
+            }
+        }
+        FaceDetection blended = top;
+        blended.x1 = static_cast<int>(std::lround(sums[0] / weight));
+        blended.y1 = static_cast<int>(std::lround(sums[1] / weight));
+        blended.x2 = static_cast<int>(std::lround(sums[2] / weight));
+        blended.y2 = static_cast<int>(std::lround(sums[3] / weight));
+        for (int k = 0; k < FaceDetection::kKeypoints * 2; ++k) blended.keypoints[k] = static_cast<float>(sums[4 + k] / weight);
+        result.push_back(blended);
+        remaining.swap(rest);
+    }
+    return result;
+}
+
+// About ten jittered candidates per face, faces scattered over the frame.
+void synthesize(int count, std::mt19937& rng, std::vector<FaceDetection>& candidates, std::vector<FaceBox>& boxes) {
+    std::uniform_real_distribution<float> px(0.0f, 3700.0f), py(0.0f, 2000.0f), size(24.0f, 140.0f);
+    std::uniform_real_distribution<float> jitter(-0.12f, 0.12f), score(0.5f, 1.0f);
+    candidates.clear();
+    boxes.clear();
+    float cx = 0, cy = 0, s = 0;
+    for (int i = 0; i < count; ++i) {
+        if (i % 10 == 0) { cx = px(rng); cy = py(rng); s = size(rng); }
+        FaceDetection d;
+        d.score = score(rng);
+        d.x1 = static_cast<int>(cx + jitter(rng) * s);
+        d.y1 = static_cast<int>(cy + jitter(rng) * s);
+        d.x2 = d.x1 + static_cast<int>(s * (1.0f + jitter(rng)));
+        d.y2 = d.y1 + static_cast<int>(s * (1.0f + jitter(rng)));
+        for (int k = 0; k < FaceDetection::kKeypoints * 2; k += 2) {
+            d.keypoints[k] = static_cast<float>(static_cast<int>(cx + s * (0.2f + 0.1f * k / 2)));
+            d.keypoints[k + 1] = static_cast<float>(static_cast<int>(cy + s * 0.4f));
+        }
+        candidates.push_back(d);
+
+        FaceBox fb;
+        fb.x = d.x1; fb.y = d.y1; fb.width = d.width(); fb.height = d.height(); fb.confidence = d.score;
+        for (int k = 0; k < FaceDetection::kKeypoints; ++k) fb.landmarks.push_back(Point(d.keypoints[2 * k], d.keypoints[2 * k + 1]));
+        boxes.push_back(fb);
+    }
+}
+
+bool sameHard(const std::vector<FaceBox>& expected, const std::vector<FaceDetection>& actual) {
+    if (expected.size() != actual.size()) return false;
+    for (size_t i = 0; i < expected.size(); ++i) {
+        if (expected[i].x != actual[i].x1 || expected[i].y != actual[i].y1 ||
+            expected[i].width != actual[i].width() || expected[i].height != actual[i].height()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool sameWeighted(const std::vector<FaceDetection>& expected, const std::vector<FaceDetection>& actual) {
+    if (expected.size() != actual.size()) return false;
+    for (size_t i = 0; i < expected.size(); ++i) {
+        const FaceDetection& e = expected[i];
+        const FaceDetection& a = actual[i];
+        if (std::abs(e.x1 - a.x1) > 1 || std::abs(e.y1 - a.y1) > 1 || std::abs(e.x2 - a.x2) > 1 ||
+            std::abs(e.y2 - a.y2) > 1 || e.score != a.score) {
+            return false;
+        }
+        for (int k = 0; k < FaceDetection::kKeypoints * 2; ++k) {
+            if (std::abs(e.keypoints[k] - a.keypoints[k]) > 0.05f) return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int runs = 50;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--runs" && i + 1 < argc) runs = std::max(1, std::atoi(argv[++i]));
+        else {
+            std::cout << "Usage: " << argv[0] << " [--runs <n>]\n";
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    std::mt19937 rng(7);
+    std::vector<FaceDetection> candidates, kept;
+    std::vector<FaceBox> boxes;
+    const NmsOptions hard{NmsMode::HARD, kIou, 0};
+    const NmsOptions weighted{NmsMode::WEIGHTED, kIou, 0};
+
+    // Same faces as the reference loops, with and without a face limit, on both sides of the grid cut-over.
+    for (int trial = 0; trial < 60; ++trial) {
+        synthesize(trial % 2 ? 40 + trial : 300 + 20 * trial, rng, candidates, boxes);
+        for (int limit : {0, 2, 25}) {
+            const NmsOptions hardLimited{NmsMode::HARD, kIou, limit};
+            const NmsOptions weightedLimited{NmsMode::WEIGHTED, kIou, limit};
+            kept.clear();
+            nonMaxSuppression(candidates, hardLimited, kept);
+            if (!sameHard(legacyNms(boxes, kIou, limit > 0 ? limit : static_cast<int>(boxes.size())), kept)) {
+                std::cerr << "FAIL: hard NMS differs on trial " << trial << ", limit " << limit << "\n";
+                return 1;
+            }
+            kept.clear();
+            nonMaxSuppression(candidates, weightedLimited, kept);
+            if (!sameWeighted(referenceWeighted(candidates, limit), kept)) {
+                std::cerr << "FAIL: weighted NMS differs on trial " << trial << ", limit " << limit << "\n";
+                return 1;
+            }
+        }
+    }
+
+    std::cout << std::left << std::setw(12) << "candidates" << std::right << std::setw(8) << "faces"
+              << std::setw(14) << "legacy_us" << std::setw(12) << "hard_us" << std::setw(14) << "weighted_us"
+              << std::setw(10) << "speedup\n";
+    for (int count : {10, 50, 100, 250, 500, 1000, 2000, 5000}) {
+        synthesize(count, rng, candidates, boxes);
+        size_t faces = 0;
+        const double before = medianUs(runs, [&] { faces = legacyNms(boxes, kIou, count).size(); });
+        const double afterHard = medianUs(runs, [&] {
+            kept.clear();
+            nonMaxSuppression(candidates, hard, kept);
+        });
+        const double afterWeighted = medianUs(runs, [&] {
+            kept.clear();
+            nonMaxSuppression(candidates, weighted, kept);
+        });
+        std::cout << std::left << std::setw(12) << count << std::right << std::setw(8) << faces << std::fixed
+                  << std::setprecision(1) << std::setw(14) << before << std::setw(12) << afterHard
+                  << std::setw(14) << afterWeighted << std::setw(9) << before / afterWeighted << "x\n";
+    }
+    return 0;
+}
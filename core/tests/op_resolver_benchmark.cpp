@@ -0,0 +1,52 @@
+//
+// File: NeptuneFacialSDK/core/tests/op_resolver_benchmark.cpp
+//
+// Init cost of the op resolver neptune_core was built with (full builtin or
+// NEPTUNE_SELECTIVE_OPS): resolver construction plus interpreter build for
+// each SDK model. tools/op_resolver_report.sh runs it on both builds.
+//
+
+#include "neptune/TfLiteEngine.h"
+#include "neptune/OpResolver.h"
+#include "neptune/EmbeddedModels.h"
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+using namespace neptune;
+
+int main() {
+    // A fresh thread gets a cold resolver (resolvers are per thread).
+    double resolverMs = 0.0;
+    std::thread([&resolverMs] {
+        const auto start = std::chrono::steady_clock::now();
+        opResolver();
+        resolverMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }).join();
+
+    std::cout << "resolver=" << (usesSelectiveOpResolver() ? "selective" : "full")
+              << " construct_ms=" << resolverMs << "\n";
+
+    const std::string models[] = {
+        embeddedOrPath("face_detection_short_range", "../../models/face_detection_short_range.tflite"),
+        embeddedOrPath("face_landmark", "../../models/face_landmark.tflite"),
+        embeddedOrPath("mobilenet_emotion", "../../models/mobilenet_emotion.tflite"),
+    };
+    for (const auto& model : models) {
+        // Each model in its own thread so every build includes resolver setup.
+        bool ok = false;
+        ModelStartupTiming timing;
+        std::thread([&] {
+            TfLiteEngine engine;
+            ok = engine.loadModel(model);
+            timing = engine.startupTiming();
+        }).join();
+        if (!ok) {
+            std::cerr << "ERROR: failed to load " << model << "\n";
+            return 1;
+        }
+        std::cout << model << " load_ms=" << timing.loadMs << " allocate_ms=" << timing.allocateMs << "\n";
+    }
+    return 0;
+}
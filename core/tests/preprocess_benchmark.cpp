@@ -0,0 +1,109 @@
+//
+// File: NeptuneFacialSDK/core/tests/preprocess_benchmark.cpp
+//
+// Per-call cost of filling a model input from a camera frame: the two-step
+// letterbox path (resize() + normalizeInto()) against the fused
+// resizeNormalizeInto(), for the SDK's input sizes. Median microseconds
+// over --runs calls. The two-step side inlines resize() without its
+// per-call log line, so console I/O does not skew the comparison.
+//
+// A second table does the same for NV12 camera frames: full-frame
+// cvtColor followed by the fused BGR path, against sampling the YUV planes
+// directly.
+//
+
+#include "TestUtil.h"
+#include "neptune/Preprocess.h"
+#include "neptune/TensorView.h"
+#include "neptune/YuvFrame.h"
+
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using namespace neptune;
+
+// Preprocess::resize() minus the logging.
+static cv::Mat letterbox(const cv::Mat& image, int width, int height) {
+    const float scale = std::min(width / float(image.cols), height / float(image.rows));
+    const int newWidth = int(image.cols * scale);
+    const int newHeight = int(image.rows * scale);
+    cv::Mat resized;
+    cv::resize(image, resized, cv::Size(newWidth, newHeight));
+    cv::Mat output = cv::Mat::zeros(height, width, image.type());
+    resized.copyTo(output(cv::Rect((width - newWidth) / 2, (height - newHeight) / 2, newWidth, newHeight)));
+    return output;
+}
+
+static void printRow(const cv::Size& frame, const cv::Size& input, double baselineUs, double fusedUs) {
+    std::cout << std::left << std::setw(12) << (std::to_string(frame.width) + "x" + std::to_string(frame.height))
+              << std::setw(10) << (std::to_string(input.width) + "x" + std::to_string(input.height)) << std::right
+              << std::fixed << std::setprecision(1) << std::setw(14) << baselineUs << std::setw(12) << fusedUs
+              << std::setw(9) << std::setprecision(2) << baselineUs / fusedUs << "x\n";
+}
+
+int main(int argc, char** argv) {
+    int runs = 200;
+    bool quantized = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--runs" && i + 1 < argc) runs = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--uint8") quantized = true;
+        else {
+            std::cout << "Usage: " << argv[0] << " [--runs <n>] [--uint8]\n";
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    const TensorType inputType = quantized ? TensorType::UINT8 : TensorType::FLOAT32;
+    const cv::Size frames[] = {{640, 480}, {1280, 720}, {1920, 1080}};
+    const cv::Size inputs[] = {{128, 128}, {192, 192}, {224, 224}};
+
+    std::cout << std::left << std::setw(12) << "frame" << std::setw(10) << "input" << std::right
+              << std::setw(14) << "two_step_us" << std::setw(12) << "fused_us" << std::setw(10) << "speedup\n";
+
+    for (const cv::Size& frameSize : frames) {
+        cv::Mat frame(frameSize, CV_8UC3);
+        cv::randu(frame, cv::Scalar::all(0), cv::Scalar::all(256));
+
+        for (const cv::Size& inputSize : inputs) {
+            std::vector<uint8_t> storage;
+            const InputTensorView view = makeView(storage, inputType, inputSize.width, inputSize.height);
+
+            const double twoStep = medianUs(runs, [&] {
+                cv::Mat resized = letterbox(frame, inputSize.width, inputSize.height);
+                img::Preprocess::normalizeInto(resized, view);
+            });
+            const double fused = medianUs(runs, [&] { img::Preprocess::resizeNormalizeInto(frame, view); });
+            printRow(frameSize, inputSize, twoStep, fused);
+        }
+    }
+
+    std::cout << "\nNV12 input\n" << std::left << std::setw(12) << "frame" << std::setw(10) << "input" << std::right
+              << std::setw(14) << "cvt_fused_us" << std::setw(12) << "yuv_us" << std::setw(10) << "speedup\n";
+
+    for (const cv::Size& frameSize : frames) {
+        cv::Mat planes(frameSize.height * 3 / 2, frameSize.width, CV_8UC1);
+        cv::randu(planes, cv::Scalar::all(0), cv::Scalar::all(256));
+        const YuvFrame frame = YuvFrame::nv12(planes.ptr(0), frameSize.width, planes.ptr(frameSize.height),
+                                              frameSize.width, frameSize.width, frameSize.height);
+        const cv::Rect whole(cv::Point(), frameSize);
+
+        for (const cv::Size& inputSize : inputs) {
+            std::vector<uint8_t> storage;
+            const InputTensorView view = makeView(storage, inputType, inputSize.width, inputSize.height);
+
+            const double converted = medianUs(runs, [&] {
+                cv::Mat bgr;
+                cv::cvtColor(planes, bgr, cv::COLOR_YUV2BGR_NV12);
+                img::Preprocess::resizeNormalizeInto(bgr, view);
+            });
+            const double direct = medianUs(runs, [&] { img::Preprocess::resizeNormalizeInto(frame, whole, view); });
+            printRow(frameSize, inputSize, converted, direct);
+        }
+    }
+    return 0;
+}
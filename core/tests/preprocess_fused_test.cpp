@@ -0,0 +1,93 @@
+//
+// File: NeptuneFacialSDK/core/tests/preprocess_fused_test.cpp
+//
+// Checks Preprocess::resizeNormalizeInto against the two-step path it
+// replaces (resize() or cv::resize, then normalizeInto()) on random images:
+// letterbox and stretch, float/uint8/int8 tensors, with and without the
+// channel swap. cv::resize rounds its 8-bit result with fixed-point weights,
+// so the fused float output may differ by up to 1/255 and quantized output
+// by one step. Exits non-zero on the first mismatch.
+//
+
+#include "TestUtil.h"
+#include "neptune/Preprocess.h"
+#include "neptune/TensorView.h"
+
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+using namespace neptune;
+
+static float valueAt(const InputTensorView& view, size_t i) {
+    switch (view.type) {
+        case TensorType::FLOAT32: return view.as<float>()[i];
+        case TensorType::UINT8:   return view.as<uint8_t>()[i];
+        case TensorType::INT8:    return view.as<int8_t>()[i];
+        default:                  return 0.0f;
+    }
+}
+
+static bool compareCase(const cv::Mat& image, TensorType type, int width, int height, bool swapRB, bool keepAspect) {
+    std::vector<uint8_t> expectedData, actualData;
+    const InputTensorView expected = makeView(expectedData, type, width, height);
+    const InputTensorView actual = makeView(actualData, type, width, height);
+
+    cv::Mat resized;
+    if (keepAspect) resized = img::Preprocess::resize(image, width, height);
+    else cv::resize(image, resized, cv::Size(width, height));
+    if (!img::Preprocess::normalizeInto(resized, expected, swapRB) ||
+        !img::Preprocess::resizeNormalizeInto(image, actual, swapRB, keepAspect)) {
+        std::cerr << "FAIL: preprocessing returned false\n";
+        return false;
+    }
+
+    const float tolerance = type == TensorType::FLOAT32 ? 1.0f / 255.0f + 1e-6f : 1.0f;
+    const size_t count = static_cast<size_t>(expected.elementCount());
+    for (size_t i = 0; i < count; ++i) {
+        const float diff = std::abs(valueAt(expected, i) - valueAt(actual, i));
+        if (diff > tolerance) {
+            const size_t pixel = i / 3;
+            std::cerr << "FAIL: " << image.cols << "x" << image.rows << " -> " << width << "x" << height
+                      << " type=" << static_cast<int>(type) << " swapRB=" << swapRB << " keepAspect=" << keepAspect
+                      << " at (" << pixel % width << "," << pixel / width << ") channel " << i % 3
+                      << ": expected " << valueAt(expected, i) << ", got " << valueAt(actual, i) << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+int main() {
+    const cv::Size targets[] = {{128, 128}, {192, 192}, {224, 224}, {48, 48}, {256, 128}, {37, 53}};
+    const TensorType types[] = {TensorType::FLOAT32, TensorType::UINT8, TensorType::INT8};
+    cv::RNG rng(12345);
+    int cases = 0;
+
+    for (int iteration = 0; iteration < 60; ++iteration) {
+        const cv::Size target = targets[iteration % 6];
+        cv::Size source(rng.uniform(1, 700), rng.uniform(1, 700));
+        if (iteration % 5 == 0) source = target;                            // identity scale
+        if (iteration % 5 == 1) source = cv::Size(640, 480);
+        if (iteration % 5 == 2) source = cv::Size(target.width * 2, target.height * 2);
+
+        cv::Mat frame(source.height + 20, source.width + 20, CV_8UC3);
+        cv::randu(frame, cv::Scalar::all(0), cv::Scalar::all(256));
+        if (iteration % 2) cv::GaussianBlur(frame, frame, cv::Size(5, 5), 0);
+        // Non-continuous ROI view, like the landmark crop.
+        const cv::Mat image = frame(cv::Rect(10, 10, source.width, source.height));
+
+        for (TensorType type : types) {
+            for (int swapRB = 0; swapRB < 2; ++swapRB) {
+                for (int keepAspect = 0; keepAspect < 2; ++keepAspect) {
+                    if (!compareCase(image, type, target.width, target.height, swapRB, keepAspect)) return 1;
+                    ++cases;
+                }
+            }
+        }
+    }
+
+    std::cout << "PASS: " << cases << " cases\n";
+    return 0;
+}
@@ -0,0 +1,155 @@
+//
+// File: NeptuneFacialSDK/core/tests/roi_warp_test.cpp
+//
+// Checks the rotation-aware crop used for landmark and emotion inputs:
+// - faceRoi() levels the eye keypoints (detector and face mesh layouts);
+// - landmarksRoi() frames a tilted face mesh for the next tracked frame;
+// - an unrotated full-image warp matches the fused resize path;
+// - a rotated warp samples where its tensor->image transform says, so
+//   landmarks mapped back through it land on the right pixels.
+// Exits non-zero on the first failure.
+//
+
+#include "TestUtil.h"
+#include "neptune/Preprocess.h"
+#include "neptune/TensorView.h"
+#include "neptune/Types.h"
+
+#include <opencv2/opencv.hpp>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+using namespace neptune;
+
+static bool expectNear(const char* what, float actual, float expected, float tolerance) {
+    if (std::abs(actual - expected) <= tolerance) return true;
+    std::cerr << "FAIL: " << what << ": expected " << expected << ", got " << actual << "\n";
+    return false;
+}
+
+static bool testFaceRoi() {
+    const cv::Size imageSize(640, 480);
+    FaceBox face;
+    face.x = 200;
+    face.y = 100;
+    face.width = 100;
+    face.height = 120;
+
+    // Upright: no keypoints -> axis-aligned, scaled, square on the long side.
+    NormalizedRect roi = img::Preprocess::faceRoi(face, imageSize, 1.5f, /*square=*/true);
+    bool ok = expectNear("x_center", roi.x_center * imageSize.width, 250.0f, 1e-3f) &&
+              expectNear("y_center", roi.y_center * imageSize.height, 160.0f, 1e-3f) &&
+              expectNear("width", roi.width * imageSize.width, 180.0f, 1e-3f) &&
+              expectNear("height", roi.height * imageSize.height, 180.0f, 1e-3f) &&
+              expectNear("rotation", roi.rotation, 0.0f, 0.0f);
+
+    // Detector keypoints: right eye (0) then left eye (1), head tilted 30 degrees.
+    const float tilt = static_cast<float>(CV_PI / 6);
+    face.landmarks.assign(6, Point());
+    face.landmarks[0] = Point(230.0f, 140.0f);
+    face.landmarks[1] = Point(230.0f + 40.0f * std::cos(tilt), 140.0f + 40.0f * std::sin(tilt));
+    roi = img::Preprocess::faceRoi(face, imageSize);
+    ok = ok && expectNear("detector rotation", roi.rotation, tilt, 1e-4f);
+
+    // Face mesh: outer eye corners 33 and 263.
+    face.landmarks.assign(468, Point());
+    face.landmarks[33] = Point(220.0f, 150.0f);
+    face.landmarks[263] = Point(280.0f, 90.0f);
+    roi = img::Preprocess::faceRoi(face, imageSize);
+    ok = ok && expectNear("mesh rotation", roi.rotation, static_cast<float>(-CV_PI / 4), 1e-4f);
+
+    roi = img::Preprocess::faceRoi(face, imageSize, 1.0f, false, /*align=*/false);
+    return ok && expectNear("unaligned rotation", roi.rotation, 0.0f, 0.0f);
+}
+
+static bool testLandmarksRoi() {
+    // A 100x80 face mesh (in its own frame) centered on (300, 200), tilted
+    // 20 degrees; eye corners 33/263 lie on its horizontal axis.
+    const cv::Size imageSize(640, 480);
+    const float tilt = static_cast<float>(CV_PI / 9);
+    const auto place = [&](float u, float v) {
+        return Point(300.0f + u * std::cos(tilt) - v * std::sin(tilt), 200.0f + u * std::sin(tilt) + v * std::cos(tilt));
+    };
+    std::vector<Point> mesh(468, place(0.0f, 0.0f));
+    mesh[0] = place(-50.0f, -40.0f);
+    mesh[1] = place(50.0f, 40.0f);
+    mesh[33] = place(-30.0f, -10.0f);
+    mesh[263] = place(30.0f, -10.0f);
+
+    // Tracking crop: square on the mesh's longer side, 1.5x, rotated with the face.
+    NormalizedRect roi = img::Preprocess::landmarksRoi(mesh, imageSize, 1.5f);
+    bool ok = expectNear("tracked x_center", roi.x_center * imageSize.width, 300.0f, 1e-2f) &&
+              expectNear("tracked y_center", roi.y_center * imageSize.height, 200.0f, 1e-2f) &&
+              expectNear("tracked width", roi.width * imageSize.width, 150.0f, 1e-2f) &&
+              expectNear("tracked height", roi.height * imageSize.height, 150.0f, 1e-2f) &&
+              expectNear("tracked rotation", roi.rotation, tilt, 1e-4f);
+
+    roi = img::Preprocess::landmarksRoi(std::vector<Point>(6, Point(10.0f, 10.0f)), imageSize);
+    return ok && expectNear("too few landmarks", roi.width, 0.0f, 0.0f);
+}
+
+static bool testMatchesResize() {
+    cv::Mat image(300, 400, CV_8UC3);
+    cv::randu(image, cv::Scalar::all(0), cv::Scalar::all(256));
+    cv::GaussianBlur(image, image, cv::Size(7, 7), 0);
+    const NormalizedRect whole = img::Preprocess::rectRoi(cv::Rect(0, 0, image.cols, image.rows), image.size());
+
+    for (int keepAspect = 0; keepAspect < 2; ++keepAspect) {
+        std::vector<float> warpedData, resizedData;
+        const InputTensorView warped = makeView(warpedData, 192, 192);
+        const InputTensorView resized = makeView(resizedData, 192, 192);
+        if (!img::Preprocess::warpNormalizeInto(image, whole, warped, true, keepAspect) ||
+            !img::Preprocess::resizeNormalizeInto(image, resized, true, keepAspect)) {
+            std::cerr << "FAIL: preprocessing returned false\n";
+            return false;
+        }
+        for (size_t i = 0; i < warpedData.size(); ++i) {
+            if (!expectNear("warp vs resize", warpedData[i], resizedData[i], 1.0f / 255.0f)) return false;
+        }
+    }
+    return true;
+}
+
+static bool testRotatedSampling() {
+    // Dark image with a bright dot; a ROI rotated by 30 degrees around the
+    // image center must show the dot where the inverse transform puts it.
+    cv::Mat image(240, 320, CV_8UC3, cv::Scalar::all(0));
+    const cv::Point2f dot(200.0f, 90.0f);
+    cv::circle(image, dot, 4, cv::Scalar::all(255), cv::FILLED);
+
+    NormalizedRect roi;
+    roi.x_center = 0.5f;
+    roi.y_center = 0.5f;
+    roi.width = 200.0f / image.cols;
+    roi.height = 200.0f / image.rows;
+    roi.rotation = static_cast<float>(CV_PI / 6);
+
+    std::vector<float> data;
+    const InputTensorView view = makeView(data, 128, 128);
+    cv::Matx23f tensorToImage;
+    if (!img::Preprocess::warpNormalizeInto(image, roi, view, true, false, &tensorToImage)) {
+        std::cerr << "FAIL: warpNormalizeInto returned false\n";
+        return false;
+    }
+
+    // Tensor center maps to the ROI center.
+    const cv::Point2f center(tensorToImage * cv::Vec3f(64.0f, 64.0f, 1.0f));
+    if (!expectNear("center x", center.x, 160.0f, 1e-2f) || !expectNear("center y", center.y, 120.0f, 1e-2f)) {
+        return false;
+    }
+
+    // Brightest tensor pixel, mapped back, lands on the dot.
+    int best = 0;
+    for (int i = 1; i < 128 * 128; ++i) {
+        if (data[i * 3] > data[best * 3]) best = i;
+    }
+    const cv::Point2f found(tensorToImage * cv::Vec3f(best % 128 + 0.5f, best / 128 + 0.5f, 1.0f));
+    return expectNear("dot x", found.x, dot.x, 4.0f) && expectNear("dot y", found.y, dot.y, 4.0f);
+}
+
+int main() {
+    if (!testFaceRoi() || !testLandmarksRoi() || !testMatchesResize() || !testRotatedSampling()) return 1;
+    std::cout << "PASS\n";
+    return 0;
+}
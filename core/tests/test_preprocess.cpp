@@ -6,17 +6,17 @@
 int main() {
     cv::Mat img = cv::imread("../tests/assets/new_face.jpeg");  
     if (img.empty()) {
-        neptune::Log::error("Test", "Could not load test.jpg");
+        NEPTUNE_LOG_ERROR("Test", "Could not load test.jpg");
         return -1;
     }
 
     // Step 1: Resize
     cv::Mat resized = neptune::img::Preprocess::resize(img, 224, 224);
-    neptune::Log::info("Test", "Resized image to 224x224");
+    NEPTUNE_LOG_INFO("Test", "Resized image to 224x224");
 
     // Step 2: Normalize
     std::vector<float> data = neptune::img::Preprocess::normalize(resized);
-    neptune::Log::info("Test", "Normalized image. Vector size: " + std::to_string(data.size()));
+    NEPTUNE_LOG_INFO("Test", "Normalized image. Vector size: " << data.size());
 
     return 0;
 }
@@ -0,0 +1,50 @@
+//
+// File: NeptuneFacialSDK/core/tests/webrtc_manager_test.cpp
+//
+// Checks that WebRTCManager builds its members from a fully applied config:
+// the liveness slab must hold exactly NeptuneConfig::livenessMaxFaces faces,
+// for the default and for a caller-supplied limit, and the stream settings
+// must survive over the caller's config. Run under -fsanitize=address or
+// valgrind to catch reads of an unconstructed config. Exits non-zero on
+// failure.
+//
+
+#include "neptune/WebRTCManager.h"
+#include "neptune/Log.h"
+#include "neptune/Types.h"
+
+#include <iostream>
+
+using namespace neptune;
+
+static bool checkCapacity(const char* what, const WebRTCManager& manager, int expected) {
+    const size_t capacity = manager.livenessChecker().capacity();
+    if (capacity != static_cast<size_t>(expected)) {
+        std::cerr << "FAIL: " << what << ": liveness holds " << capacity << " faces, configured "
+                  << expected << "\n";
+        return false;
+    }
+    return true;
+}
+
+int main() {
+    Log::setLevel(LogLevel::Error);   // model loading is logged at info level
+
+    bool ok = true;
+    {
+        WebRTCManager manager;
+        ok = checkCapacity("default config", manager, NeptuneConfig().livenessMaxFaces) && ok;
+    }
+    {
+        NeptuneConfig config;
+        config.livenessMaxFaces = 7;
+        WebRTCManager manager(config);
+        ok = checkCapacity("livenessMaxFaces = 7", manager, 7) && ok;
+        if (!manager.configuration().trackFaces || manager.configuration().livenessWindowMs != 3000.0) {
+            std::cerr << "FAIL: stream settings were not applied over the caller's config\n";
+            ok = false;
+        }
+    }
+    if (ok) std::cout << "webrtc_manager_test: PASS\n";
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,165 @@
+//
+// File: NeptuneFacialSDK/core/tests/weights_cache_benchmark.cpp
+//
+// Cold vs warm startup of the face_detection_test models with the
+// persistent XNNPACK weights cache. "cold" starts from an empty cache
+// directory (weights are packed and written), "warm" maps the cache left by
+// the cold run, and "off" runs without a cache for reference. Times are
+// load + allocate + first invoke, median over --runs.
+//
+// Run with --phase warm in a fresh process after a --phase cold run to
+// measure the cross-process case the cache is meant for. --phase all also
+// truncates each cache and fails unless the next start rebuilds it and still
+// runs on XNNPACK.
+//
+
+#include "neptune/TfLiteEngine.h"
+#include "neptune/EmbeddedModels.h"
+#include "neptune/Types.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using namespace neptune;
+namespace fs = std::filesystem;
+
+struct Sample {
+    double totalMs = 0.0;
+    double allocateMs = 0.0;
+    double firstInvokeMs = 0.0;
+    bool cacheHit = false;
+};
+
+static bool startOnce(const std::string& model, const EngineOptions& options, Sample& sample) {
+    TfLiteEngine engine(options);
+    if (!engine.loadModel(model)) {
+        std::cerr << "ERROR: " << engine.getLastError() << "\n";
+        return false;
+    }
+    const ModelStartupTiming& t = engine.startupTiming();
+    sample.totalMs = t.loadMs + t.allocateMs + t.firstInvokeMs;
+    sample.allocateMs = t.allocateMs;
+    sample.firstInvokeMs = t.firstInvokeMs;
+    sample.cacheHit = t.weightsCacheHit;
+    return true;
+}
+
+static Sample median(std::vector<Sample> samples) {
+    std::sort(samples.begin(), samples.end(),
+              [](const Sample& a, const Sample& b) { return a.totalMs < b.totalMs; });
+    return samples[samples.size() / 2];
+}
+
+// Removes the cache files of one model (named "<stem>-<hash>-...xnncache").
+static void clearCaches(const fs::path& dir, const std::string& model) {
+    const std::string prefix = fs::path(model.substr(model.find(':') + 1)).stem().string() + "-";
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(dir, ec)) {
+        const std::string file = entry.path().filename().string();
+        if (file.compare(0, prefix.size(), prefix) == 0 && file.find(".xnncache") != std::string::npos) {
+            fs::remove(entry.path(), ec);
+        }
+    }
+}
+
+// A truncated cache must be replaced, not cost the engine its delegate.
+static bool checkCorruptCache(const std::string& model, const EngineOptions& options) {
+    std::string path;
+    {
+        TfLiteEngine engine(options);
+        if (!engine.loadModel(model)) return false;
+        path = engine.weightsCachePath();
+    }
+    std::error_code ec;
+    const auto size = fs::file_size(path, ec);
+    if (ec) {
+        std::cerr << "ERROR: no weights cache written for " << model << "\n";
+        return false;
+    }
+    fs::resize_file(path, size / 2, ec);
+
+    TfLiteEngine engine(options);
+    if (!engine.loadModel(model) || engine.backend() != InferenceBackend::XNNPACK) {
+        std::cerr << "ERROR: " << model << " lost XNNPACK after its cache was truncated\n";
+        return false;
+    }
+    Sample s;
+    if (!startOnce(model, options, s) || !s.cacheHit) {
+        std::cerr << "ERROR: truncated cache of " << model << " was not rebuilt\n";
+        return false;
+    }
+    return true;
+}
+
+static void printRow(const std::string& model, const char* phase, const Sample& s) {
+    std::cout << std::left << std::setw(30) << model << std::setw(6) << phase << std::right << std::fixed
+              << std::setprecision(2) << std::setw(10) << s.totalMs << std::setw(12) << s.allocateMs
+              << std::setw(14) << s.firstInvokeMs << "   " << (s.cacheHit ? "hit" : "-") << "\n";
+}
+
+int main(int argc, char** argv) {
+    int runs = 5;
+    std::string phase = "all";
+    fs::path cacheDir = fs::temp_directory_path() / "neptune_xnncache_bench";
+    NeptuneConfig config;
+    config.useXnnpack = true;
+    config.warmUpModels = true;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--runs" && i + 1 < argc) runs = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--phase" && i + 1 < argc) phase = argv[++i];
+        else if (arg == "--cache-dir" && i + 1 < argc) cacheDir = argv[++i];
+        else if (arg == "--threads" && i + 1 < argc) config.numThreads = std::atoi(argv[++i]);
+        else if (arg == "--fp16") config.allowFp16Inference = true;
+        else {
+            std::cout << "Usage: " << argv[0] << " [--runs <n>] [--phase all|off|cold|warm]"
+                      << " [--cache-dir <dir>] [--threads <n>] [--fp16]\n";
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    const std::vector<std::string> models = {
+        embeddedOrPath("face_detection_short_range", "../../models/face_detection_short_range.tflite"),
+        embeddedOrPath("face_landmark", "../../models/face_landmark.tflite"),
+        embeddedOrPath("mobilenet_emotion", "../../models/mobilenet_emotion.tflite"),
+    };
+
+    EngineOptions uncached = EngineOptions::fromConfig(config);
+    EngineOptions cached = uncached;
+    cached.weightsCacheDir = cacheDir.string();
+    fs::create_directories(cacheDir);
+
+    std::cout << "Cache dir: " << cacheDir.string() << "\n"
+              << std::left << std::setw(30) << "model" << std::setw(6) << "phase" << std::right
+              << std::setw(10) << "total_ms" << std::setw(12) << "alloc_ms" << std::setw(14) << "invoke_ms"
+              << "   cache\n";
+
+    for (const auto& model : models) {
+        std::vector<Sample> off, cold, warm;
+        for (int r = 0; r < runs; ++r) {
+            Sample s;
+            if (phase == "all" || phase == "off") {
+                if (!startOnce(model, uncached, s)) return 1;
+                off.push_back(s);
+            }
+            if (phase == "all" || phase == "cold") {
+                clearCaches(cacheDir, model);
+                if (!startOnce(model, cached, s)) return 1;
+                cold.push_back(s);
+            }
+            if (phase == "all" || phase == "warm") {
+                if (!startOnce(model, cached, s)) return 1;
+                warm.push_back(s);
+            }
+        }
+        if (!off.empty()) printRow(model, "off", median(off));
+        if (!cold.empty()) printRow(model, "cold", median(cold));
+        if (!warm.empty()) printRow(model, "warm", median(warm));
+        if (phase == "all" && !checkCorruptCache(model, cached)) return 1;
+    }
+    return 0;
+}
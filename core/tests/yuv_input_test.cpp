@@ -0,0 +1,115 @@
+//
+// File: NeptuneFacialSDK/core/tests/yuv_input_test.cpp
+//
+// Checks that sampling a YUV frame directly (NV12, NV21, I420, with padded
+// strides and odd ROIs) gives the same model input as converting the whole
+// frame to BGR first. The per-pixel conversion uses cv::cvtColor's fixed
+// point, so the two paths should agree to float rounding. Exits non-zero on
+// the first mismatch.
+//
+
+#include "TestUtil.h"
+#include "neptune/Preprocess.h"
+#include "neptune/TensorView.h"
+#include "neptune/YuvFrame.h"
+
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+using namespace neptune;
+
+// Planes of a random frame laid out with `padding` extra bytes per row.
+struct TestFrame {
+    std::vector<uint8_t> y, u, v;
+    YuvFrame frame;
+
+    TestFrame(YuvFormat format, int width, int height, int padding, cv::RNG& rng) {
+        const int yStride = width + padding;
+        y.resize(static_cast<size_t>(yStride) * height);
+        rng.fill(y, cv::RNG::UNIFORM, 0, 256);
+        if (format == YuvFormat::I420) {
+            const int cStride = width / 2 + padding;
+            u.resize(static_cast<size_t>(cStride) * height / 2);
+            v.resize(u.size());
+            rng.fill(u, cv::RNG::UNIFORM, 0, 256);
+            rng.fill(v, cv::RNG::UNIFORM, 0, 256);
+            frame = YuvFrame::i420(y.data(), yStride, u.data(), cStride, v.data(), cStride, width, height);
+        } else {
+            u.resize(static_cast<size_t>(yStride) * height / 2);
+            rng.fill(u, cv::RNG::UNIFORM, 0, 256);
+            frame = format == YuvFormat::NV12 ? YuvFrame::nv12(y.data(), yStride, u.data(), yStride, width, height)
+                                              : YuvFrame::nv21(y.data(), yStride, u.data(), yStride, width, height);
+        }
+    }
+};
+
+int main() {
+    const YuvFormat formats[] = {YuvFormat::NV12, YuvFormat::NV21, YuvFormat::I420};
+    const char* names[] = {"NV12", "NV21", "I420"};
+    const cv::Size targets[] = {{128, 128}, {192, 192}, {64, 48}};
+    cv::RNG rng(4242);
+    int cases = 0;
+
+    for (int iteration = 0; iteration < 30; ++iteration) {
+        const int width = 2 * rng.uniform(1, 320);
+        const int height = 2 * rng.uniform(1, 240);
+        const int padding = rng.uniform(0, 3) * 16;
+
+        for (int f = 0; f < 3; ++f) {
+            TestFrame test(formats[f], width, height, padding, rng);
+            const cv::Mat bgr = test.frame.toBgr();
+            if (bgr.empty()) {
+                std::cerr << "FAIL: toBgr() on a valid " << names[f] << " frame\n";
+                return 1;
+            }
+
+            // Whole frame (detector) and a random crop (emotion/landmarks).
+            const int x = rng.uniform(0, width);
+            const int y = rng.uniform(0, height);
+            const cv::Rect rois[] = {cv::Rect(0, 0, width, height),
+                                     cv::Rect(x, y, rng.uniform(1, width - x + 1), rng.uniform(1, height - y + 1))};
+            const cv::Size target = targets[iteration % 3];
+
+            for (const cv::Rect& roi : rois) {
+                for (int swapRB = 0; swapRB < 2; ++swapRB) {
+                    for (int keepAspect = 0; keepAspect < 2; ++keepAspect) {
+                        std::vector<float> expectedData, actualData;
+                        const InputTensorView expected = makeView(expectedData, target.width, target.height);
+                        const InputTensorView actual = makeView(actualData, target.width, target.height);
+                        if (!img::Preprocess::resizeNormalizeInto(bgr, roi, expected, swapRB, keepAspect) ||
+                            !img::Preprocess::resizeNormalizeInto(test.frame, roi, actual, swapRB, keepAspect)) {
+                            std::cerr << "FAIL: preprocessing returned false\n";
+                            return 1;
+                        }
+                        for (size_t i = 0; i < expectedData.size(); ++i) {
+                            if (std::abs(expectedData[i] - actualData[i]) > 1e-5f) {
+                                std::cerr << "FAIL: " << names[f] << " " << width << "x" << height << " roi " << roi
+                                          << " swapRB=" << swapRB << " keepAspect=" << keepAspect << " element " << i
+                                          << ": expected " << expectedData[i] << ", got " << actualData[i] << "\n";
+                                return 1;
+                            }
+                        }
+                        ++cases;
+                    }
+                }
+            }
+        }
+    }
+
+    // Malformed frames are rejected rather than read out of bounds.
+    std::vector<float> storage;
+    const InputTensorView view = makeView(storage, 16, 16);
+    std::vector<uint8_t> planes(64 * 64 * 2);
+    const YuvFrame odd = YuvFrame::nv12(planes.data(), 64, planes.data() + 64 * 64, 64, 63, 64);
+    const YuvFrame narrow = YuvFrame::nv12(planes.data(), 32, planes.data() + 64 * 64, 64, 64, 64);
+    if (img::Preprocess::resizeNormalizeInto(odd, cv::Rect(0, 0, 63, 64), view) ||
+        img::Preprocess::resizeNormalizeInto(narrow, cv::Rect(0, 0, 64, 64), view)) {
+        std::cerr << "FAIL: invalid frame accepted\n";
+        return 1;
+    }
+
+    std::cout << "PASS: " << cases << " cases\n";
+    return 0;
+}
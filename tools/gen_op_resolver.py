@@ -0,0 +1,166 @@
+#!/usr/bin/env python3
+"""Scan .tflite models and generate a MutableOpResolver with only their ops.
+
+Usage:
+  gen_op_resolver.py --schema <schema.fbs> [--output SelectedOpResolver.cpp] model.tflite ...
+  gen_op_resolver.py --schema <schema.fbs> --list model.tflite ...
+
+The generated file defines neptune::registerSelectedOps(), which
+core/src/tflite/OpResolver.cpp uses when neptune_core is configured with
+NEPTUNE_SELECTIVE_OPS=ON. Only the standard library is needed: the model
+flatbuffers are read directly, and builtin op names come from the
+BuiltinOperator enum of the vendored TFLite schema.
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+
+
+class Table:
+    """Minimal read-only view of a flatbuffer table."""
+
+    def __init__(self, buf, pos):
+        self.buf = buf
+        self.pos = pos
+        vtable = pos - struct.unpack_from("<i", buf, pos)[0]
+        self.vtable = vtable
+        self.vtable_size = struct.unpack_from("<H", buf, vtable)[0]
+
+    def _field(self, index):
+        entry = 4 + 2 * index
+        if entry >= self.vtable_size:
+            return 0
+        return struct.unpack_from("<H", self.buf, self.vtable + entry)[0]
+
+    def scalar(self, index, fmt, default):
+        off = self._field(index)
+        return struct.unpack_from(fmt, self.buf, self.pos + off)[0] if off else default
+
+    def _indirect(self, index):
+        off = self._field(index)
+        if not off:
+            return None
+        at = self.pos + off
+        return at + struct.unpack_from("<I", self.buf, at)[0]
+
+    def string(self, index):
+        at = self._indirect(index)
+        if at is None:
+            return None
+        length = struct.unpack_from("<I", self.buf, at)[0]
+        return self.buf[at + 4:at + 4 + length].decode("utf-8")
+
+    def tables(self, index):
+        at = self._indirect(index)
+        if at is None:
+            return []
+        count = struct.unpack_from("<I", self.buf, at)[0]
+        out = []
+        for i in range(count):
+            elem = at + 4 + 4 * i
+            out.append(Table(self.buf, elem + struct.unpack_from("<I", self.buf, elem)[0]))
+        return out
+
+
+def read_builtin_names(schema_path):
+    with open(schema_path, encoding="utf-8") as f:
+        text = f.read()
+    block = re.search(r"enum\s+BuiltinOperator\s*:\s*\w+\s*\{(.*?)\}", text, re.S)
+    if not block:
+        sys.exit("error: no BuiltinOperator enum in %s" % schema_path)
+    names = {}
+    for name, value in re.findall(r"^\s*([A-Z0-9_]+)\s*=\s*(-?\d+)", block.group(1), re.M):
+        names[int(value)] = name
+    return names
+
+
+def read_ops(model_path, builtin_names, builtins, customs):
+    with open(model_path, "rb") as f:
+        buf = f.read()
+    if len(buf) < 8 or buf[4:8] != b"TFL3":
+        sys.exit("error: %s is not a TFLite flatbuffer" % model_path)
+
+    model = Table(buf, struct.unpack_from("<I", buf, 0)[0])
+    # Model.operator_codes is field 1. OperatorCode fields:
+    # 0 deprecated_builtin_code (int8), 1 custom_code, 2 version, 3 builtin_code (int32).
+    for code in model.tables(1):
+        deprecated = code.scalar(0, "<b", 0)
+        builtin = code.scalar(3, "<i", 0)
+        version = code.scalar(2, "<i", 1)
+        op = max(deprecated, builtin)
+        custom = code.string(1)
+        if op == 32:  # BuiltinOperator_CUSTOM
+            target, key = customs, custom or "<unnamed>"
+        else:
+            if op not in builtin_names:
+                sys.exit("error: %s uses builtin op %d missing from the schema" % (model_path, op))
+            target, key = builtins, builtin_names[op]
+        lo, hi = target.get(key, (version, version))
+        target[key] = (min(lo, version), max(hi, version))
+
+
+def generate(models, builtins, customs):
+    lines = [
+        "// Generated by tools/gen_op_resolver.py. Do not edit.",
+        "//",
+        "// Ops used by:",
+    ]
+    lines += ["//   %s" % os.path.basename(m) for m in models]
+    lines += [
+        "",
+        '#include "tensorflow/lite/kernels/builtin_op_kernels.h"',
+        '#include "tensorflow/lite/model.h"',
+        '#include "tensorflow/lite/schema/schema_generated.h"',
+        "",
+        "namespace neptune {",
+        "",
+        "void registerSelectedOps(::tflite::MutableOpResolver& resolver) {",
+    ]
+    for name, (lo, hi) in sorted(builtins.items()):
+        lines.append("    resolver.AddBuiltin(::tflite::BuiltinOperator_%s, ::tflite::ops::builtin::Register_%s(), %d, %d);"
+                     % (name, name, lo, hi))
+    for name in sorted(customs):
+        lines.append("    // Custom op \"%s\" is not registered; provide it through the engine if needed." % name)
+    lines += ["}", "", "} // namespace neptune", ""]
+    return "\n".join(lines)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("models", nargs="+", help=".tflite files to scan")
+    parser.add_argument("--schema", required=True, help="TFLite schema.fbs with the BuiltinOperator enum")
+    parser.add_argument("--output", help="generated .cpp (default: stdout)")
+    parser.add_argument("--list", action="store_true", help="print the ops instead of generating code")
+    args = parser.parse_args()
+
+    builtin_names = read_builtin_names(args.schema)
+    builtins, customs = {}, {}
+    for model in args.models:
+        read_ops(model, builtin_names, builtins, customs)
+
+    if args.list:
+        for name, (lo, hi) in sorted(builtins.items()):
+            print("%-28s v%d-%d" % (name, lo, hi))
+        for name, (lo, hi) in sorted(customs.items()):
+            print("%-28s v%d-%d (custom)" % (name, lo, hi))
+        return
+
+    code = generate(args.models, builtins, customs)
+    if args.output:
+        os.makedirs(os.path.dirname(os.path.abspath(args.output)), exist_ok=True)
+        # Leave an unchanged file alone so the build does not recompile it.
+        if os.path.exists(args.output):
+            with open(args.output, encoding="utf-8") as f:
+                if f.read() == code:
+                    return
+        with open(args.output, "w", encoding="utf-8") as f:
+            f.write(code)
+    else:
+        sys.stdout.write(code)
+
+
+if __name__ == "__main__":
+    main()
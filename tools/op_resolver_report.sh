@@ -0,0 +1,37 @@
+#!/bin/bash
+# Builds neptune_core with the full and with the selective op resolver and
+# reports library/binary size and op-resolver init time side by side.
+#
+# Usage: tools/op_resolver_report.sh [extra cmake args...]
+# Run from the repository root. Build trees go to build-ops-full and
+# build-ops-selective.
+
+set -e
+ROOT="$(cd "$(dirname "$0")/.." && pwd)"
+JOBS="$(getconf _NPROCESSORS_ONLN 2>/dev/null || echo 4)"
+
+size_of() {
+    [ -f "$1" ] && wc -c < "$1" | tr -d ' ' || echo "n/a"
+}
+
+for variant in full selective; do
+    dir="$ROOT/build-ops-$variant"
+    selective=OFF
+    [ "$variant" = selective ] && selective=ON
+    cmake -S "$ROOT/core" -B "$dir" -DCMAKE_BUILD_TYPE=Release -DNEPTUNE_SELECTIVE_OPS=$selective "$@" > /dev/null
+    cmake --build "$dir" --target neptune_core op_resolver_benchmark -j"$JOBS" > /dev/null
+done
+
+printf "\n%-12s %16s %24s\n" "variant" "libneptune_core" "op_resolver_benchmark"
+for variant in full selective; do
+    dir="$ROOT/build-ops-$variant"
+    lib="$(ls "$dir"/libneptune_core.* 2>/dev/null | head -1)"
+    printf "%-12s %16s %24s\n" "$variant" "$(size_of "$lib")" "$(size_of "$dir/tests/op_resolver_benchmark")"
+done
+
+for variant in full selective; do
+    echo
+    echo "== $variant"
+    # Model paths are relative to core/tests/<build dir>, like the other test binaries.
+    (cd "$ROOT/build-ops-$variant/tests" && ./op_resolver_benchmark)
+done